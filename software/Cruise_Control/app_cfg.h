@@ -0,0 +1,18 @@
+/*
+ * Compile-time configuration of the Cruise Control application.
+ *
+ * The options follow the os_cfg.h convention: 1 enables a feature,
+ * 0 removes its code from the build.
+ */
+
+#ifndef APP_CFG_H_
+#define APP_CFG_H_
+
+#define BENCHMARK_EN          0    /* Run the P_COUNTER benchmarks from StartTask before the tasks start */
+#define PID_CONTROL_EN        1    /* Cruise control with the PID controller, 0 for bang-bang       */
+#define PIPELINE_EN           1    /* Phase-aligned vehicle/control pipeline, 0 for separate timers */
+#define CPU_REPORT_EN         1    /* Print the CPU time report every CPU_REPORT_PERIOD, KEY0 in any case */
+#define TRACE_DUMP_EN         1    /* Dump the kernel trace after the first deadline miss, KEY0 re-arms;
+                                      requires OS_TRACE_EN in os_cfg.h */
+
+#endif /* APP_CFG_H_ */
@@ -0,0 +1,1425 @@
+#include <stdio.h>
+#include <unistd.h>
+#include "system.h"
+#include "includes.h"
+#include "app_cfg.h"
+#include "benchmark.h"
+#include "sys/alt_alarm.h"
+#include "sys/ioctl.h"
+#include "altera_avalon_performance_counter.h"
+#include "vehicle_dynamics.h"
+#include "input_state.h"
+#include "load_gen.h"
+#include "display.h"
+#include "track.h"
+#include "controller.h"
+#include "altera_avalon_pio_regs.h"
+#include "altera_avalon_timer.h"
+#include "altera_avalon_timer_regs.h"
+#include "sys/alt_timestamp.h"
+
+#if BENCHMARK_EN > 0
+
+#define PERF_BASE ((void*) P_COUNTER_BASE)
+
+#define BENCH_ITERATIONS 1000
+
+/*
+ * Throttle profile for the vehicle benchmarks: accelerate, coast, brake
+ */
+static INT8U bench_throttle(int i, INT8U* braking)
+{
+  int phase = i % 300;
+
+  *braking = (phase >= 250);
+  if (phase < 150)
+    return 80;
+  else
+    return 0;
+}
+
+/*
+ * Reference copy of the float based model that VehicleTask used before
+ * the fixed-point engine (adjust_position, adjust_velocity and the
+ * retardation block).
+ */
+static void legacy_vehicle_step(INT16U* position, INT16S* velocity,
+                                INT8U throttle, INT8U braking)
+{
+  INT8S acceleration;
+  INT8S retardation;
+  INT16S wind_factor;
+  INT16S new_position;
+  INT16S new_velocity;
+  INT8U brake_retardation = 200;
+  INT16U time_interval = 300;
+
+  if (*velocity > 0)
+    wind_factor = *velocity * *velocity / 10000 + 1;
+  else
+    wind_factor = (-1) * *velocity * *velocity / 10000 + 1;
+
+  if (*position < 4000)
+    retardation = wind_factor;
+  else if (*position < 8000)
+    retardation = wind_factor + 15;
+  else if (*position < 12000)
+    retardation = wind_factor + 25;
+  else if (*position < 16000)
+    retardation = wind_factor;
+  else if (*position < 20000)
+    retardation = wind_factor - 10;
+  else
+    retardation = wind_factor - 5;
+
+  acceleration = throttle / 2 - retardation;
+
+  new_position = *position + *velocity * time_interval / 1000
+    + acceleration / 2  * (time_interval / 1000) * (time_interval / 1000);
+  if (new_position > 24000)
+    new_position -= 24000;
+  else if (new_position < 0)
+    new_position += 24000;
+
+  if (!braking)
+    new_velocity = *velocity  + (float) (acceleration * time_interval) / 1000.0;
+  else {
+    if (brake_retardation * time_interval / 1000 > *velocity)
+      new_velocity = 0;
+    else
+      new_velocity = *velocity - brake_retardation * time_interval / 1000;
+  }
+
+  *position = new_position;
+  *velocity = new_velocity;
+}
+
+/*
+ * Section 1: float model, section 2: fixed-point model
+ */
+static void bench_vehicle_dynamics(void)
+{
+  INT16U position = 0;
+  INT16S velocity = 0;
+  VD_STATE vehicle;
+  INT8U throttle, braking;
+  int i;
+  OS_CPU_SR cpu_sr;
+
+  vd_init(&vehicle, 300);
+
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    throttle = bench_throttle(i, &braking);
+
+    OS_ENTER_CRITICAL();
+    PERF_BEGIN(PERF_BASE, 1);
+    legacy_vehicle_step(&position, &velocity, throttle, braking);
+    PERF_END(PERF_BASE, 1);
+
+    PERF_BEGIN(PERF_BASE, 2);
+    vd_step(&vehicle, throttle, braking);
+    PERF_END(PERF_BASE, 2);
+    OS_EXIT_CRITICAL();
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+
+  printf("Vehicle dynamics, %d steps (float: %d.%dm/s, fixed: %d.%dm/s)\n",
+         BENCH_ITERATIONS, velocity / 10, velocity % 10,
+         vd_velocity(&vehicle) / 10, vd_velocity(&vehicle) % 10);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 2,
+                              "float model", "fixed model");
+}
+
+#define BENCH_INPUT_MBOXES      5
+#define BENCH_TIMEOUT_CYCLES   10  /* Each one blocks for a tick per mailbox */
+
+/*
+ * Per-cycle kernel overhead of reading the driver inputs.
+ * Section 1: five OSMboxPend(..., 1, &err) with a message present,
+ * section 2: the same with no message (producer missed a post),
+ * section 3: five OSMboxAccept, section 4: one input_state snapshot.
+ */
+static void bench_input_snapshot(void)
+{
+  OS_EVENT* mbox[BENCH_INPUT_MBOXES];
+  static INT8U msg = 1;
+  volatile INPUT_STATE inputs;
+  INT8U err;
+  int i, j;
+  OS_CPU_SR cpu_sr;
+
+  for (j = 0; j < BENCH_INPUT_MBOXES; j++)
+    mbox[j] = OSMboxCreate((void*) 0);
+  input_state_publish(INPUT_TOP_GEAR | INPUT_ENGINE);
+
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    for (j = 0; j < BENCH_INPUT_MBOXES; j++)
+      OSMboxPost(mbox[j], (void*) &msg);
+    OS_ENTER_CRITICAL();
+    PERF_BEGIN(PERF_BASE, 1);
+    for (j = 0; j < BENCH_INPUT_MBOXES; j++)
+      OSMboxPend(mbox[j], 1, &err);
+    PERF_END(PERF_BASE, 1);
+    OS_EXIT_CRITICAL();
+
+    for (j = 0; j < BENCH_INPUT_MBOXES; j++)
+      OSMboxPost(mbox[j], (void*) &msg);
+    OS_ENTER_CRITICAL();
+    PERF_BEGIN(PERF_BASE, 3);
+    for (j = 0; j < BENCH_INPUT_MBOXES; j++)
+      OSMboxAccept(mbox[j]);
+    PERF_END(PERF_BASE, 3);
+
+    PERF_BEGIN(PERF_BASE, 4);
+    inputs = input_state_snapshot();
+    PERF_END(PERF_BASE, 4);
+    OS_EXIT_CRITICAL();
+  }
+
+  /* Blocking case, interrupts must stay enabled for the timeout */
+  for (i = 0; i < BENCH_TIMEOUT_CYCLES; i++) {
+    PERF_BEGIN(PERF_BASE, 2);
+    for (j = 0; j < BENCH_INPUT_MBOXES; j++)
+      OSMboxPend(mbox[j], 1, &err);
+    PERF_END(PERF_BASE, 2);
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+
+  for (j = 0; j < BENCH_INPUT_MBOXES; j++)
+    OSMboxDel(mbox[j], OS_DEL_ALWAYS, &err);
+
+  printf("Input read per control cycle, %d cycles (%d when blocking)\n",
+         BENCH_ITERATIONS, BENCH_TIMEOUT_CYCLES);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 4,
+                              "5x pend, msg", "5x pend, none",
+                              "5x accept", "snapshot");
+  (void) inputs;
+}
+
+#define BENCH_LOAD_ITERATIONS  20
+
+/*
+ * Accuracy of the load generator. Sections 1-3 burn 50 us, 1 ms and
+ * 10 ms with interrupts disabled, section 4 is the former busy-wait on
+ * alt_nticks() for its smallest load of one tick.
+ */
+static void bench_load_generator(void)
+{
+  static const INT32U request[3] = {
+    LG_US_TO_CYCLES(50), LG_US_TO_CYCLES(1000), LG_US_TO_CYCLES(10000)
+  };
+  alt_u32 start;
+  int i, j;
+  OS_CPU_SR cpu_sr;
+
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_LOAD_ITERATIONS; i++) {
+    for (j = 0; j < 3; j++) {
+      OS_ENTER_CRITICAL();
+      PERF_BEGIN(PERF_BASE, j + 1);
+      lg_burn(request[j]);
+      PERF_END(PERF_BASE, j + 1);
+      OS_EXIT_CRITICAL();
+    }
+
+    PERF_BEGIN(PERF_BASE, 4);
+    start = alt_nticks();
+    while ((alt_nticks() - start) < 1);
+    PERF_END(PERF_BASE, 4);
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+
+  printf("Load generator, %d calls each\n", BENCH_LOAD_ITERATIONS);
+  for (j = 0; j < 3; j++)
+    printf("  requested %7lu cycles, burnt %7lu\n", request[j],
+           (INT32U) perf_get_section_time(PERF_BASE, j + 1) / BENCH_LOAD_ITERATIONS);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 4,
+                              "burn 50 us", "burn 1 ms", "burn 10 ms",
+                              "1 tick wait");
+}
+
+/*
+ * Copy of the former display code: divisions by 10 and all four PIOs
+ * written every cycle
+ */
+static const int legacy_b2s[] = {
+  0x40, 0x79, 0x24, 0x30, 0x19, 0x12, 0x02, 0x78, 0x00, 0x18, 0x3F
+};
+
+static void legacy_display(INT8S velocity, INT8U target, INT32U red, INT16U green)
+{
+  int tmp = velocity;
+  int out_sign = legacy_b2s[0];
+
+  if (velocity < 0) {
+    out_sign = legacy_b2s[10];
+    tmp *= -1;
+  }
+  IOWR_ALTERA_AVALON_PIO_DATA(DE2_PIO_HEX_LOW28_BASE,
+                              legacy_b2s[0] << 21 | out_sign << 14 |
+                              legacy_b2s[tmp / 10] << 7 |
+                              legacy_b2s[tmp - (tmp / 10) * 10]);
+  tmp = target;
+  IOWR_ALTERA_AVALON_PIO_DATA(DE2_PIO_HEX_HIGH28_BASE,
+                              legacy_b2s[0] << 21 | legacy_b2s[0] << 14 |
+                              legacy_b2s[tmp / 10] << 7 |
+                              legacy_b2s[tmp - (tmp / 10) * 10]);
+  IOWR_ALTERA_AVALON_PIO_DATA(DE2_PIO_REDLED18_BASE, red);
+  IOWR_ALTERA_AVALON_PIO_DATA(DE2_PIO_GREENLED9_BASE, green);
+}
+
+static void new_display(INT8S velocity, INT8U target, INT32U red, INT16U green)
+{
+  INT32U sign = DISP_SEG_0;
+  INT8U tmp = velocity;
+
+  if (velocity < 0) {
+    sign = DISP_SEG_MINUS;
+    tmp = -velocity;
+  }
+  disp_hex_low(DISP_SEG_0 << 21 | sign << 14 | DISP_TWO_DIGITS(tmp));
+  disp_hex_high(DISP_SEG_0 << 21 | DISP_SEG_0 << 14 | DISP_TWO_DIGITS(target));
+  disp_red(0x3FFFF, red);
+  disp_green(0x1FF, green);
+  disp_flush();
+}
+
+/*
+ * Display update per control cycle. Section 1: former code, section 2:
+ * display service with an unchanged state (the common case), section 3:
+ * display service with the velocity changing every cycle.
+ */
+static void bench_display(void)
+{
+  INT32U writes[2];
+  int i;
+  OS_CPU_SR cpu_sr;
+
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    OS_ENTER_CRITICAL();
+    PERF_BEGIN(PERF_BASE, 1);
+    legacy_display(42, 40, 0x10003, 0x41);
+    PERF_END(PERF_BASE, 1);
+    OS_EXIT_CRITICAL();
+  }
+
+  writes[0] = disp_writes();
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    OS_ENTER_CRITICAL();
+    PERF_BEGIN(PERF_BASE, 2);
+    new_display(42, 40, 0x10003, 0x41);
+    PERF_END(PERF_BASE, 2);
+    OS_EXIT_CRITICAL();
+  }
+
+  writes[1] = disp_writes();
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    OS_ENTER_CRITICAL();
+    PERF_BEGIN(PERF_BASE, 3);
+    new_display((INT8S) (i & 0x3F), 40, 0x10003, 0x41);
+    PERF_END(PERF_BASE, 3);
+    OS_EXIT_CRITICAL();
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+
+  printf("Display update per control cycle, %d cycles\n", BENCH_ITERATIONS);
+  printf("  PIO writes: former %d, unchanged %lu, velocity changing %lu\n",
+         4 * BENCH_ITERATIONS, writes[1] - writes[0], disp_writes() - writes[1]);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 3,
+                              "former", "unchanged", "changing");
+}
+
+/*
+ * Terrain lookup of a driving vehicle. Section 1: former if/else chain,
+ * section 2: track_find() from the last segment, section 3:
+ * track_search() (binary search) for every position.
+ */
+static void bench_track(void)
+{
+  INT32U position = 0;
+  INT16U segment = 0;
+  volatile INT8S grade;
+  INT32S grade_sum = 0;   /* Printed, so the lookups are not optimised away */
+  int i;
+  OS_CPU_SR cpu_sr;
+
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    position += 211; /* 70 m/s for 300 ms */
+    if (position >= track_length)
+      position -= track_length;
+
+    OS_ENTER_CRITICAL();
+    PERF_BEGIN(PERF_BASE, 1);
+    if (position < 4000)
+      grade = 0;
+    else if (position < 8000)
+      grade = 15;
+    else if (position < 12000)
+      grade = 25;
+    else if (position < 16000)
+      grade = 0;
+    else if (position < 20000)
+      grade = -10;
+    else
+      grade = -5;
+    PERF_END(PERF_BASE, 1);
+
+    PERF_BEGIN(PERF_BASE, 2);
+    segment = track_find(position, segment);
+    grade = track_segments[segment].grade;
+    PERF_END(PERF_BASE, 2);
+
+    PERF_BEGIN(PERF_BASE, 3);
+    grade = track_segments[track_search(position)].grade;
+    PERF_END(PERF_BASE, 3);
+    OS_EXIT_CRITICAL();
+    grade_sum += grade;
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+
+  printf("Track lookup, %d steps over %d segments, grade sum %ld\n", BENCH_ITERATIONS,
+         track_segment_count, grade_sum);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 3,
+                              "if/else chain", "track_find", "track_search");
+}
+
+/*
+ * Cost of OSTimeTick() against the number of tasks. The system has too
+ * few priorities for 64 tasks, so each tick runs on a synthetic TCB list
+ * swapped in for OSTCBList and OSDlyList with interrupts disabled. The
+ * tasks are delayed beyond the run, so the ticks measure the bookkeeping
+ * without expiries. Build once with OS_TICK_DELTA_EN 0 in os_cfg.h and
+ * once with 1 to compare the linear scan with the delta list.
+ */
+#define BENCH_TICK_SIZES       6
+#define BENCH_TICK_COUNT     100
+#define BENCH_TICK_MAX_TCBS   64
+
+static OS_TCB  bench_tcb[BENCH_TICK_MAX_TCBS];
+static OS_TCB* bench_dly_list;
+
+/*
+ * Exchanges OSDlyList with the synthetic delay list, interrupts disabled
+ */
+static void bench_dly_swap(void)
+{
+#if OS_TICK_DELTA_EN > 0
+  OS_TCB* list = OSDlyList;
+
+  OSDlyList = bench_dly_list;
+  bench_dly_list = list;
+#endif
+}
+
+/*
+ * Links the first 'tasks' TCBs like OS_TCBInit() does, the last one takes
+ * the place of the idle task that ends the scan. The others are delayed
+ * by different amounts through the kernel's own OS_DLY_SET().
+ */
+static void bench_tick_list(int tasks)
+{
+  int i;
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  bench_dly_list = (OS_TCB*) 0;
+  bench_dly_swap();
+  for (i = 0; i < tasks; i++) {
+    bench_tcb[i].OSTCBNext = (i + 1 < tasks) ? &bench_tcb[i + 1] : (OS_TCB*) 0;
+    bench_tcb[i].OSTCBPrio = (i + 1 < tasks) ? (INT8U) i : OS_TASK_IDLE_PRIO;
+    bench_tcb[i].OSTCBStat = OS_STAT_RDY;
+    bench_tcb[i].OSTCBDly = 0;
+#if OS_TICK_DELTA_EN > 0
+    bench_tcb[i].OSTCBDlyNext = (OS_TCB*) 0;
+    bench_tcb[i].OSTCBDlyPrev = (OS_TCB*) 0;
+#endif
+  }
+  for (i = 0; i < tasks - 1; i++)
+    OS_DLY_SET(&bench_tcb[i], (INT16U) (60000u - 7u * i));
+  bench_dly_swap();
+  OS_EXIT_CRITICAL();
+}
+
+static void bench_tick(void)
+{
+  static const int tasks[BENCH_TICK_SIZES] = { 10, 16, 24, 32, 48, 64 };
+  OS_TCB* tcb_list;
+  INT32U time;
+  int i, j;
+  OS_CPU_SR cpu_sr;
+
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_TICK_SIZES; i++) {
+    bench_tick_list(tasks[i]);
+    for (j = 0; j < BENCH_TICK_COUNT; j++) {
+      OS_ENTER_CRITICAL();
+      time = OSTime;
+      tcb_list = OSTCBList;
+      OSTCBList = bench_tcb;
+      bench_dly_swap();
+      PERF_BEGIN(PERF_BASE, i + 1);
+      OSTimeTick();
+      PERF_END(PERF_BASE, i + 1);
+      bench_dly_swap();
+      OSTCBList = tcb_list;
+      OSTime = time;
+      OS_EXIT_CRITICAL();
+    }
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+
+  printf("OSTimeTick with %s, %d ticks per task count\n",
+         OS_TICK_DELTA_EN > 0 ? "delta list" : "linear scan", BENCH_TICK_COUNT);
+  for (i = 0; i < BENCH_TICK_SIZES; i++)
+    printf("  %2d tasks: %5lu cycles per tick\n", tasks[i],
+           (INT32U) perf_get_section_time(PERF_BASE, i + 1) / BENCH_TICK_COUNT);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, BENCH_TICK_SIZES,
+                              "10 tasks", "16 tasks", "24 tasks",
+                              "32 tasks", "48 tasks", "64 tasks");
+}
+
+#define BENCH_TICKLESS_PERIOD   50   /* ticks */
+#define BENCH_TICKLESS_JOBS     40
+
+/*
+ * System clock interrupts and wake-up jitter over a fixed run of a task
+ * delayed periodically while the system is otherwise idle. The jitter is
+ * the deviation of each wake-up from t0 + k * period on the TIMER_1
+ * timestamp. Build with OS_TICKLESS_EN 0 and 1 in os_cfg.h to compare.
+ */
+static void bench_tickless(void)
+{
+  alt_u32 irqs;
+  alt_u32 start;
+  alt_u32 expected;
+  alt_u32 now;
+  alt_u32 period = alt_timestamp_freq() / OS_TICKS_PER_SEC * BENCH_TICKLESS_PERIOD;
+  INT32U ticks;
+  INT32S deviation;
+  INT32S early = 0;
+  INT32S late = 0;
+  int i;
+
+  OSTimeDly(1);                   /* Start on a tick */
+  ticks = OSTimeGet();
+  irqs = alt_avalon_timer_sc_irqs();
+  start = alt_timestamp();
+  for (i = 1; i <= BENCH_TICKLESS_JOBS; i++) {
+    OSTimeDly(BENCH_TICKLESS_PERIOD);
+    now = alt_timestamp();
+    expected = start + i * period;
+    deviation = (INT32S) (now - expected);
+    if (deviation < early)
+      early = deviation;
+    if (deviation > late)
+      late = deviation;
+  }
+  irqs = alt_avalon_timer_sc_irqs() - irqs;
+  ticks = OSTimeGet() - ticks;
+
+  printf("System clock %s, %d delays of %d ticks\n",
+         OS_TICKLESS_EN > 0 ? "tickless" : "periodic",
+         BENCH_TICKLESS_JOBS, BENCH_TICKLESS_PERIOD);
+  printf("  %lu ticks, %lu timer interrupts\n", ticks, irqs);
+  printf("  wake-up deviation %ld to %ld cycles\n", early, late);
+}
+
+#define BENCH_TMR_SIZES    5
+#define BENCH_TMR_TICKS  100
+
+/*
+ * Cost of one OSTmr_Task update against the number of running timers.
+ * Each section times OSTmrSignal(), which switches to the timer task and
+ * back, so the 0 timers section is the fixed overhead. The periods are
+ * spread over 1 to 400 timer ticks, so a few timers expire during the
+ * run. The sweep goes up to the timers left free by the application, a
+ * quarter of them more per section, so OS_TMR_CFG_MAX sets its range.
+ * Build with OS_TMR_HIER_EN 0 and 1 in os_cfg.h to compare with the
+ * OS_TMR_CFG_WHEEL_SIZE spoke wheel.
+ */
+static void bench_tmr(void)
+{
+  int timers[BENCH_TMR_SIZES];
+  OS_TMR* tmr[OS_TMR_CFG_MAX];
+  INT8U err;
+  int i, j;
+
+  for (i = 0; i < BENCH_TMR_SIZES; i++)
+    timers[i] = OSTmrFree * i / (BENCH_TMR_SIZES - 1);
+
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_TMR_SIZES; i++) {
+    for (j = 0; j < timers[i]; j++) {
+      tmr[j] = OSTmrCreate(0, 1 + (j * 97) % 400, OS_TMR_OPT_PERIODIC,
+                           (OS_TMR_CALLBACK) 0, (void*) 0, (INT8U*) "Bench", &err);
+      OSTmrStart(tmr[j], &err);
+    }
+    for (j = 0; j < BENCH_TMR_TICKS; j++) {
+      PERF_BEGIN(PERF_BASE, i + 1);
+      OSTmrSignal();
+      PERF_END(PERF_BASE, i + 1);
+    }
+    for (j = 0; j < timers[i]; j++)
+      OSTmrDel(tmr[j], &err);
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+
+  printf("OSTmr_Task update with %s, %d timer ticks per timer count\n",
+         OS_TMR_HIER_EN > 0 ? "hierarchical wheel" : "spoke wheel", BENCH_TMR_TICKS);
+  for (i = 0; i < BENCH_TMR_SIZES; i++)
+    printf("  %2d timers: %5lu cycles per timer tick\n", timers[i],
+           (INT32U) perf_get_section_time(PERF_BASE, i + 1) / BENCH_TMR_TICKS);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, BENCH_TMR_SIZES,
+                              "0 timers", "1/4 free", "1/2 free",
+                              "3/4 free", "all free");
+}
+
+#define BENCH_PERIODIC_PRIO       4    /* Free while StartTask runs the benchmarks */
+#define BENCH_PERIODIC_STACK    512
+#define BENCH_PERIODIC_JOBS      20
+#define BENCH_PERIODIC_TICKS   ((INT16U) (OS_TICKS_PER_SEC / OS_TMR_CFG_TICKS_PER_SEC))
+
+static OS_STK    bench_periodic_stack[BENCH_PERIODIC_STACK];
+static OS_EVENT* bench_release_sem;
+static OS_EVENT* bench_done_sem;
+static alt_u32   bench_latency[BENCH_PERIODIC_JOBS];
+static INT32U    bench_release[BENCH_PERIODIC_JOBS];
+
+/*
+ * Cycles since the last system clock interrupt, from a snapshot of the
+ * TIMER_0 counter. Only valid with OS_TICKLESS_EN 0.
+ */
+static alt_u32 bench_since_tick(void)
+{
+  alt_u32 remaining;
+
+  IOWR_ALTERA_AVALON_TIMER_SNAPL(TIMER_0_BASE, 0);
+  remaining = (IORD_ALTERA_AVALON_TIMER_SNAPH(TIMER_0_BASE) & ALTERA_AVALON_TIMER_SNAPH_MSK) << 16
+            | (IORD_ALTERA_AVALON_TIMER_SNAPL(TIMER_0_BASE) & ALTERA_AVALON_TIMER_SNAPL_MSK);
+  return TIMER_0_LOAD_VALUE - remaining;
+}
+
+static void bench_release_callback(void* ptmr, void* parg)
+{
+  OSSemPost(bench_release_sem);
+}
+
+/*
+ * Released by the semaphore (pdata 0) or by the kernel (pdata 1). The
+ * first instruction of each job records the cycles since the tick.
+ */
+static void bench_periodic_task(void* pdata)
+{
+  INT8U err;
+  int i;
+
+  for (i = 0; i < BENCH_PERIODIC_JOBS; i++) {
+#if OS_TASK_PERIODIC_EN > 0
+    if (pdata != (void*) 0)
+      OSTimeDlyPeriod();
+    else
+#endif
+      OSSemPend(bench_release_sem, 0, &err);
+    bench_latency[i] = bench_since_tick();
+    bench_release[i] = OSTimeGet();
+  }
+  OSSemPost(bench_done_sem);
+  OSTaskDel(OS_PRIO_SELF);
+}
+
+static void bench_periodic_print(const char* name)
+{
+  alt_u32 best = bench_latency[0], worst = 0, total = 0;
+  INT32S drift, early = 0, late = 0;
+  int i;
+
+  for (i = 0; i < BENCH_PERIODIC_JOBS; i++) {
+    if (bench_latency[i] < best)
+      best = bench_latency[i];
+    if (bench_latency[i] > worst)
+      worst = bench_latency[i];
+    total += bench_latency[i];
+    drift = (INT32S) (bench_release[i] - bench_release[0]) - i * BENCH_PERIODIC_TICKS;
+    if (drift < early)
+      early = drift;
+    if (drift > late)
+      late = drift;
+  }
+  printf("  %-12s latency %5lu min %5lu mean %5lu max cycles, jitter %5lu cycles, "
+         "drift %ld to %ld ticks\n", name, best, total / BENCH_PERIODIC_JOBS, worst,
+         worst - best, early, late);
+}
+
+/*
+ * Release latency of a periodic task: the cycles from the system clock
+ * interrupt to the first instruction of the job. The timer variant is the
+ * pattern of main.c, an OSTmr callback in OSTmr_Task posting a semaphore.
+ * The kernel variant is OSTaskCreatePeriodic(), readied by OSTimeTick()
+ * (OS_TASK_PERIODIC_EN).
+ * Its releases fall half a timer tick after those of OSTmr_Task, so they
+ * do not queue behind it. Both run with the system otherwise idle.
+ */
+static void bench_periodic(void)
+{
+  OS_TMR* tmr;
+  INT8U err;
+
+  bench_release_sem = OSSemCreate(0);
+  bench_done_sem = OSSemCreate(0);
+  printf("Periodic release, %d jobs every %d ticks\n", BENCH_PERIODIC_JOBS, BENCH_PERIODIC_TICKS);
+
+  tmr = OSTmrCreate(0, 1, OS_TMR_OPT_PERIODIC, bench_release_callback, (void*) 0,
+                    (INT8U*) "Bench", &err);
+  OSTaskCreateExt(bench_periodic_task, (void*) 0,
+                  &bench_periodic_stack[BENCH_PERIODIC_STACK - 1], BENCH_PERIODIC_PRIO,
+                  BENCH_PERIODIC_PRIO, &bench_periodic_stack[0], BENCH_PERIODIC_STACK,
+                  (void*) 0, 0);
+  OSTmrStart(tmr, &err);
+  OSSemPend(bench_done_sem, 0, &err);
+  OSTmrDel(tmr, &err);
+  bench_periodic_print("OSTmr + sem");
+
+#if OS_TASK_PERIODIC_EN > 0
+  OSTaskCreatePeriodic(bench_periodic_task, (void*) 1,
+                       &bench_periodic_stack[BENCH_PERIODIC_STACK - 1], BENCH_PERIODIC_PRIO,
+                       BENCH_PERIODIC_PRIO, &bench_periodic_stack[0], BENCH_PERIODIC_STACK,
+                       (void*) 0, 0, BENCH_PERIODIC_TICKS,
+                       BENCH_PERIODIC_TICKS / 2, 0);
+  OSSemPend(bench_done_sem, 0, &err);
+  bench_periodic_print("periodic");
+#endif
+
+  OSSemDel(bench_release_sem, OS_DEL_ALWAYS, &err);
+  OSSemDel(bench_done_sem, OS_DEL_ALWAYS, &err);
+}
+
+#if OS_TRACE_EN > 0
+#define BENCH_TRACE_COUNT  100
+
+/*
+ * Cost of the trace recorder. Section 1: OSSemPost() and OSSemAccept()
+ * with the recording stopped, section 2: the same while recording (one
+ * record), section 3: one OSTraceRecord().
+ */
+static void bench_trace(void)
+{
+  OS_EVENT* sem = OSSemCreate(0);
+  BOOLEAN on = OSTraceOn;
+  INT8U err;
+  int i;
+
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  OSTraceStop();
+  for (i = 0; i < BENCH_TRACE_COUNT; i++) {
+    PERF_BEGIN(PERF_BASE, 1);
+    OSSemPost(sem);
+    OSSemAccept(sem);
+    PERF_END(PERF_BASE, 1);
+  }
+  OSTraceStart();
+  for (i = 0; i < BENCH_TRACE_COUNT; i++) {
+    PERF_BEGIN(PERF_BASE, 2);
+    OSSemPost(sem);
+    OSSemAccept(sem);
+    PERF_END(PERF_BASE, 2);
+  }
+  for (i = 0; i < BENCH_TRACE_COUNT; i++) {
+    PERF_BEGIN(PERF_BASE, 3);
+    OSTraceRecord(OS_TRACE_TMR_EXPIRE + 1, i);
+    PERF_END(PERF_BASE, 3);
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+  if (on == OS_FALSE)
+    OSTraceStop();
+  OSSemDel(sem, OS_DEL_ALWAYS, &err);
+
+  printf("Kernel trace, %d calls\n", BENCH_TRACE_COUNT);
+  printf("  post+accept %5lu cycles stopped, %5lu recording, record %5lu cycles\n",
+         (INT32U) perf_get_section_time(PERF_BASE, 1) / BENCH_TRACE_COUNT,
+         (INT32U) perf_get_section_time(PERF_BASE, 2) / BENCH_TRACE_COUNT,
+         (INT32U) perf_get_section_time(PERF_BASE, 3) / BENCH_TRACE_COUNT);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 3,
+                              "Post stopped", "Post recording", "Record");
+}
+#endif
+
+#if OS_RING_EN > 0
+#define BENCH_RING_ITEMS   256
+#define BENCH_RING_BURST     8
+#define BENCH_RING_SIZE     32
+
+static void*     bench_q_storage[BENCH_RING_SIZE];
+static INT32U    bench_ring_storage[BENCH_RING_SIZE];
+static OS_EVENT* bench_q;
+static OS_RING   bench_rb;
+static INT32U    bench_ring_sum;
+
+/*
+ * Consumer of the handoff, above StartTask: from the queue (pdata 0) or
+ * from the ring (pdata 1) until BENCH_RING_ITEMS entries arrived.
+ */
+static void bench_ring_task(void* pdata)
+{
+  INT32U* entry;
+  INT16U n, i;
+  INT8U err;
+  int count = 0;
+
+  while (count < BENCH_RING_ITEMS) {
+    if (pdata == (void*) 0) {
+      bench_ring_sum += (INT32U) OSQPend(bench_q, 0, &err);
+      count++;
+    } else {
+      entry = OSRingPend(&bench_rb, &n, 0, &err);
+      for (i = 0; i < n; i++)
+        bench_ring_sum += entry[i];
+      OSRingGetRelease(&bench_rb, n);
+      count += n;
+    }
+  }
+  OSSemPost(bench_done_sem);
+  OSTaskDel(OS_PRIO_SELF);
+}
+
+/*
+ * Hands BENCH_RING_ITEMS values to a higher priority consumer in bursts
+ * of BENCH_RING_BURST, with the scheduler locked like an ISR producer:
+ * the queue posts each value, the ring commits each burst and posts once.
+ */
+static void bench_ring_handoff(int ring, int section)
+{
+  INT32U* slot;
+  INT16U n;
+  INT8U err;
+  int i, j;
+
+  OSTaskCreateExt(bench_ring_task, (void*) ring,
+                  &bench_periodic_stack[BENCH_PERIODIC_STACK - 1], BENCH_PERIODIC_PRIO,
+                  BENCH_PERIODIC_PRIO, &bench_periodic_stack[0], BENCH_PERIODIC_STACK,
+                  (void*) 0, 0);
+  PERF_BEGIN(PERF_BASE, section);
+  for (i = 0; i < BENCH_RING_ITEMS; i += BENCH_RING_BURST) {
+    OSSchedLock();
+    if (ring) {
+      slot = OSRingPutPtr(&bench_rb, &n);
+      for (j = 0; j < BENCH_RING_BURST && j < n; j++)
+        slot[j] = i + j;
+      OSRingPutCommit(&bench_rb, j);
+    } else {
+      for (j = 0; j < BENCH_RING_BURST; j++)
+        OSQPost(bench_q, (void*) (i + j));
+    }
+    OSSchedUnlock();
+  }
+  OSSemPend(bench_done_sem, 0, &err);
+  PERF_END(PERF_BASE, section);
+}
+
+/*
+ * Lock-free ring against the message queue, cycles per item. Sections
+ * 1-3 run in StartTask alone: OSQPost() + OSQAccept(), OSRingPutPtr() +
+ * OSRingPutCommit() + OSRingGetPtr() + OSRingGetRelease() per item, and
+ * the same per burst of BENCH_RING_BURST. Sections 4-5 hand the items to
+ * a consumer task, see bench_ring_handoff().
+ */
+static void bench_ring(void)
+{
+  INT32U* entry;
+  INT16U n;
+  INT8U err;
+  int i, j;
+
+  bench_q = OSQCreate(bench_q_storage, BENCH_RING_SIZE);
+  OSRingCreate(&bench_rb, bench_ring_storage, BENCH_RING_SIZE, sizeof(INT32U),
+               OS_RING_OPT_NOTIFY, &err);
+  bench_done_sem = OSSemCreate(0);
+
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_RING_ITEMS; i++) {
+    PERF_BEGIN(PERF_BASE, 1);
+    OSQPost(bench_q, (void*) i);
+    bench_ring_sum += (INT32U) OSQAccept(bench_q, &err);
+    PERF_END(PERF_BASE, 1);
+  }
+  for (i = 0; i < BENCH_RING_ITEMS; i++) {
+    PERF_BEGIN(PERF_BASE, 2);
+    entry = OSRingPutPtr(&bench_rb, &n);
+    *entry = i;
+    OSRingPutCommit(&bench_rb, 1);
+    entry = OSRingGetPtr(&bench_rb, &n);
+    bench_ring_sum += *entry;
+    OSRingGetRelease(&bench_rb, 1);
+    PERF_END(PERF_BASE, 2);
+  }
+  for (i = 0; i < BENCH_RING_ITEMS; i += BENCH_RING_BURST) {
+    PERF_BEGIN(PERF_BASE, 3);
+    entry = OSRingPutPtr(&bench_rb, &n);
+    for (j = 0; j < BENCH_RING_BURST && j < n; j++)
+      entry[j] = i + j;
+    OSRingPutCommit(&bench_rb, j);
+    entry = OSRingGetPtr(&bench_rb, &n);
+    for (j = 0; j < n; j++)
+      bench_ring_sum += entry[j];
+    OSRingGetRelease(&bench_rb, n);
+    PERF_END(PERF_BASE, 3);
+  }
+  bench_ring_handoff(0, 4);
+  bench_ring_handoff(1, 5);
+  PERF_STOP_MEASURING(PERF_BASE);
+
+  OSQDel(bench_q, OS_DEL_ALWAYS, &err);
+  OSRingDel(&bench_rb, &err);
+  OSSemDel(bench_done_sem, OS_DEL_ALWAYS, &err);
+
+  printf("Ring against queue, %d items, cycles per item\n", BENCH_RING_ITEMS);
+  printf("  same task: queue %5lu, ring %5lu, ring in bursts of %d %5lu\n",
+         (INT32U) perf_get_section_time(PERF_BASE, 1) / BENCH_RING_ITEMS,
+         (INT32U) perf_get_section_time(PERF_BASE, 2) / BENCH_RING_ITEMS, BENCH_RING_BURST,
+         (INT32U) perf_get_section_time(PERF_BASE, 3) / BENCH_RING_ITEMS);
+  printf("  handoff to a waiting task: queue %5lu, ring %5lu\n",
+         (INT32U) perf_get_section_time(PERF_BASE, 4) / BENCH_RING_ITEMS,
+         (INT32U) perf_get_section_time(PERF_BASE, 5) / BENCH_RING_ITEMS);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 5, "Queue", "Ring",
+                              "Ring burst", "Queue handoff", "Ring handoff");
+}
+#endif
+
+#if OS_MUTEX_CEIL_EN > 0
+#define BENCH_MUTEX_COUNT     100
+#define BENCH_MUTEX_CS        200   /* Loop iterations of the contended critical section */
+#define BENCH_MUTEX_PIP_PRIO    3
+#define BENCH_MUTEX_CEIL_PRIO   2
+
+static volatile INT32U bench_mutex_spin;
+static alt_u32         bench_mutex_release;
+static alt_u32         bench_blocked[BENCH_MUTEX_COUNT];
+
+static void bench_mutex_section(void)
+{
+  int i;
+
+  for (i = 0; i < BENCH_MUTEX_CS; i++)
+    bench_mutex_spin++;
+}
+
+/*
+ * Contender above StartTask: released while StartTask owns the mutex,
+ * records the cycles from its release to owning the mutex
+ */
+static void bench_mutex_task(void* pdata)
+{
+  OS_EVENT* mutex = pdata;
+  INT8U err;
+  int i;
+
+  for (i = 0; i < BENCH_MUTEX_COUNT; i++) {
+    OSSemPend(bench_release_sem, 0, &err);
+    OSMutexPend(mutex, 0, &err);
+    bench_blocked[i] = alt_timestamp() - bench_mutex_release;
+    OSMutexPost(mutex);
+  }
+  OSSemPost(bench_done_sem);
+  OSTaskDel(OS_PRIO_SELF);
+}
+
+/*
+ * StartTask releases the contender in the middle of its critical section.
+ * With inheritance the contender preempts, waits and raises StartTask,
+ * with the ceiling it is ready but stays behind StartTask until the unlock.
+ */
+static void bench_mutex_contended(OS_EVENT* mutex, const char* name, alt_u32 section)
+{
+  alt_u32 best = ~0ul, worst = 0;
+  INT32U switches;
+  INT8U err;
+  int i;
+
+  OSTaskCreateExt(bench_mutex_task, mutex,
+                  &bench_periodic_stack[BENCH_PERIODIC_STACK - 1], BENCH_PERIODIC_PRIO,
+                  BENCH_PERIODIC_PRIO, &bench_periodic_stack[0], BENCH_PERIODIC_STACK,
+                  (void*) 0, 0);
+  switches = OSCtxSwCtr;
+  for (i = 0; i < BENCH_MUTEX_COUNT; i++) {
+    OSMutexPend(mutex, 0, &err);
+    bench_mutex_release = alt_timestamp();
+    OSSemPost(bench_release_sem);
+    bench_mutex_section();
+    OSMutexPost(mutex);
+  }
+  OSSemPend(bench_done_sem, 0, &err);
+  switches = OSCtxSwCtr - switches;
+
+  for (i = 0; i < BENCH_MUTEX_COUNT; i++) {
+    if (bench_blocked[i] < best)
+      best = bench_blocked[i];
+    if (bench_blocked[i] > worst)
+      worst = bench_blocked[i];
+  }
+  printf("  %-9s blocked %6lu min %6lu max cycles, %5lu over the critical section, "
+         "%lu.%02lu context switches per lock\n", name, best, worst, worst - section,
+         switches / BENCH_MUTEX_COUNT, switches % BENCH_MUTEX_COUNT * 100 / BENCH_MUTEX_COUNT);
+}
+
+/*
+ * Priority inheritance (OSMutexCreate()) against the immediate priority
+ * ceiling (OSMutexCreateExt() with OS_MUTEX_OPT_CEILING). Sections 1-2:
+ * uncontended OSMutexPend() + OSMutexPost(). Then the blocking of a higher
+ * priority contender by one critical section of StartTask, which bounds
+ * the blocking of either protocol.
+ */
+static void bench_mutex(void)
+{
+  OS_EVENT* pip;
+  OS_EVENT* ceil;
+  alt_u32 section;
+  INT8U err;
+  int i;
+
+  pip = OSMutexCreate(BENCH_MUTEX_PIP_PRIO, &err);
+  ceil = OSMutexCreateExt(BENCH_MUTEX_CEIL_PRIO, OS_MUTEX_OPT_CEILING, &err);
+  bench_release_sem = OSSemCreate(0);
+  bench_done_sem = OSSemCreate(0);
+
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_MUTEX_COUNT; i++) {
+    PERF_BEGIN(PERF_BASE, 1);
+    OSMutexPend(pip, 0, &err);
+    OSMutexPost(pip);
+    PERF_END(PERF_BASE, 1);
+  }
+  for (i = 0; i < BENCH_MUTEX_COUNT; i++) {
+    PERF_BEGIN(PERF_BASE, 2);
+    OSMutexPend(ceil, 0, &err);
+    OSMutexPost(ceil);
+    PERF_END(PERF_BASE, 2);
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+
+  section = alt_timestamp();
+  bench_mutex_section();
+  section = alt_timestamp() - section;
+
+  printf("Mutex protocols, %d locks\n", BENCH_MUTEX_COUNT);
+  printf("  lock + unlock: inherit %5lu, ceiling %5lu cycles\n",
+         (INT32U) perf_get_section_time(PERF_BASE, 1) / BENCH_MUTEX_COUNT,
+         (INT32U) perf_get_section_time(PERF_BASE, 2) / BENCH_MUTEX_COUNT);
+  printf("  critical section %lu cycles\n", section);
+  bench_mutex_contended(pip, "inherit", section);
+  bench_mutex_contended(ceil, "ceiling", section);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 2, "Inherit", "Ceiling");
+
+  OSMutexDel(pip, OS_DEL_ALWAYS, &err);
+  OSMutexDel(ceil, OS_DEL_ALWAYS, &err);
+  OSSemDel(bench_release_sem, OS_DEL_ALWAYS, &err);
+  OSSemDel(bench_done_sem, OS_DEL_ALWAYS, &err);
+}
+#endif
+
+#if (OS_EVSET_EN > 0) && (OS_EVENT_MULTI_EN > 0)
+#define BENCH_EVSET_SIZES    4
+#define BENCH_EVSET_MAX     16
+#define BENCH_EVSET_COUNT  100
+
+static const int       bench_evset_sizes[BENCH_EVSET_SIZES] = { 2, 4, 8, 16 };
+static OS_EVENT*       bench_evset_src[BENCH_EVSET_MAX + 1];  /* NULL terminated for OSEventPendMulti() */
+static OS_EVSET        bench_set;
+static OS_EVSET_MEMBER bench_evset_member[BENCH_EVSET_MAX];
+static alt_u32         bench_evset_post;
+static alt_u32         bench_evset_wake;
+
+/*
+ * Waiter above StartTask, on all the sources with OSEventPendMulti()
+ * (pdata 0) or on the event set (pdata 1). Adds up the cycles from the
+ * post to its return from the wait.
+ */
+static void bench_evset_task(void* pdata)
+{
+  OS_EVENT* rdy[BENCH_EVSET_MAX + 1];
+  void* msgs[BENCH_EVSET_MAX + 1];
+  void* msg;
+  INT8U err;
+  int i;
+
+  bench_evset_wake = 0;
+  for (i = 0; i < BENCH_EVSET_COUNT; i++) {
+    if (pdata == (void*) 0)
+      OSEventPendMulti(bench_evset_src, rdy, msgs, 0, &err);
+    else
+      OSEvSetPend(&bench_set, 0, &msg, &err);
+    bench_evset_wake += alt_timestamp() - bench_evset_post;
+  }
+  OSSemPost(bench_done_sem);
+  OSTaskDel(OS_PRIO_SELF);
+}
+
+/*
+ * StartTask posts the last source BENCH_EVSET_COUNT times to the waiter,
+ * returns the mean cycles from the post to the waiter running
+ */
+static INT32U bench_evset_wakeup(int set, int n)
+{
+  INT8U err;
+  int i;
+
+  OSTaskCreateExt(bench_evset_task, (void*) set,
+                  &bench_periodic_stack[BENCH_PERIODIC_STACK - 1], BENCH_PERIODIC_PRIO,
+                  BENCH_PERIODIC_PRIO, &bench_periodic_stack[0], BENCH_PERIODIC_STACK,
+                  (void*) 0, 0);
+  for (i = 0; i < BENCH_EVSET_COUNT; i++) {
+    bench_evset_post = alt_timestamp();
+    OSSemPost(bench_evset_src[n - 1]);
+  }
+  OSSemPend(bench_done_sem, 0, &err);
+  return bench_evset_wake / BENCH_EVSET_COUNT;
+}
+
+/*
+ * OSEventPendMulti() against the event set on 2 to 16 semaphores, the last
+ * one posted. Sections 1-2: post + wait in StartTask alone, the wait
+ * returns at once. Then the wake-up of a higher priority waiter, see
+ * bench_evset_wakeup(). PendMulti scans all the sources on each call and
+ * links the waiter into each of them, the set takes the head of its
+ * ready list.
+ */
+static void bench_evset(void)
+{
+  OS_EVENT* rdy[BENCH_EVSET_MAX + 1];
+  void* msgs[BENCH_EVSET_MAX + 1];
+  void* msg;
+  INT32U multi_wake, set_wake;
+  INT8U err;
+  int s, n, i;
+
+  bench_done_sem = OSSemCreate(0);
+  printf("Event set against OSEventPendMulti(), cycles per wait\n");
+  for (s = 0; s < BENCH_EVSET_SIZES; s++) {
+    n = bench_evset_sizes[s];
+    for (i = 0; i < n; i++)
+      bench_evset_src[i] = OSSemCreate(0);
+    bench_evset_src[n] = NULL;
+
+    PERF_RESET(PERF_BASE);
+    PERF_START_MEASURING(PERF_BASE);
+    for (i = 0; i < BENCH_EVSET_COUNT; i++) {
+      PERF_BEGIN(PERF_BASE, 1);
+      OSSemPost(bench_evset_src[n - 1]);
+      OSEventPendMulti(bench_evset_src, rdy, msgs, 0, &err);
+      PERF_END(PERF_BASE, 1);
+    }
+    multi_wake = bench_evset_wakeup(0, n);
+
+    OSEvSetCreate(&bench_set, &err);
+    for (i = 0; i < n; i++)
+      OSEvSetAdd(&bench_set, &bench_evset_member[i], bench_evset_src[i], NULL, &err);
+    for (i = 0; i < BENCH_EVSET_COUNT; i++) {
+      PERF_BEGIN(PERF_BASE, 2);
+      OSSemPost(bench_evset_src[n - 1]);
+      OSEvSetPend(&bench_set, 0, &msg, &err);
+      PERF_END(PERF_BASE, 2);
+    }
+    set_wake = bench_evset_wakeup(1, n);
+    PERF_STOP_MEASURING(PERF_BASE);
+
+    OSEvSetDel(&bench_set, &err);
+    for (i = 0; i < n; i++)
+      OSSemDel(bench_evset_src[i], OS_DEL_ALWAYS, &err);
+
+    printf("  %2d sources: ready PendMulti %5lu, set %5lu; wake-up PendMulti %5lu, set %5lu\n",
+           n, (INT32U) perf_get_section_time(PERF_BASE, 1) / BENCH_EVSET_COUNT,
+           (INT32U) perf_get_section_time(PERF_BASE, 2) / BENCH_EVSET_COUNT,
+           multi_wake, set_wake);
+  }
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 2, "PendMulti", "Event set");
+  OSSemDel(bench_done_sem, OS_DEL_ALWAYS, &err);
+}
+#endif
+
+#if (OS_DEFER_EN > 0) && (OS_TASK_PROFILE_EN > 0)
+#define BENCH_DEFER_COUNT  100
+#define BENCH_DEFER_LINES   32   /* 2 KB of console output, the transmit buffer */
+
+static OS_DEFER bench_defer_work;
+static INT16U   bench_defer_cnt;
+
+static void bench_defer_fnct(void* parg, INT16U cnt)
+{
+  bench_defer_cnt = cnt;
+}
+
+/*
+ * Prints a burst of console output and returns the longest JTAG UART and
+ * system clock handlers and the longest tick latency while it drains, with
+ * the copy of the JTAG UART buffers in the handler (defer 0) or in the
+ * deferred work task (defer 1). -1 if the driver cannot defer it.
+ */
+static int bench_defer_console(int defer, INT32U* uart, INT32U* tick, INT32U* latency)
+{
+  OS_CPU_SR cpu_sr;
+  int i;
+
+  fflush(stdout);
+  OSTimeDly(OS_TICKS_PER_SEC);          /* Let the earlier output drain */
+  if (ioctl(STDOUT_FILENO, TIOCSDEFER, &defer) < 0)
+    return -1;
+  OS_ENTER_CRITICAL();
+  OSIntCyclesMax[JTAG_UART_0_IRQ] = 0;
+  OSIntCyclesMax[TIMER_0_IRQ] = 0;
+  OS_EXIT_CRITICAL();
+  alt_avalon_timer_sc_latency(1);
+  for (i = 0; i < BENCH_DEFER_LINES; i++)
+    printf("  console burst %d, line %2d %-36s\n", defer, i, "....................................");
+  fflush(stdout);
+  OSTimeDly(OS_TICKS_PER_SEC);
+  *uart = OSIntCyclesMax[JTAG_UART_0_IRQ];
+  *tick = OSIntCyclesMax[TIMER_0_IRQ];
+  *latency = alt_avalon_timer_sc_latency(0);
+  return 0;
+}
+
+/*
+ * Deferred work. Sections 1-2: OSDeferPost() of an idle item, which queues
+ * it and signals the task, and of the queued item, which only counts the
+ * post, with the scheduler locked; the task runs the item once at the
+ * unlock. Then the console before and after: the JTAG UART handler copies
+ * up to a FIFO of characters and posts an event flag per character, the
+ * deferred handler only masks the interrupt and posts the work item. The
+ * tick latency is the time from the timeout of the system clock to its
+ * handler, the interrupts disabled or another handler running.
+ */
+static void bench_defer(void)
+{
+  INT32U uart[2], tick[2], latency[2];
+  INT8U err;
+  int defer;
+  int i;
+
+  OSDeferInit(&bench_defer_work, bench_defer_fnct, NULL, 0, &err);
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_DEFER_COUNT; i++) {
+    OSSchedLock();
+    PERF_BEGIN(PERF_BASE, 1);
+    OSDeferPost(&bench_defer_work);
+    PERF_END(PERF_BASE, 1);
+    PERF_BEGIN(PERF_BASE, 2);
+    OSDeferPost(&bench_defer_work);
+    PERF_END(PERF_BASE, 2);
+    OSSchedUnlock();
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+
+  printf("Deferred work, cycles\n");
+  printf("  OSDeferPost %4lu, coalesced %4lu; %lu posts in %lu runs of %u, post to run max %lu\n",
+         (INT32U) perf_get_section_time(PERF_BASE, 1) / BENCH_DEFER_COUNT,
+         (INT32U) perf_get_section_time(PERF_BASE, 2) / BENCH_DEFER_COUNT,
+         bench_defer_work.OSDeferPosts, bench_defer_work.OSDeferRuns, bench_defer_cnt,
+         bench_defer_work.OSDeferLatMax);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 2, "Post", "Coalesce");
+
+  for (defer = 0; defer < 2; defer++)
+    if (bench_defer_console(defer, &uart[defer], &tick[defer], &latency[defer]) < 0) {
+      printf("  The JTAG UART driver does not defer its copy\n");
+      return;
+    }
+  printf("Console burst, longest JTAG UART handler, system clock handler and tick latency, cycles\n");
+  printf("  copy in the handler %6lu %6lu %6lu\n", uart[0], tick[0], latency[0]);
+  printf("  copy deferred       %6lu %6lu %6lu\n", uart[1], tick[1], latency[1]);
+}
+#endif
+
+#define BENCH_SCHED_COUNT  100
+
+/*
+ * Cost of the ready list, with StartTask the highest priority ready task
+ * so that nothing switches. Section 1: OS_Sched(), section 2: an empty
+ * interrupt, OSIntEnter() + OSIntExit(), section 3: making StartTask not
+ * ready and ready again. OS_RDY_MASK_EN selects the ready list, build with
+ * either value to compare.
+ */
+static void bench_sched(void)
+{
+  int i;
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();                  /* No tick may ready OSTmr_Task in between */
+  PERF_RESET(PERF_BASE);
+  PERF_START_MEASURING(PERF_BASE);
+  for (i = 0; i < BENCH_SCHED_COUNT; i++) {
+    PERF_BEGIN(PERF_BASE, 1);
+    OS_Sched();
+    PERF_END(PERF_BASE, 1);
+  }
+  for (i = 0; i < BENCH_SCHED_COUNT; i++) {
+    PERF_BEGIN(PERF_BASE, 2);
+    OSIntEnter();
+    OSIntExit();
+    PERF_END(PERF_BASE, 2);
+  }
+  for (i = 0; i < BENCH_SCHED_COUNT; i++) {
+    PERF_BEGIN(PERF_BASE, 3);
+    OS_RDY_CLR(OSTCBCur);
+    OS_RDY_SET(OSTCBCur);
+    PERF_END(PERF_BASE, 3);
+  }
+  PERF_STOP_MEASURING(PERF_BASE);
+  OS_EXIT_CRITICAL();
+
+  printf("Scheduler, %s ready list, cycles\n",
+         OS_RDY_MASK_EN ? "32-bit mask" : "OSRdyGrp/OSRdyTbl");
+  printf("  OS_Sched %4lu, OSIntEnter + OSIntExit %4lu, not ready + ready %4lu\n",
+         (INT32U) perf_get_section_time(PERF_BASE, 1) / BENCH_SCHED_COUNT,
+         (INT32U) perf_get_section_time(PERF_BASE, 2) / BENCH_SCHED_COUNT,
+         (INT32U) perf_get_section_time(PERF_BASE, 3) / BENCH_SCHED_COUNT);
+  perf_print_formatted_report(PERF_BASE, ALT_CPU_FREQ, 3, "OS_Sched", "OSIntExit",
+                              "Ready list");
+}
+
+#define BENCH_CTRL_STEPS     400   /* 2 min of driving over the lab track */
+#define BENCH_CTRL_START     200   /* Velocity when the cruise control engages */
+#define BENCH_CTRL_TARGET    300
+#define BENCH_CTRL_BAND       10   /* Settled within +-1.0 m/s */
+
+/*
+ * Closed loop run of a controller with the vehicle model. Prints the
+ * settling time, the overshoot and the mean absolute error, and the
+ * average and worst cycles of one controller update.
+ */
+static void bench_controller_run(const CONTROLLER* ctrl)
+{
+  VD_STATE vehicle;
+  INT16S velocity, error;
+  INT8U throttle = 0, last = 0;
+  INT32U cycles, worst = 0, total = 0, swing = 0, abs_error = 0;
+  INT16S overshoot = 0;
+  int settled = -1;
+  int i;
+  OS_CPU_SR cpu_sr;
+
+  vd_init(&vehicle, 300);
+  vehicle.velocity = INT_TO_FIX16(BENCH_CTRL_START);
+  ctrl->start(BENCH_CTRL_START, throttle);
+
+  for (i = 0; i < BENCH_CTRL_STEPS; i++) {
+    velocity = vd_velocity(&vehicle);
+
+    OS_ENTER_CRITICAL();
+    PERF_RESET(PERF_BASE);
+    PERF_START_MEASURING(PERF_BASE);
+    PERF_BEGIN(PERF_BASE, 1);
+    throttle = ctrl->update(velocity, BENCH_CTRL_TARGET);
+    PERF_END(PERF_BASE, 1);
+    PERF_STOP_MEASURING(PERF_BASE);
+    OS_EXIT_CRITICAL();
+
+    cycles = (INT32U) perf_get_section_time(PERF_BASE, 1);
+    total += cycles;
+    if (cycles > worst)
+      worst = cycles;
+    swing += (throttle > last) ? throttle - last : last - throttle;
+    last = throttle;
+
+    vd_step(&vehicle, throttle, 0);
+    error = vd_velocity(&vehicle) - BENCH_CTRL_TARGET;
+    if (error > overshoot)
+      overshoot = error;
+    if (error > BENCH_CTRL_BAND || error < -BENCH_CTRL_BAND)
+      settled = -1;
+    else if (settled < 0)
+      settled = i + 1;
+    abs_error += (error < 0) ? -error : error;
+  }
+
+  printf("  %-9s settled %4d periods, overshoot %3d, mean |error| %2lu.%02lu, "
+         "throttle swing %5lu, update %4lu avg %4lu worst cycles\n",
+         ctrl->name, settled, overshoot,
+         abs_error / BENCH_CTRL_STEPS, (abs_error % BENCH_CTRL_STEPS) * 100 / BENCH_CTRL_STEPS,
+         swing, total / BENCH_CTRL_STEPS, worst);
+}
+
+/*
+ * Bound of the PID update: saturated errors and velocity steps in both
+ * directions take the longest paths through the clamps and the software
+ * multiply
+ */
+static void bench_controller_bound(void)
+{
+  static const INT16S velocity[] = { 0, 1000, -200, 300, 32767, -32768 };
+  INT32U cycles, worst = 0;
+  int i, j;
+  OS_CPU_SR cpu_sr;
+
+  for (i = 0; i < 6; i++) {
+    for (j = 0; j < 6; j++) {
+      ctrl_pid.start(velocity[i], (INT8U) (j * 16));
+      OS_ENTER_CRITICAL();
+      PERF_RESET(PERF_BASE);
+      PERF_START_MEASURING(PERF_BASE);
+      PERF_BEGIN(PERF_BASE, 1);
+      ctrl_pid.update(velocity[j], velocity[i]);
+      PERF_END(PERF_BASE, 1);
+      PERF_STOP_MEASURING(PERF_BASE);
+      OS_EXIT_CRITICAL();
+      cycles = (INT32U) perf_get_section_time(PERF_BASE, 1);
+      if (cycles > worst)
+        worst = cycles;
+    }
+  }
+  printf("  PID update on saturated inputs: %lu cycles worst\n", worst);
+}
+
+static void bench_controller(void)
+{
+  printf("Cruise controller, %d.%d m/s to %d.%d m/s over the lab track\n",
+         BENCH_CTRL_START / 10, BENCH_CTRL_START % 10,
+         BENCH_CTRL_TARGET / 10, BENCH_CTRL_TARGET % 10);
+  bench_controller_run(&ctrl_bang_bang);
+  bench_controller_run(&ctrl_pid);
+  bench_controller_bound();
+}
+
+void benchmark_run(void)
+{
+  printf("Running benchmarks...\n");
+  bench_vehicle_dynamics();
+  bench_input_snapshot();
+  bench_load_generator();
+  bench_display();
+  bench_track();
+  bench_controller();
+  bench_tick();
+  bench_tickless();
+  bench_tmr();
+  bench_periodic();
+#if OS_TRACE_EN > 0
+  bench_trace();
+#endif
+#if OS_RING_EN > 0
+  bench_ring();
+#endif
+#if OS_MUTEX_CEIL_EN > 0
+  bench_mutex();
+#endif
+#if (OS_EVSET_EN > 0) && (OS_EVENT_MULTI_EN > 0)
+  bench_evset();
+#endif
+#if (OS_DEFER_EN > 0) && (OS_TASK_PROFILE_EN > 0)
+  bench_defer();
+#endif
+  bench_sched();
+}
+
+#endif /* BENCHMARK_EN */
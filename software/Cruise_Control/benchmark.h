@@ -0,0 +1,18 @@
+/*
+ * Cycle-count benchmarks measured with the P_COUNTER performance counter.
+ *
+ * Each benchmark compares a new service against the code it replaced and
+ * prints a perf_print_formatted_report() table. The benchmarks run from
+ * StartTask when BENCHMARK_EN is set in app_cfg.h.
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include "app_cfg.h"
+
+#if BENCHMARK_EN > 0
+void benchmark_run(void);
+#endif
+
+#endif /* BENCHMARK_H_ */
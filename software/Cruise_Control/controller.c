@@ -0,0 +1,83 @@
+#include "controller.h"
+
+#define Q8_SHIFT        8
+#define PID_OUT_MAX     ((INT32S) CTRL_THROTTLE_MAX << Q8_SHIFT)
+#define PID_RATE_MAX    ((INT32S) PID_RATE_LIMIT << Q8_SHIFT)
+
+/*
+ * Bang-bang controller: full throttle below the target, none above it
+ */
+static INT8U bang_throttle;
+
+static void bang_start(INT16S velocity, INT8U throttle)
+{
+  bang_throttle = throttle;
+}
+
+static INT8U bang_update(INT16S velocity, INT16S target)
+{
+  if (velocity < target)
+    bang_throttle = CTRL_THROTTLE_MAX;
+  else if (velocity > target)
+    bang_throttle = 0;
+
+  return bang_throttle;
+}
+
+const CONTROLLER ctrl_bang_bang = { "bang-bang", bang_start, bang_update };
+
+/*
+ * PID controller in Q8 with
+ * - the derivative on the measured velocity, so a new target causes no kick,
+ * - anti-windup: the integral is clamped to the throttle range and frozen
+ *   while the output saturates in the direction of the error,
+ * - a rate limit of PID_RATE_LIMIT per period on the output.
+ *
+ * The update has no loop and no division. The operands of the three
+ * multiplications are clamped to 16 bits, so the software multiply of
+ * the Nios II/e and the whole update have a fixed upper bound of cycles.
+ */
+static INT32S pid_integral;     /* Q8 throttle */
+static INT32S pid_output;       /* Q8 throttle, last output */
+static INT16S pid_last_velocity;
+
+static INT32S pid_clamp(INT32S value, INT32S low, INT32S high)
+{
+  if (value < low)
+    return low;
+  if (value > high)
+    return high;
+  return value;
+}
+
+static void pid_start(INT16S velocity, INT8U throttle)
+{
+  pid_integral = (INT32S) throttle << Q8_SHIFT;
+  pid_output = pid_integral;
+  pid_last_velocity = velocity;
+}
+
+static INT8U pid_update(INT16S velocity, INT16S target)
+{
+  INT32S error, delta, integral, output;
+
+  error = pid_clamp((INT32S) target - velocity, -PID_ERROR_MAX, PID_ERROR_MAX);
+  delta = pid_clamp((INT32S) velocity - pid_last_velocity,
+                    -PID_ERROR_MAX, PID_ERROR_MAX);
+  pid_last_velocity = velocity;
+
+  integral = pid_clamp(pid_integral + PID_KI * error, 0, PID_OUT_MAX);
+  output = PID_KP * error + integral - PID_KD * delta;
+
+  /* Conditional integration: keep the integral while saturated */
+  if (!((output > PID_OUT_MAX && error > 0) || (output < 0 && error < 0)))
+    pid_integral = integral;
+
+  output = pid_clamp(output, 0, PID_OUT_MAX);
+  output = pid_clamp(output, pid_output - PID_RATE_MAX, pid_output + PID_RATE_MAX);
+  pid_output = output;
+
+  return (INT8U) ((output + (1 << (Q8_SHIFT - 1))) >> Q8_SHIFT);
+}
+
+const CONTROLLER ctrl_pid = { "PID", pid_start, pid_update };
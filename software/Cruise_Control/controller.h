@@ -0,0 +1,37 @@
+/*
+ * Cruise controllers for ControlTask.
+ *
+ * A controller computes the throttle from the current and the target
+ * velocity once per control period while the cruise control is engaged.
+ * 'start()' is called when it engages, with the throttle in use at that
+ * moment, so the output continues without a bump. PID_CONTROL_EN in
+ * app_cfg.h selects the controller of ControlTask.
+ *
+ * Velocities are in 0.1 m/s, the throttle is between 0 and 80 (0.0 V and
+ * 8.0 V).
+ */
+
+#ifndef CONTROLLER_H_
+#define CONTROLLER_H_
+
+#include "includes.h"
+
+#define CTRL_THROTTLE_MAX     80
+
+/* PID gains in Q8 throttle units per 0.1 m/s */
+#define PID_KP             2048   /* 8.0                                   */
+#define PID_KI              384   /* 1.5 per period                        */
+#define PID_KD              512   /* 2.0, on the measured velocity         */
+#define PID_RATE_LIMIT       24   /* Throttle change per period (2.4 V)    */
+#define PID_ERROR_MAX       500   /* Error and velocity step clamp (50 m/s) */
+
+typedef struct {
+  const char* name;
+  void  (*start)(INT16S velocity, INT8U throttle);
+  INT8U (*update)(INT16S velocity, INT16S target);
+} CONTROLLER;
+
+extern const CONTROLLER ctrl_bang_bang;
+extern const CONTROLLER ctrl_pid;
+
+#endif /* CONTROLLER_H_ */
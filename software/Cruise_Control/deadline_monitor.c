@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include "system.h"
+#include "sys/alt_timestamp.h"
+#include "deadline_monitor.h"
+
+#define DM_CYCLES_PER_US (ALT_CPU_FREQ / 1000000)
+
+typedef struct {
+  DM_STATS stats;
+  INT32U release;           /* Release time of the oldest pending job */
+  INT8U  pending;           /* Released jobs not completed yet        */
+  INT8U  shift;             /* Histogram bucket width is 2^shift cycles */
+  INT32U hist[DM_BUCKETS];
+} DM_TASK;
+
+static DM_TASK dm_tasks[DM_MAX_TASKS];
+static INT8U dm_count = 0;
+
+static void dm_clear(DM_TASK* t)
+{
+  INT8U i;
+
+  t->stats.jobs = 0;
+  t->stats.misses = 0;
+  t->stats.overruns = 0;
+  t->stats.best = 0xFFFFFFFF;
+  t->stats.worst = 0;
+  t->stats.worst_latency = 0;
+  t->stats.min_slack = (INT32S) t->stats.deadline;
+  t->stats.total = 0;
+  t->pending = 0;
+  for (i = 0; i < DM_BUCKETS; i++)
+    t->hist[i] = 0;
+}
+
+/*
+ * The function 'dm_register()' adds a periodic task to the monitor and
+ * returns its id, or DM_INVALID_ID when the table is full.
+ */
+INT8U dm_register(const char* name, INT32U period_us, INT32U deadline_us)
+{
+  DM_TASK* t;
+  INT8U id;
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  if (dm_count >= DM_MAX_TASKS) {
+    OS_EXIT_CRITICAL();
+    return DM_INVALID_ID;
+  }
+  id = dm_count++;
+  OS_EXIT_CRITICAL();
+
+  t = &dm_tasks[id];
+  t->stats.name = name;
+  t->stats.period = period_us * DM_CYCLES_PER_US;
+  t->stats.deadline = deadline_us * DM_CYCLES_PER_US;
+
+  /* Buckets of a power-of-two width, so that the histogram covers twice
+   * the deadline and a job is binned with a shift */
+  t->shift = 0;
+  while ((t->stats.deadline >> t->shift) >= DM_BUCKETS / 2)
+    t->shift++;
+
+  dm_clear(t);
+  return id;
+}
+
+/*
+ * The function 'dm_release()' marks the release of a job. It is called
+ * where the task is made ready, e.g. in its timer callback. A release
+ * while a job is still pending is an overrun.
+ */
+void dm_release(INT8U id)
+{
+  INT32U now = alt_timestamp();
+  DM_TASK* t;
+  OS_CPU_SR cpu_sr;
+
+  if (id >= dm_count)
+    return;
+  t = &dm_tasks[id];
+
+  OS_ENTER_CRITICAL();
+  if (t->pending == 0)
+    t->release = now;
+  else
+    t->stats.overruns++;
+  if (t->pending < 0xFF)
+    t->pending++;
+  OS_EXIT_CRITICAL();
+}
+
+/*
+ * The function 'dm_start()' marks the start of the job, after the task
+ * has been released and scheduled.
+ */
+void dm_start(INT8U id)
+{
+  INT32U now = alt_timestamp();
+  DM_TASK* t;
+  INT32U latency;
+  OS_CPU_SR cpu_sr;
+
+  if (id >= dm_count)
+    return;
+  t = &dm_tasks[id];
+
+  OS_ENTER_CRITICAL();
+  if (t->pending != 0) {
+    latency = now - t->release;
+    if (latency > t->stats.worst_latency)
+      t->stats.worst_latency = latency;
+  }
+  OS_EXIT_CRITICAL();
+}
+
+/*
+ * The function 'dm_complete()' marks the end of the job and accounts its
+ * response time. A backlogged job is assumed to be released one period
+ * after the job that just completed.
+ */
+void dm_complete(INT8U id)
+{
+  INT32U now = alt_timestamp();
+  DM_TASK* t;
+  INT32U response, bucket;
+  INT32S slack;
+  OS_CPU_SR cpu_sr;
+
+  if (id >= dm_count)
+    return;
+  t = &dm_tasks[id];
+
+  OS_ENTER_CRITICAL();
+  if (t->pending == 0) {
+    OS_EXIT_CRITICAL();
+    return;
+  }
+
+  response = now - t->release;
+  slack = (INT32S) t->stats.deadline - (INT32S) response;
+
+  t->stats.jobs++;
+  t->stats.total += response;
+  if (response < t->stats.best)
+    t->stats.best = response;
+  if (response > t->stats.worst)
+    t->stats.worst = response;
+  if (slack < t->stats.min_slack)
+    t->stats.min_slack = slack;
+  if (slack < 0)
+    t->stats.misses++;
+
+  bucket = response >> t->shift;
+  if (bucket >= DM_BUCKETS)
+    bucket = DM_BUCKETS - 1;
+  t->hist[bucket]++;
+
+  t->pending--;
+  if (t->pending != 0)
+    t->release += t->stats.period;
+  OS_EXIT_CRITICAL();
+}
+
+/*
+ * The function 'dm_query()' copies the statistics of a task.
+ * Returns 0 on success.
+ */
+INT8U dm_query(INT8U id, DM_STATS* stats)
+{
+  OS_CPU_SR cpu_sr;
+
+  if (id >= dm_count)
+    return 1;
+
+  OS_ENTER_CRITICAL();
+  *stats = dm_tasks[id].stats;
+  OS_EXIT_CRITICAL();
+  return 0;
+}
+
+/*
+ * The function 'dm_percentile()' returns an upper bound in cycles of the
+ * given percentile of the response time, with the resolution of one
+ * histogram bucket (1/16 of the deadline).
+ */
+INT32U dm_percentile(INT8U id, INT8U percent)
+{
+  DM_TASK* t;
+  INT32U target, count = 0, bound;
+  INT8U i;
+
+  if (id >= dm_count)
+    return 0;
+  t = &dm_tasks[id];
+  if (t->stats.jobs == 0)
+    return 0;
+
+  target = t->stats.jobs * percent;
+  for (i = 0; i < DM_BUCKETS - 1; i++) {
+    count += t->hist[i];
+    if (count * 100 >= target)
+      break;
+  }
+
+  bound = (INT32U) (i + 1) << t->shift;
+  if (i == DM_BUCKETS - 1 || bound > t->stats.worst)
+    bound = t->stats.worst;
+  return bound;
+}
+
+/*
+ * Total number of missed deadlines of all tasks
+ */
+INT32U dm_misses_total(void)
+{
+  INT32U misses = 0;
+  INT8U i;
+
+  for (i = 0; i < dm_count; i++)
+    misses += dm_tasks[i].stats.misses;
+  return misses;
+}
+
+void dm_reset(void)
+{
+  INT8U i;
+  OS_CPU_SR cpu_sr;
+
+  for (i = 0; i < dm_count; i++) {
+    OS_ENTER_CRITICAL();
+    dm_clear(&dm_tasks[i]);
+    OS_EXIT_CRITICAL();
+  }
+}
+
+/*
+ * The function 'dm_report()' prints the statistics of all tasks in
+ * microseconds. It divides and calls printf, so it should run in a low
+ * priority task.
+ */
+void dm_report(void)
+{
+  DM_STATS s;
+  INT8U i;
+
+  printf("--Deadline Monitor Report-- (times in us)\n");
+  printf("%-10s %6s %5s %5s %7s %7s %7s %7s %7s %7s %8s\n",
+         "Task", "Jobs", "Miss", "Ovrn", "Best", "Avg", "P95", "P99",
+         "Worst", "Latency", "MinSlack");
+  for (i = 0; i < dm_count; i++) {
+    dm_query(i, &s);
+    if (s.jobs == 0) {
+      printf("%-10s %6d\n", s.name, 0);
+      continue;
+    }
+    printf("%-10s %6lu %5lu %5lu %7lu %7lu %7lu %7lu %7lu %7lu %8ld\n",
+           s.name, s.jobs, s.misses, s.overruns,
+           s.best / DM_CYCLES_PER_US,
+           (INT32U) (s.total / s.jobs) / DM_CYCLES_PER_US,
+           dm_percentile(i, 95) / DM_CYCLES_PER_US,
+           dm_percentile(i, 99) / DM_CYCLES_PER_US,
+           s.worst / DM_CYCLES_PER_US,
+           s.worst_latency / DM_CYCLES_PER_US,
+           s.min_slack / DM_CYCLES_PER_US);
+  }
+}
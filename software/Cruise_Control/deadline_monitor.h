@@ -0,0 +1,51 @@
+/*
+ * Deadline and response-time monitor for the periodic tasks.
+ *
+ * Each job of a monitored task is timestamped at its release, start and
+ * completion with the 50 MHz TIMER_1 timestamp (alt_timestamp(), started
+ * in main()). The monitor keeps per task the response time extremes, the
+ * minimum slack, the number of missed deadlines and a histogram for
+ * percentiles. All hooks are O(1) and use no division.
+ *
+ * Usage:
+ *   id = dm_register("Control", CONTROL_PERIOD * 1000, CONTROL_PERIOD * 1000);
+ *   timer callback:  dm_release(id);
+ *   task:            pend; dm_start(id); ...job...; dm_complete(id);
+ */
+
+#ifndef DEADLINE_MONITOR_H_
+#define DEADLINE_MONITOR_H_
+
+#include "includes.h"
+#include "alt_types.h"
+
+#define DM_MAX_TASKS        8
+#define DM_BUCKETS         32   /* Histogram covers twice the deadline */
+#define DM_INVALID_ID    0xFF
+
+typedef struct {
+  const char* name;
+  INT32U period;          /* cycles */
+  INT32U deadline;        /* cycles, relative to the release */
+  INT32U jobs;            /* completed jobs */
+  INT32U misses;          /* jobs completed after their deadline */
+  INT32U overruns;        /* releases while the previous job was pending */
+  INT32U best;            /* response times in cycles */
+  INT32U worst;
+  INT32U worst_latency;   /* release to start, i.e. release jitter and blocking */
+  INT32S min_slack;       /* deadline - response, negative on a miss */
+  alt_u64 total;          /* sum of all response times */
+} DM_STATS;
+
+INT8U  dm_register(const char* name, INT32U period_us, INT32U deadline_us);
+void   dm_release(INT8U id);
+void   dm_start(INT8U id);
+void   dm_complete(INT8U id);
+
+INT8U  dm_query(INT8U id, DM_STATS* stats);
+INT32U dm_percentile(INT8U id, INT8U percent);
+INT32U dm_misses_total(void);
+void   dm_reset(void);
+void   dm_report(void);
+
+#endif /* DEADLINE_MONITOR_H_ */
@@ -0,0 +1,109 @@
+#include "system.h"
+#include "altera_avalon_pio_regs.h"
+#include "display.h"
+
+#define DISP_RED      0
+#define DISP_GREEN    1
+#define DISP_HEX_LOW  2
+#define DISP_HEX_HIGH 3
+#define DISP_PIOS     4
+
+static const alt_u32 disp_base[DISP_PIOS] = {
+  DE2_PIO_REDLED18_BASE,
+  DE2_PIO_GREENLED9_BASE,
+  DE2_PIO_HEX_LOW28_BASE,
+  DE2_PIO_HEX_HIGH28_BASE
+};
+
+/*
+ * Written contents start as all ones, so the first flush writes every PIO
+ */
+static INT32U disp_shadow[DISP_PIOS];
+static INT32U disp_written[DISP_PIOS] = {
+  0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF
+};
+static INT32U disp_write_count = 0;
+
+/*
+ * Segments of 00-99: (tens << 7) | ones
+ */
+const INT16U disp_two_digits[100] = {
+  0x2040, 0x2079, 0x2024, 0x2030, 0x2019, 0x2012, 0x2002, 0x2078, 0x2000, 0x2018,  /* 00-09 */
+  0x3CC0, 0x3CF9, 0x3CA4, 0x3CB0, 0x3C99, 0x3C92, 0x3C82, 0x3CF8, 0x3C80, 0x3C98,  /* 10-19 */
+  0x1240, 0x1279, 0x1224, 0x1230, 0x1219, 0x1212, 0x1202, 0x1278, 0x1200, 0x1218,  /* 20-29 */
+  0x1840, 0x1879, 0x1824, 0x1830, 0x1819, 0x1812, 0x1802, 0x1878, 0x1800, 0x1818,  /* 30-39 */
+  0x0CC0, 0x0CF9, 0x0CA4, 0x0CB0, 0x0C99, 0x0C92, 0x0C82, 0x0CF8, 0x0C80, 0x0C98,  /* 40-49 */
+  0x0940, 0x0979, 0x0924, 0x0930, 0x0919, 0x0912, 0x0902, 0x0978, 0x0900, 0x0918,  /* 50-59 */
+  0x0140, 0x0179, 0x0124, 0x0130, 0x0119, 0x0112, 0x0102, 0x0178, 0x0100, 0x0118,  /* 60-69 */
+  0x3C40, 0x3C79, 0x3C24, 0x3C30, 0x3C19, 0x3C12, 0x3C02, 0x3C78, 0x3C00, 0x3C18,  /* 70-79 */
+  0x0040, 0x0079, 0x0024, 0x0030, 0x0019, 0x0012, 0x0002, 0x0078, 0x0000, 0x0018,  /* 80-89 */
+  0x0C40, 0x0C79, 0x0C24, 0x0C30, 0x0C19, 0x0C12, 0x0C02, 0x0C78, 0x0C00, 0x0C18,  /* 90-99 */
+};
+
+static void disp_update(INT8U pio, INT32U mask, INT32U bits)
+{
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  disp_shadow[pio] = (disp_shadow[pio] & ~mask) | (bits & mask);
+  OS_EXIT_CRITICAL();
+}
+
+/*
+ * Sets the red LEDs selected by 'mask' to 'bits'
+ */
+void disp_red(INT32U mask, INT32U bits)
+{
+  disp_update(DISP_RED, mask, bits);
+}
+
+/*
+ * Sets the green LEDs selected by 'mask' to 'bits'
+ */
+void disp_green(INT16U mask, INT16U bits)
+{
+  disp_update(DISP_GREEN, mask, bits);
+}
+
+/*
+ * Segments of HEX3-HEX0, seven bits per digit with HEX0 in the lowest bits
+ */
+void disp_hex_low(INT32U segments)
+{
+  disp_shadow[DISP_HEX_LOW] = segments;
+}
+
+/*
+ * Segments of HEX7-HEX4
+ */
+void disp_hex_high(INT32U segments)
+{
+  disp_shadow[DISP_HEX_HIGH] = segments;
+}
+
+/*
+ * The function 'disp_flush()' writes the changed shadow values to the
+ * PIOs. It must be called by a single task, the display owner.
+ */
+void disp_flush(void)
+{
+  INT32U value;
+  INT8U i;
+
+  for (i = 0; i < DISP_PIOS; i++) {
+    value = disp_shadow[i];
+    if (value != disp_written[i]) {
+      IOWR_ALTERA_AVALON_PIO_DATA(disp_base[i], value);
+      disp_written[i] = value;
+      disp_write_count++;
+    }
+  }
+}
+
+/*
+ * Number of PIO writes done by 'disp_flush()'
+ */
+INT32U disp_writes(void)
+{
+  return disp_write_count;
+}
@@ -0,0 +1,33 @@
+/*
+ * Display service for the LEDs and seven-segment displays.
+ *
+ * The tasks only update a shadow copy of the four output PIOs (red LEDs,
+ * green LEDs, HEX3-HEX0 and HEX7-HEX4). 'disp_flush()' is called by one
+ * owner task and writes a PIO only when its shadow value changed.
+ * Two-digit values are converted with a precomputed table, without a
+ * division.
+ */
+
+#ifndef DISPLAY_H_
+#define DISPLAY_H_
+
+#include "includes.h"
+
+/* Seven-segment patterns, active low */
+#define DISP_SEG_0        0x40
+#define DISP_SEG_MINUS    0x3F
+#define DISP_SEG_BITS     7
+
+/* Two digits with the tens digit in the upper seven bits */
+#define DISP_TWO_DIGITS(v)  disp_two_digits[(v) > 99 ? 99 : (v)]
+
+extern const INT16U disp_two_digits[100];
+
+void   disp_red(INT32U mask, INT32U bits);
+void   disp_green(INT16U mask, INT16U bits);
+void   disp_hex_low(INT32U segments);
+void   disp_hex_high(INT32U segments);
+void   disp_flush(void);
+INT32U disp_writes(void);
+
+#endif /* DISPLAY_H_ */
@@ -0,0 +1,25 @@
+#include "input_state.h"
+
+static volatile INPUT_STATE input_state_word = 0;
+
+/*
+ * The function 'input_state_publish()' stores new signal bits and bumps
+ * the version. A reader comparing versions sees every publication, even
+ * one that left the signals unchanged (e.g. a press and release between
+ * two snapshots).
+ */
+void input_state_publish(INT32U signals)
+{
+  INPUT_STATE old = input_state_word;
+
+  input_state_word = ((old + (1ul << INPUT_VERSION_SHIFT)) & ~INPUT_SIGNALS_MASK)
+    | INPUT_SIGNALS(signals);
+}
+
+/*
+ * The function 'input_state_snapshot()' returns all inputs at once
+ */
+INPUT_STATE input_state_snapshot(void)
+{
+  return input_state_word;
+}
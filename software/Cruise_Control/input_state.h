@@ -0,0 +1,34 @@
+/*
+ * Packed, versioned snapshot of the driver inputs.
+ *
+ * All inputs are kept in one 32-bit word: the signal bits in the lower
+ * half and a version counter in the upper half. The input side publishes
+ * the word with a single store and the controller reads it with a single
+ * load, so a snapshot is always consistent without a kernel call or a
+ * critical section. There must be only one publisher.
+ */
+
+#ifndef INPUT_STATE_H_
+#define INPUT_STATE_H_
+
+#include "includes.h"
+
+typedef INT32U INPUT_STATE;
+
+/* Signal bits, set when active */
+#define INPUT_GAS_PEDAL       0x0001
+#define INPUT_BRAKE_PEDAL     0x0002
+#define INPUT_CRUISE_CONTROL  0x0004
+#define INPUT_TOP_GEAR        0x0008
+#define INPUT_ENGINE          0x0010
+
+#define INPUT_SIGNALS_MASK    0x0000FFFF
+#define INPUT_VERSION_SHIFT   16
+
+#define INPUT_SIGNALS(s)      ((s) & INPUT_SIGNALS_MASK)
+#define INPUT_VERSION(s)      ((INT16U) ((s) >> INPUT_VERSION_SHIFT))
+
+void        input_state_publish(INT32U signals);
+INPUT_STATE input_state_snapshot(void);
+
+#endif /* INPUT_STATE_H_ */
@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include "altera_avalon_performance_counter.h"
+#include "load_gen.h"
+
+#define LG_PERF_BASE            ((void*) P_COUNTER_BASE)
+#define LG_CALIBRATION_LOOPS    2000
+#define LG_CPL_SHIFT               4   /* Cycles per loop in Q28.4 */
+
+static INT32U lg_cycles_per_loop = 32 << LG_CPL_SHIFT; /* Until calibrated */
+
+/*
+ * The busy loop. The counter is volatile, so every iteration takes the
+ * same cycles at any optimisation level.
+ */
+static void lg_spin(INT32U loops)
+{
+  volatile INT32U n = loops;
+
+  while (n != 0)
+    n--;
+}
+
+/*
+ * The function 'lg_calibrate()' measures the cycles of one loop iteration
+ * with the performance counter. Interrupts are disabled during the
+ * measurement, so it must run before the tasks are created or from a
+ * context that can afford about 1 ms of interrupt latency.
+ */
+void lg_calibrate(void)
+{
+  INT32U cycles;
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  PERF_RESET(LG_PERF_BASE);
+  PERF_START_MEASURING(LG_PERF_BASE);
+  PERF_BEGIN(LG_PERF_BASE, 1);
+  lg_spin(LG_CALIBRATION_LOOPS);
+  PERF_END(LG_PERF_BASE, 1);
+  PERF_STOP_MEASURING(LG_PERF_BASE);
+  OS_EXIT_CRITICAL();
+
+  cycles = (INT32U) perf_get_section_time(LG_PERF_BASE, 1);
+  lg_cycles_per_loop = ((cycles << LG_CPL_SHIFT) + LG_CALIBRATION_LOOPS / 2)
+                       / LG_CALIBRATION_LOOPS;
+  if (lg_cycles_per_loop == 0)
+    lg_cycles_per_loop = 1;
+
+  printf("Load generator: %lu.%02lu cycles per loop\n",
+         lg_cycles_per_loop >> LG_CPL_SHIFT,
+         ((lg_cycles_per_loop & ((1 << LG_CPL_SHIFT) - 1)) * 100) >> LG_CPL_SHIFT);
+}
+
+/*
+ * The function 'lg_burn()' consumes 'cycles' CPU cycles (up to 2^28,
+ * about 5 s) and returns. Preemption does not count as burnt time.
+ */
+void lg_burn(INT32U cycles)
+{
+  if (cycles > (0xFFFFFFFFu >> LG_CPL_SHIFT))
+    cycles = 0xFFFFFFFFu >> LG_CPL_SHIFT;
+
+  lg_spin((cycles << LG_CPL_SHIFT) / lg_cycles_per_loop);
+}
+
+/*
+ * Cycles of 'load' per mille of a period of 'period_cycles'
+ */
+INT32U lg_load_cycles(INT32U period_cycles, INT16U load)
+{
+  if (load > LG_LOAD_MAX)
+    load = LG_LOAD_MAX;
+
+  /* Split to stay in 32 bits for periods up to 85 s */
+  return (period_cycles / LG_LOAD_MAX) * load
+    + ((period_cycles % LG_LOAD_MAX) * load) / LG_LOAD_MAX;
+}
+
+void lg_sweep_init(LG_SWEEP* s, INT32U misses)
+{
+  s->phase = LG_BASE;
+  s->load = 0;
+  s->fine_start = 0;
+  s->hold = LG_SWEEP_HOLD;
+  s->misses = misses;
+  s->base_usage = 0;
+  s->breakdown = LG_NO_BREAKDOWN;
+}
+
+/*
+ * The function 'lg_sweep_next()' is called once per period of the load
+ * task with the total deadline misses and the current CPU usage and
+ * returns the load for this period. The sweep runs:
+ *
+ *   LG_BASE    no load, OSCPUUsage is taken as the base usage
+ *   LG_COARSE  +LG_SWEEP_COARSE per step until the first miss
+ *   LG_SETTLE  no load, the backlog of the overload drains
+ *   LG_FINE    +LG_SWEEP_FINE per step from the last good coarse load
+ *   LG_DONE    no load, 'breakdown' holds the first fine load with a miss
+ */
+INT16U lg_sweep_next(LG_SWEEP* s, INT32U misses, INT8U cpu_usage)
+{
+  INT8U missed = (misses != s->misses);
+
+  s->misses = misses;
+
+  if (missed && s->phase == LG_COARSE) {
+    s->fine_start = (s->load > LG_SWEEP_COARSE) ? s->load - LG_SWEEP_COARSE : 0;
+    s->phase = LG_SETTLE;
+    s->load = 0;
+    s->hold = LG_SWEEP_HOLD;
+    return s->load;
+  }
+  if (missed && s->phase == LG_FINE) {
+    s->breakdown = s->load;
+    s->phase = LG_DONE;
+    s->load = 0;
+    return s->load;
+  }
+
+  if (s->phase == LG_DONE || --s->hold != 0)
+    return s->load;
+
+  s->hold = LG_SWEEP_HOLD;
+  switch (s->phase) {
+  case LG_BASE:
+    s->base_usage = cpu_usage;
+    s->phase = LG_COARSE;
+    s->load = LG_SWEEP_COARSE;
+    break;
+  case LG_SETTLE:
+    s->phase = LG_FINE;
+    s->load = s->fine_start + LG_SWEEP_FINE;
+    break;
+  default:
+    s->load += (s->phase == LG_COARSE) ? LG_SWEEP_COARSE : LG_SWEEP_FINE;
+    break;
+  }
+
+  /* No miss even with the full period burnt */
+  if (s->load > LG_LOAD_MAX) {
+    s->phase = LG_DONE;
+    s->load = 0;
+  }
+
+  return s->load;
+}
+
+void lg_sweep_report(const LG_SWEEP* s)
+{
+  INT32U total;
+
+  if (s->breakdown == LG_NO_BREAKDOWN) {
+    printf("Load sweep: no deadline miss up to 100%% extra load\n");
+    return;
+  }
+
+  total = (INT32U) s->base_usage * 10 + s->breakdown;
+  printf("Load sweep: first miss at %d.%d%% extra load, base CPU usage %d%%\n",
+         s->breakdown / 10, s->breakdown % 10, s->base_usage);
+  printf("Breakdown utilization: %lu.%lu%%\n", total / 10, total % 10);
+}
@@ -0,0 +1,49 @@
+/*
+ * Calibrated CPU load generator.
+ *
+ * 'lg_burn()' consumes a given number of CPU cycles with a busy loop. The
+ * cycles per loop iteration are measured once with the P_COUNTER, so the
+ * load is CPU time and not wall-clock time: a preempted burn still takes
+ * its full share of the CPU. The resolution is one loop iteration, a few
+ * dozen cycles.
+ *
+ * The sweep raises the load step by step until the first deadline miss
+ * reported by the deadline monitor, first in coarse and then in fine
+ * steps, and records the breakdown load.
+ */
+
+#ifndef LOAD_GEN_H_
+#define LOAD_GEN_H_
+
+#include "includes.h"
+#include "system.h"
+
+#define LG_US_TO_CYCLES(us)   ((INT32U) (us) * (ALT_CPU_FREQ / 1000000))
+
+#define LG_LOAD_MAX          1000   /* Loads are in per mille of the period */
+#define LG_SWEEP_COARSE        20   /* 2.0 % */
+#define LG_SWEEP_FINE           2   /* 0.2 % */
+#define LG_SWEEP_HOLD           5   /* Periods per step, covers the 1 s OSCPUUsage window */
+#define LG_NO_BREAKDOWN    0xFFFF
+
+enum lg_phase {LG_BASE, LG_COARSE, LG_SETTLE, LG_FINE, LG_DONE};
+
+typedef struct {
+  enum lg_phase phase;
+  INT16U load;        /* Load of the current step (per mille)          */
+  INT16U fine_start;  /* Last coarse load without a miss               */
+  INT8U  hold;        /* Periods left in the current step              */
+  INT32U misses;      /* Deadline misses seen at the last call         */
+  INT8U  base_usage;  /* OSCPUUsage without injected load (%)          */
+  INT16U breakdown;   /* Load of the first fine miss, or LG_NO_BREAKDOWN */
+} LG_SWEEP;
+
+void   lg_calibrate(void);
+void   lg_burn(INT32U cycles);
+INT32U lg_load_cycles(INT32U period_cycles, INT16U load);
+
+void   lg_sweep_init(LG_SWEEP* s, INT32U misses);
+INT16U lg_sweep_next(LG_SWEEP* s, INT32U misses, INT8U cpu_usage);
+void   lg_sweep_report(const LG_SWEEP* s);
+
+#endif /* LOAD_GEN_H_ */
@@ -1,106 +1,149 @@
 
 #include <stdio.h>
+#include <unistd.h>
 #include "system.h"
 #include "includes.h"
 #include "altera_avalon_pio_regs.h"
 #include "sys/alt_irq.h"
 #include "sys/alt_alarm.h"
+#include "sys/alt_timestamp.h"
+#include "app_cfg.h"
+#include "benchmark.h"
+#include "vehicle_dynamics.h"
+#include "input_state.h"
+#include "telemetry.h"
+#include "deadline_monitor.h"
+#include "load_gen.h"
+#include "display.h"
+#include "track.h"
+#include "controller.h"
+#include "pipeline.h"
+#include "task_profile.h"
+#include "trace_dump.h"
+#include "pubsub.h"
+#include "stack_report.h"
+
+#if OS_TASK_PERIODIC_EN == 0
+#error  "OS_CFG.H, OS_TASK_PERIODIC_EN must be 1: WatchDogTask is created with OSTaskCreatePeriodic()"
+#endif
+
+#if (TRACE_DUMP_EN > 0) && (OS_TRACE_EN == 0)
+#error  "APP_CFG.H, TRACE_DUMP_EN needs OS_TRACE_EN 1 in os_cfg.h, or set TRACE_DUMP_EN to 0"
+#endif
 
 
 #define DEBUG 1
 
-#define HW_TIMER_PERIOD 100 /* 100ms */
+/* Soft timer periods: OSTmr_Task runs OS_TMR_CFG_TICKS_PER_SEC times per second,
+ * signalled by OSTimeTickHook() only */
+#define MS_TO_TMR_TICKS(ms) ((ms) * OS_TMR_CFG_TICKS_PER_SEC / 1000)
+
+/* Periods of the tasks released by OSTimeTick(), see OSTaskCreatePeriodic() */
+#define MS_TO_OS_TICKS(ms) ((INT16U) ((ms) * OS_TICKS_PER_SEC / 1000))
 
 /* Button Patterns */
 
 #define GAS_PEDAL_FLAG      0x08
 #define BRAKE_PEDAL_FLAG    0x04
 #define CRUISE_CONTROL_FLAG 0x02
+#define REPORT_FLAG         0x01 //KEY0 prints the deadline monitor report
 /* Switch Patterns */
 
 #define TOP_GEAR_FLAG       0x00000002
 #define ENGINE_FLAG         0x00000001
+#define LOAD_SWEEP_FLAG     0x00020000 //SW17 sweeps the extra load up to the first deadline miss
 
 /* LED Patterns */
-#define LEDR17          0x20000 //position 0 - 399
-#define LEDR16          0x10000 //position 400 - 799
-#define LEDR15          0x08000 //position 800 - 1199
-#define LEDR14          0x04000 //position 1200 - 1599
-#define LEDR13          0x02000 //position 1600 - 1999
-#define LEDR12          0x01000 //position 2000 - 2399
+#define LEDR17          0x20000 //position zone 0, first sixth of the track
+#define LEDR16          0x10000 //position zone 1
+#define LEDR15          0x08000 //position zone 2
+#define LEDR14          0x04000 //position zone 3
+#define LEDR13          0x02000 //position zone 4
+#define LEDR12          0x01000 //position zone 5, last sixth of the track
+#define LED_POSITION    (LEDR17 | LEDR16 | LEDR15 | LEDR14 | LEDR13 | LEDR12)
+#define LED_EXTRALOAD   0x003F0 //SW9-SW4, extra load
 
 #define LED_RED_0 0x00000001 // Engine
 #define LED_RED_1 0x00000002 // Top Gear
+#define LED_RED_STATE (LED_RED_0 | LED_RED_1)
 
 #define LED_GREEN_0 0x0001 // Cruising
 #define LED_GREEN_2 0x0004 // Cruise Control Button
 #define LED_GREEN_4 0x0010 // Brake Pedal
 #define LED_GREEN_6 0x0040 // Gas Pedal
+#define LED_GREEN_STATE (LED_GREEN_0 | LED_GREEN_2 | LED_GREEN_4 | LED_GREEN_6)
 
 /*
  * Definition of Tasks
  */
 
-#define TASK_STACKSIZE 2048
+// Stack sizes in OS_STK elements, see the stack report (KEY0)
+
+#define STARTTASK_STACKSIZE     2048
+#define CONTROLTASK_STACKSIZE   2048
+#define VEHICLETASK_STACKSIZE   2048
+#define WATCHDOGTASK_STACKSIZE  2048
+#define EXTRALOADTASK_STACKSIZE 2048
+#define INPUTTASK_STACKSIZE     2048
+#define TELEMETRYTASK_STACKSIZE 2048
 
-OS_STK StartTask_Stack[TASK_STACKSIZE];
-OS_STK ControlTask_Stack[TASK_STACKSIZE];
-OS_STK VehicleTask_Stack[TASK_STACKSIZE];
-OS_STK DetectionTask_Stack[TASK_STACKSIZE];
-OS_STK WatchDogTask_Stack[TASK_STACKSIZE];
-OS_STK ExtraLoadTask_Stack[TASK_STACKSIZE];
-OS_STK ButtonIOTask_Stack[TASK_STACKSIZE];
-OS_STK SwitchIOTask_Stack[TASK_STACKSIZE];
+OS_STK StartTask_Stack[STARTTASK_STACKSIZE];
+OS_STK ControlTask_Stack[CONTROLTASK_STACKSIZE];
+OS_STK VehicleTask_Stack[VEHICLETASK_STACKSIZE];
+OS_STK WatchDogTask_Stack[WATCHDOGTASK_STACKSIZE];
+OS_STK ExtraLoadTask_Stack[EXTRALOADTASK_STACKSIZE];
+OS_STK InputTask_Stack[INPUTTASK_STACKSIZE];
+OS_STK TelemetryTask_Stack[TELEMETRYTASK_STACKSIZE];
 
 // Task Priorities
 
 #define STARTTASK_PRIO     5
 #define VEHICLETASK_PRIO  10
 #define CONTROLTASK_PRIO  12
-#define DETECTIONTASK_PRIO    14
 #define WATCHDOGTASK_PRIO     6
 #define EXTRALOADTASK_PRIO   13
-#define BUTTONIOTASK_PRIO  8 //highest priority of Input task
-#define SWITCHIOTASK_PRIO  9 //second highest priority of Input task
+#define INPUTTASK_PRIO     8 //highest priority of the application tasks below the watchdog
+#define TELEMETRYTASK_PRIO  18 //lowest priority, only uses idle time
 
 // Task Periods
 
 #define CONTROL_PERIOD  300
 #define VEHICLE_PERIOD  300
-#define BUTTON_PERIOD   100 //these value gives nice enough responsivity for SW timer based period
-#define SWITCH_PERIOD   100
+#define TELEMETRY_PERIOD 100 //drain interval of the telemetry ring
+#define CPU_REPORT_PERIOD 5000 //interval of the CPU time report, see CPU_REPORT_EN in app_cfg.h
+
+// Pipeline phases (ms into VEHICLE_PERIOD), see PIPELINE_EN in app_cfg.h
+
+#define SAMPLE_PHASE     0 //VehicleTask publishes the velocity
+#define CONTROL_PHASE    0 //ControlTask computes the throttle, runs after the sample by priority
+#define ACTUATE_PHASE   20 //VehicleTask applies the throttle, above the worst control response
+
+// Input debouncing (in OS ticks)
+
+#define INPUT_DEBOUNCE_TICKS      10 //edge interrupts stay masked while the contacts settle
+#define INPUT_RELEASE_POLL_TICKS  20 //KEYS4 only captures presses, releases are polled while a key is held
+
+// Control Task events
+
+#define CONTROL_FLAG_PERIOD  0x0001 //periodic release by Control_Tmr or the pipeline
+#define CONTROL_FLAG_INPUT   0x0002 //an input changed, react without waiting for the next period
 
 /*
  * Definition of Kernel Objects
  */
 
-// Mailboxes
-OS_EVENT *Mbox_Throttle;
-OS_EVENT *Mbox_Velocity;
-OS_EVENT *Mbox_Detection;
-OS_EVENT *Mbox_Cruise_Control;
-OS_EVENT *Mbox_Gas_Pedal;
-OS_EVENT *Mbox_Brake_Pedal;
-OS_EVENT *Mbox_Engine;
-OS_EVENT *Mbox_Gear;
-
 // Semaphores
-OS_EVENT *buttonSem;
-OS_EVENT *switchSem;
+OS_EVENT *Input_Sem;
 OS_EVENT *Vehicle_Sem;
-OS_EVENT *Control_Sem;
-OS_EVENT *Detection_Sem;
-OS_EVENT *WatchDog_Sem;
+OS_EVENT *Actuate_Sem;
 OS_EVENT *ExtraLoad_Sem;
 
-// SW-Timer
-OS_TMR *buttonTmr;
-OS_TMR *switchTmr;
+// Event Flags
+OS_FLAG_GRP *Control_Flags;
 
+// SW-Timer
 OS_TMR *Vehicle_Tmr;
 OS_TMR *Control_Tmr;
-OS_TMR *Detection_Tmr;
-OS_TMR *WatchDog_Tmr;
 OS_TMR *ExtraLoad_Tmr;
 
 /*
@@ -113,49 +156,80 @@ enum active brake_pedal = off;
 enum active top_gear = off;
 enum active engine = off;
 enum active cruise_control = off; //refers to user input
+enum active engine_switch = off; //refers to user input, the engine only stops at standstill
 enum active cruising = off; //refers to vehicle state
 enum active extra_load = off; //refers to vehicle state
 
 /*
  * Global variables
  */
-int delay; // Delay of HW-timer
 int ExtraLoad_Percentage = 0; // The percentage of processing time of the extraload task
-INT16U led_green = 0; // Green LEDs
-INT32U led_red = 0;   // Red LEDs
-INT16U led_extraload = 0; // Red LEDs for extraload
+INT8U report_requested = 0; // Set by KEY0, TelemetryTask prints the deadline, CPU time and stack reports
+INT8U sweep_finished = 0; // Set by ExtraLoadTask, TelemetryTask prints the sweep result
+#if TRACE_DUMP_EN > 0
+INT8U trace_armed = 1; // The next deadline miss freezes the kernel trace, re-armed by KEY0
+INT8U trace_frozen = 0; // Set by WatchDogTask, TelemetryTask dumps the trace
+#endif
+LG_SWEEP load_sweep; // Breakdown utilization search of ExtraLoadTask
+
+#if PID_CONTROL_EN > 0
+const CONTROLLER* cruise_controller = &ctrl_pid;
+#else
+const CONTROLLER* cruise_controller = &ctrl_bang_bang;
+#endif
+
+#if PIPELINE_EN > 0
+// Hand-off between the pipeline stages
+PIPE_SLOT velocity_slot;
+PIPE_SLOT throttle_slot;
+#endif
+
+// Published once per period, the message carries the sample time of the velocity.
+// Without PIPELINE_EN they also carry the hand-off between VehicleTask and ControlTask.
+PS_TOPIC velocity_topic; // INT16S, read by ControlTask (control and display) and TelemetryTask
+PS_TOPIC throttle_topic; // INT8U, read by VehicleTask and TelemetryTask
+PS_STORAGE(velocity_storage, INT16S, 3);
+PS_STORAGE(throttle_storage, INT8U, 2);
+
+// Deadline monitor ids of the periodic tasks
+INT8U vehicle_dm = DM_INVALID_ID;
+INT8U control_dm = DM_INVALID_ID;
+INT8U extraload_dm = DM_INVALID_ID;
 
+/*
+ * The LED functions only update the shadow of the display service,
+ * ControlTask writes the changes with disp_flush()
+ */
 void draw_green_leds ()
 {
-    if (cruising == on)
-    led_green += LED_GREEN_0;
+INT16U led_green = 0; // Green LEDs
+
+if (cruising == on)
+led_green |= LED_GREEN_0;
 
 if (cruise_control == on)
-led_green += LED_GREEN_2;
+led_green |= LED_GREEN_2;
 
 if (brake_pedal == on)
-led_green += LED_GREEN_4;
+led_green |= LED_GREEN_4;
 
 if (gas_pedal == on)
-led_green += LED_GREEN_6;
+led_green |= LED_GREEN_6;
 
-IOWR_ALTERA_AVALON_PIO_DATA(DE2_PIO_GREENLED9_BASE, led_green);
-led_green = 0; //after writing leds, set led to 0 for next time
+disp_green(LED_GREEN_STATE, led_green);
 }
 
 void draw_red_leds ()
 {
+INT32U led_red = 0; // Red LEDs
+
 if (engine == on)
-led_red += LED_RED_0;
+led_red |= LED_RED_0;
 
 if (top_gear == on)
-led_red += LED_RED_1;
-
-if (extra_load == on)
-led_red += led_extraload;
+led_red |= LED_RED_1;
 
-IOWR_ALTERA_AVALON_PIO_DATA(DE2_PIO_REDLED18_BASE, led_red);
-led_red = 0;//after writing leds, set led to 0 for next time
+disp_red(LED_RED_STATE, led_red);
 }
 
 int buttons_pressed(void)
@@ -168,108 +242,76 @@ int switches_pressed(void)
   return IORD_ALTERA_AVALON_PIO_DATA(DE2_PIO_TOGGLES18_BASE);
 }
 
-void simulate_overload(int delay)
-{
-//float num_ticks_per_second = (float)alt_ticks_per_second();
-  alt_u32 start = alt_nticks();
-  // Wait for the desired number of ticks
-  while((alt_nticks() - start)< delay);
-}
-
-/*
- * ISR for HW Timer
- */
-alt_u32 alarm_handler(void* context)
-{
-  OSTmrSignal(); /* Signals a 'tick' to the SW timers */
-
-  return delay;
-}
-
 /*
  * Soft Timer Callback Functions
  */
 void Vehicle_Callback()
 {
+dm_release(vehicle_dm);
 OSSemPost(Vehicle_Sem);
 }
 
-void Control_Callback()
+void Actuate_Callback()
 {
-OSSemPost(Control_Sem);
+OSSemPost(Actuate_Sem);
 }
 
-void Detection_Callback()
+void Control_Callback()
 {
-OSSemPost(Detection_Sem);
-}
+INT8U err;
 
-void WatchDog_Callback()
-{
-OSSemPost(WatchDog_Sem);
+dm_release(control_dm);
+OSFlagPost(Control_Flags, CONTROL_FLAG_PERIOD, OS_FLAG_SET, &err);
 }
 
 void ExtraLoad_Callback()
 {
+dm_release(extraload_dm);
 OSSemPost(ExtraLoad_Sem);
 }
 
-void makeAvailableButtonTask ()
-{
-OSSemPost(buttonSem);
-}
-
-void makeAvailableSwitchTask ()
-{
-OSSemPost(switchSem);
-}
-
-
-static int b2sLUT[] = {0x40, //0
-       0x79, //1
-       0x24, //2
-       0x30, //3
-       0x19, //4
-       0x12, //5
-       0x02, //6
-       0x78, //7
-       0x00, //8
-       0x18, //9
-       0x3F, //-
+#if PIPELINE_EN > 0
+/*
+ * Stages of the control pipeline, released every VEHICLE_PERIOD (which
+ * replaces CONTROL_PERIOD for ControlTask)
+ */
+static const PIPE_STAGE pipeline[] = {
+  { SAMPLE_PHASE,  Vehicle_Callback },
+  { CONTROL_PHASE, Control_Callback },
+  { ACTUATE_PHASE, Actuate_Callback }
 };
+#endif
 
 /*
- * convert int to seven segment display format
+ * ISR for the edge capture of KEYS4 (presses) and TOGGLES18 (any edge).
+ * The interrupt of the PIO stays masked until 'InputTask' has debounced
+ * the input, so a bouncing contact raises a single interrupt.
  */
-int int2seven(int inval){
-  return b2sLUT[inval];
+static void input_isr(void* context)
+{
+  alt_u32 base = (alt_u32) context;
+
+  IOWR_ALTERA_AVALON_PIO_IRQ_MASK(base, 0);
+  IOWR_ALTERA_AVALON_PIO_EDGE_CAP(base, 0);
+  OSSemPost(Input_Sem);
 }
 
+
 /*
  * output current velocity on the seven segement display
  */
 void show_velocity_on_sevenseg(INT8S velocity){
-  int tmp = velocity;
-  int out;
-  INT8U out_high = 0;
-  INT8U out_low = 0;
-  INT8U out_sign = 0;
+  INT32U out_sign = DISP_SEG_0;
+  INT8U tmp = velocity;
 
   if(velocity < 0){
-    out_sign = int2seven(10);
-    tmp *= -1;
-  }else{
-    out_sign = int2seven(0);
+    out_sign = DISP_SEG_MINUS;
+    tmp = -velocity;
   }
 
-  out_high = int2seven(tmp / 10);            //tens digit
-  out_low = int2seven(tmp - (tmp/10) * 10); //single digit
-
-  out = int2seven(0) << 21 |
-    out_sign << 14 |
-    out_high << 7  |
-    out_low;
-  IOWR_ALTERA_AVALON_PIO_DATA(DE2_PIO_HEX_LOW28_BASE,out);
+  disp_hex_low(DISP_SEG_0 << (3 * DISP_SEG_BITS) |
+               out_sign << (2 * DISP_SEG_BITS) |
+               DISP_TWO_DIGITS(tmp));
 }
 
 /*
@@ -278,145 +320,121 @@ void show_velocity_on_sevenseg(INT8S velocity){
  */
 void show_target_velocity(INT8U target_vel)
 {
-  int tmp = target_vel;
-  int out;
-  INT8U out_high = 0;
-  INT8U out_low = 0;
-
-  out_high = int2seven(tmp / 10);
-  out_low = int2seven(tmp - (tmp/10) * 10);
-
-  out = int2seven(0) << 21 |
-int2seven(0) << 14 |
-    out_high << 7  |
-    out_low;
-  IOWR_ALTERA_AVALON_PIO_DATA(DE2_PIO_HEX_HIGH28_BASE,out);
+  disp_hex_high(DISP_SEG_0 << (3 * DISP_SEG_BITS) |
+                DISP_SEG_0 << (2 * DISP_SEG_BITS) |
+                DISP_TWO_DIGITS(target_vel));
 }
 
 /*
- * indicates the position of the vehicle on the track with the four leftmost red LEDs
- * LEDR17: [0m, 400m)
- * LEDR16: [400m, 800m)
- * LEDR15: [800m, 1200m)
- * LEDR14: [1200m, 1600m)
- * LEDR13: [1600m, 2000m)
- * LEDR12: [2000m, 2400m]
+ * indicates the position of the vehicle on the track with the six leftmost red LEDs,
+ * each LED covers a sixth of the track (track_zone_end[] in track_data.c)
+ * LEDR17: [0m, 400m) on the lab track
+ * ...
+ * LEDR12: [2000m, 2400m)
  */
-void show_position(INT16U position)
+void show_position(INT32U position)
 {
-if(position < 4000)
-led_red += LEDR17;
-else if(position < 8000)
-led_red += LEDR16;
-else if(position < 12000)
-led_red += LEDR15;
-else if(position < 16000)
-led_red += LEDR14;
-else if(position < 20000)
-led_red += LEDR13;
-else if(position < 24000)
-led_red += LEDR12;
-}
+INT32U led_red = LEDR17 >> track_zone(position);
 
-/*
- * The function 'adjust_position()' adjusts the position depending on the
- * acceleration and velocity.
- */
-INT16U adjust_position(INT16U position, INT16S velocity,
-       INT8S acceleration, INT16U time_interval)
-{
-  INT16S new_position = position + velocity * time_interval / 1000
-    + acceleration / 2  * (time_interval / 1000) * (time_interval / 1000);
-
-  if (new_position > 24000) { //Why 24000 instead of 2400?
-    new_position -= 24000;
-  } else if (new_position < 0){
-    new_position += 24000;
-  }
-
-  show_position(new_position);
-  return new_position;
+disp_red(LED_POSITION, led_red);
 }
 
 /*
- * The function 'adjust_velocity()' adjusts the velocity depending on the
- * acceleration.
+ * Current driver and vehicle state as telemetry flags
  */
-INT16S adjust_velocity(INT16S velocity, INT8S acceleration,
-       enum active brake_pedal, INT16U time_interval)
+INT16U telemetry_flags(void)
 {
-  INT16S new_velocity;
-  INT8U brake_retardation = 200;
-
-  if (brake_pedal == off)
-    new_velocity = velocity  + (float) (acceleration * time_interval) / 1000.0;
-  else {
-    if (brake_retardation * time_interval / 1000 > velocity)
-      new_velocity = 0;
-    else
-      new_velocity = velocity - brake_retardation * time_interval / 1000;
-  }
-
-  return new_velocity;
+  INT16U flags = 0;
+
+  if (engine == on)
+    flags |= TLM_FLAG_ENGINE;
+  if (top_gear == on)
+    flags |= TLM_FLAG_TOP_GEAR;
+  if (gas_pedal == on)
+    flags |= TLM_FLAG_GAS;
+  if (brake_pedal == on)
+    flags |= TLM_FLAG_BRAKE;
+  if (cruise_control == on)
+    flags |= TLM_FLAG_CRUISE;
+  if (cruising == on)
+    flags |= TLM_FLAG_CRUISING;
+
+  return flags;
 }
 
 /*
- * The task 'VehicleTask' updates the current velocity of the vehicle
+ * The task 'VehicleTask' updates the current velocity of the vehicle.
+ * With PIPELINE_EN it is released twice per period: at SAMPLE_PHASE it
+ * publishes the velocity, at ACTUATE_PHASE it applies the throttle that
+ * ControlTask computed from this sample and steps the model.
  */
 void VehicleTask(void* pdata)
 {
   INT8U err;
-  void* msg;
-  INT8U* throttle;
-  INT8S acceleration;  /* Value between 40 and -20 (4.0 m/s^2 and -2.0 m/s^2) */
-  INT8S retardation;   /* Value between 20 and -10 (2.0 m/s^2 and -1.0 m/s^2) */
-  INT16U position = 0; /* Value between 0 and 20000 (0.0 m and 2000.0 m)  */
+  static INT8U no_throttle = 0;
+  INT8U* throttle = &no_throttle; /* Until the first message from ControlTask */
+  VD_STATE vehicle;    /* Fixed-point state, see vehicle_dynamics.h */
+  INT32U position = 0; /* Value between 0 and track_length (0.1 m)  */
   INT16S velocity = 0; /* Value between -200 and 700 (-20.0 m/s amd 70.0 m/s) */
-  INT16S wind_factor;   /* Value between -10 and 20 (-1.0 m/s^2 and 2.0 m/s^2) */
+  static INT8U actuated = 0;
+  INT32U now;
+  PS_MSG* msg;
+#if PIPELINE_EN > 0
+  INT32S value;
+  INT32U stamp;
+#else
+  PS_SUB throttle_sub;
+
+  ps_subscribe(&throttle_sub, &throttle_topic);
+#endif
 
   printf("Vehicle task created!\n");
 
+  vd_init(&vehicle, VEHICLE_PERIOD);
+
   while(1)
     {
   OSSemPend(Vehicle_Sem, 0, &err);
-      err = OSMboxPost(Mbox_Velocity, (void *) &velocity);
-
-      //OSTimeDlyHMSM(0,0,0,VEHICLE_PERIOD);
-
-      /* Non-blocking read of mailbox:
-- message in mailbox: update throttle
-- no message:         use old throttle
-      */
-      msg = OSMboxPend(Mbox_Throttle, 1, &err);
-      if (err == OS_NO_ERR)
-throttle = (INT8U*) msg;
-
-      /* Retardation : Factor of Terrain and Wind Resistance */
-      if (velocity > 0)
-wind_factor = velocity * velocity / 10000 + 1;
-      else
-wind_factor = (-1) * velocity * velocity / 10000 + 1;
-
-      if (position < 4000)
-retardation = wind_factor; // even ground
-      else if (position < 8000)
-retardation = wind_factor + 15; // traveling uphill
-      else if (position < 12000)
-retardation = wind_factor + 25; // traveling steep uphill
-      else if (position < 16000)
-retardation = wind_factor; // even ground
-      else if (position < 20000)
-retardation = wind_factor - 10; //traveling downhill
-      else
-retardation = wind_factor - 5 ; // traveling steep downhill
-
-      acceleration = *throttle / 2 - retardation;
-      position = adjust_position(position, velocity, acceleration, 300);
-      velocity = adjust_velocity(velocity, acceleration, brake_pedal, 300);
-      printf("Position: %dm\n", position / 10);
-      printf("Velocity: %4.1fm/s\n", velocity /10.0);
-      printf("Throttle: %dV\n", *throttle / 10);
-      show_velocity_on_sevenseg((INT8S) (velocity / 10));
+      dm_start(vehicle_dm);
+      now = alt_timestamp();
+#if PIPELINE_EN > 0
+      pipe_put(&velocity_slot, velocity, now);
+#endif
+      msg = ps_alloc(&velocity_topic);
+      if (msg != NULL)
+        {
+          *PS_DATA(msg, INT16S) = velocity;
+          ps_publish(msg, now);
+        }
+
+#if PIPELINE_EN > 0
+      OSSemPend(Actuate_Sem, 0, &err);
+      if (pipe_get(&throttle_slot, &value, &stamp))
+        {
+          actuated = (INT8U) value;
+          throttle = &actuated;
+          pipe_latency(stamp);
+        }
+#else
+      /* New throttle published: update throttle, else use the old one */
+      msg = ps_read(&throttle_sub);
+      if (msg != NULL)
+        {
+          actuated = *PS_DATA(msg, INT8U);
+          throttle = &actuated;
+          pipe_latency(msg->stamp);
+          ps_release(msg);
+        }
+#endif
+
+      /* Retardation by terrain and wind resistance is part of the model */
+      vd_step(&vehicle, *throttle, brake_pedal == on);
+      position = vd_position(&vehicle);
+      velocity = vd_velocity(&vehicle);
+      show_position(position);
+
+      tlm_write(TLM_SRC_VEHICLE, position, velocity, *throttle, telemetry_flags(), 0);
+      dm_complete(vehicle_dm);
     }
 }
 
@@ -435,38 +453,24 @@ cruising = on;
 *target_velocity = *current_velocity; //TODO: use of pointers here?
 }
 
-void handleGasPedal ()
+void handleGasPedal (INPUT_STATE inputs)
 {
-INT8U err;
-void* msg;
+gas_pedal = (inputs & INPUT_GAS_PEDAL) ? on : off;
 
-msg = OSMboxPend(Mbox_Gas_Pedal, 1, &err);
-if (msg == on)
+if (gas_pedal == on)
 {
-gas_pedal = on;
 deactivateCruiseControl ();
 }
-else if (msg == off)
-{
-gas_pedal = off;
-}
 }
 
-void handleBrakePedal ()
+void handleBrakePedal (INPUT_STATE inputs)
 {
-INT8U err;
-void* msg;
+brake_pedal = (inputs & INPUT_BRAKE_PEDAL) ? on : off;
 
-msg = OSMboxPend(Mbox_Brake_Pedal, 1, &err);
-if (msg == on)
+if (brake_pedal == on)
 {
-brake_pedal = on;
 deactivateCruiseControl ();
 }
-else
-{
-brake_pedal = off;
-}
 }
 
 int allowedToActivateCruiseControl (INT16S* current_velocity)
@@ -479,59 +483,45 @@ gas_pedal == off;
 
 
 
-void handleCruiseControl (INT16S* current_velocity,
+void handleCruiseControl (INPUT_STATE inputs,
+  INT16S* current_velocity,
   INT16S* target_velocity)
 {
-INT8U err;
-void* msg;
+cruise_control = (inputs & INPUT_CRUISE_CONTROL) ? on : off;
 
-msg = OSMboxPend(Mbox_Cruise_Control, 1, &err);
-if (msg == on)
-{
-cruise_control = on;
-if (allowedToActivateCruiseControl (current_velocity))
+if (cruise_control == on && allowedToActivateCruiseControl (current_velocity))
 {
 activateCruiseControl (current_velocity, target_velocity);
 }
 }
-else if (msg == off)
-{
-cruise_control = off;
-}
-}
 
-void handleTopGear ()
+void handleTopGear (INPUT_STATE inputs)
 {
-INT8U err;
-void* msg;
+top_gear = (inputs & INPUT_TOP_GEAR) ? on : off;
 
-msg = OSMboxPend(Mbox_Gear, 1, &err);
-if (msg == on)
+if (top_gear == off)
 {
-top_gear = on;
-}
-else if (msg == off)
-{
-top_gear = off;
 deactivateCruiseControl ();
 }
 }
 
 
 
-void handleEngine (INT16S* current_velocity,
+void handleEngine (INPUT_STATE inputs,
+           INT16S* current_velocity,
            INT16S* target_velocity,
-           INT8U* throttle)
+           INT8U* throttle,
+           INT8U periodic) //the controller only runs once per control period
 {
-INT8U err;
-void* msg;
+static enum active engaged = off;
 
-msg = OSMboxPend(Mbox_Engine, 1, &err);
-if (msg == on)
+engine_switch = (inputs & INPUT_ENGINE) ? on : off;
+
+if (engine_switch == on)
 {
 engine = on;
 }
-else if (msg == off && *current_velocity < 1 && *current_velocity > -1) //if velocity is very close to 0, shut engine
+else if (*current_velocity < 1 && *current_velocity > -1) //if velocity is very close to 0, shut engine
 {
 engine = off;
 deactivateCruiseControl ();
@@ -547,208 +537,399 @@ if (gas_pedal == on)
 else if (gas_pedal == off)
 *throttle = 0;
 }
-else if (cruising == on) //PID Controller better than bang controller?
+else if (cruising == on && periodic) //see PID_CONTROL_EN in app_cfg.h
 {
-if (*current_velocity < *target_velocity)
-*throttle = 80;
-else if (*current_velocity > *target_velocity)
-*throttle = 0;
+if (engaged == off)
+{
+cruise_controller->start(*current_velocity, *throttle);
+engaged = on;
+}
+*throttle = cruise_controller->update(*current_velocity, *target_velocity);
 }
 }
+if (engine == off || cruising == off)
+engaged = off;
 }
 
 
 /*
  * The task 'ControlTask' is the main task of the application. It reacts
- * on sensors and generates responses.
+ * on sensors and generates responses. Besides the periodic release it runs
+ * as soon as 'InputTask' reports an input change, reusing the last velocity.
  */
 
 void ControlTask(void* pdata)
 {
   INT8U err;
   INT8U throttle = 40; /* Value between 0 and 80, which is interpreted as between 0.0V and 8.0V */
-  void* msg;
-  INT16S* current_velocity;
-  INT16S* target_velocity;
+  static INT16S sampled_velocity = 0;
+  INT32U stamp = 0; /* Sample time of the velocity */
+  PS_SUB display_sub; /* Velocity shown on the seven-segment display */
+  PS_MSG* msg;
+#if PIPELINE_EN > 0
+  INT32S value;
+#else
+  PS_SUB velocity_sub;
+#endif
+  OS_FLAGS events;
+  INPUT_STATE inputs;
+  static INT16S no_velocity = 0;
+  INT16S* current_velocity = &no_velocity; /* Until the first message from VehicleTask */
+  INT16S target_velocity = 0;
 
   printf("Control Task created!\n");
+  ps_subscribe(&display_sub, &velocity_topic);
+#if PIPELINE_EN == 0
+  ps_subscribe(&velocity_sub, &velocity_topic);
+#endif
 
   while(1)
     {
-      OSSemPend(Control_Sem, 0, &err);
-      msg = OSMboxPend(Mbox_Velocity, 0, &err);
-      current_velocity = (INT16S*) msg;
+      events = OSFlagPend(Control_Flags, CONTROL_FLAG_PERIOD | CONTROL_FLAG_INPUT,
+                          OS_FLAG_WAIT_SET_ANY + OS_FLAG_CONSUME, 0, &err);
+      if (events & CONTROL_FLAG_PERIOD)
+        {
+          dm_start(control_dm);
+#if PIPELINE_EN > 0
+          if (pipe_get(&velocity_slot, &value, &stamp))
+            {
+              sampled_velocity = (INT16S) value;
+              current_velocity = &sampled_velocity;
+            }
+#else
+          msg = ps_read(&velocity_sub);
+          if (msg != NULL)
+            {
+              sampled_velocity = *PS_DATA(msg, INT16S);
+              current_velocity = &sampled_velocity;
+              stamp = msg->stamp;
+              ps_release(msg);
+            }
+#endif
+        }
+      inputs = input_state_snapshot();
+
       //GAS PEDAL CONTROL
-      handleGasPedal ();
+      handleGasPedal (inputs);
 
       //BRAKE PEDAL CONTROL
-  handleBrakePedal ();
+  handleBrakePedal (inputs);
 
   //GEAR CONTROL
-      handleTopGear ();
+      handleTopGear (inputs);
 
       //CRUISE CONTROL CONTROL
-      handleCruiseControl (current_velocity, target_velocity);
+      handleCruiseControl (inputs, current_velocity, &target_velocity);
 
   //ENGINE CONTROL
-      handleEngine (current_velocity, target_velocity, &throttle);
-      err = OSMboxPost (Mbox_Throttle, (void *) &throttle); //Post pointer to throttle
+      handleEngine (inputs, current_velocity, &target_velocity, &throttle,
+                    (events & CONTROL_FLAG_PERIOD) != 0);
+#if PIPELINE_EN > 0
+      pipe_put(&throttle_slot, throttle, stamp);
+#endif
+      msg = ps_alloc(&throttle_topic);
+      if (msg != NULL)
+        {
+          *PS_DATA(msg, INT8U) = throttle;
+          ps_publish(msg, stamp);
+        }
 
 
 
   //DISPLAY STUFF
+      msg = ps_read(&display_sub);
+      if (msg != NULL)
+        {
+          show_velocity_on_sevenseg((INT8S) (*PS_DATA(msg, INT16S) / 10));
+          ps_release(msg);
+        }
       draw_red_leds ();
       draw_green_leds ();
       if (cruising == on)
-      show_target_velocity ((INT16S) *target_velocity / 10);
+      show_target_velocity ((INT16S) target_velocity / 10);
       else
       show_target_velocity (0);
-      //err = OSMboxPost(Mbox_Throttle, (void *) &throttle);
-    }
-}
-
-/*
- * The task 'DetectionTask' keeps send the "OK" signal to the task 'WatchDogTask'periodically.
- * If the 'WatchDogTask' fails to receive the "OK" signal in a specific interval, then it indicates the system
- * is overloaded.
-*/
-
-void DetectionTask(void* pdata)
-{
-  INT8U err;
-  //void* msg;
-
-  printf("Detection Task created!\n");
-  char* ok_signal = "OK!";
+      disp_flush (); //ControlTask is the only writer of the display PIOs
 
-  while(1)
-    {
-      OSSemPend(Detection_Sem, 0, &err);
-      err = OSMboxPost(Mbox_Detection, (void *) &ok_signal);
+      if (events & CONTROL_FLAG_PERIOD)
+        dm_complete(control_dm);
     }
 }
 
 /*
- *  The task 'WatchDog' check the "OK" signal from DetectionTask periodically.
- *  If it can not retrieve the "OK signal from DetectionTask in a specific interval,
- *  then it indicates the system is overloaded.
+ *  The task 'WatchDog' checks the deadline monitor periodically. If any
+ *  periodic task missed a deadline since the last check, the system is
+ *  overloaded. The per-task details are printed by 'dm_report()' (KEY0).
+ *  The first miss also freezes the kernel trace, which then holds the
+ *  events that led to it (TRACE_DUMP_EN).
+ *  The task is released every CONTROL_PERIOD by the kernel, see
+ *  OSTaskCreatePeriodic().
  */
 void WatchDogTask(void* Data)
 {
-INT8U err;
-//void* pmsg;
+INT32U misses;
+INT32U last_misses = 0;
 printf("WatchDog Task created!\n");
 
 while(1)
 {
-OSSemPend(WatchDog_Sem, 0, &err);
-OSMboxPend(Mbox_Detection, CONTROL_PERIOD, &err); // Check mailbox
-//pmsg = OSMboxAccept(Mbox_Detection);
-if ( err == OS_ERR_TIMEOUT)
-//if ( pmsg == (void *)0)
+OSTimeDlyPeriod();
+misses = dm_misses_total();
+if (misses != last_misses)
+{
+tlm_write(TLM_SRC_WATCHDOG, 0, 0, 0, TLM_FLAG_OVERLOAD, 100-ExtraLoad_Percentage);
+#if TRACE_DUMP_EN > 0
+if (trace_armed)
 {
-printf(" System is overloaded! \n");
-printf(" The workload of the original system is %d percents. \n ", 100-ExtraLoad_Percentage);
+OSTraceStop();
+trace_armed = 0;
+trace_frozen = 1;
+}
+#endif
 }
 else
-printf(" System is OK! \n ");
+tlm_write(TLM_SRC_WATCHDOG, 0, 0, 0, 0, 100-ExtraLoad_Percentage);
+last_misses = misses;
 }
 
 }
 
 /*
  * The task 'ExtraLoad' impose an extra load to the system. By imposing extra load, it
- * may trigger a watchdog warning message. And we can learn about the load of the original system
+ * may trigger a watchdog warning message. And we can learn about the load of the original system.
+ * SW9-SW4 set the load in steps of 2% of CONTROL_PERIOD, burnt in CPU cycles. With SW17 on,
+ * the load is swept until the first deadline miss, which gives the breakdown utilization.
  */
 void ExtraLoadTask(void* Data)
 {
 INT8U err;
 printf("ExtraLoad Task created! \n");
 int switches_input, workload;
+INT16U load;
+INT8U sweeping = 0;
+INT32U period_cycles = LG_US_TO_CYCLES(CONTROL_PERIOD * 1000);
 while(1)
 {
 OSSemPend(ExtraLoad_Sem, 0, &err);
-switches_input = (switches_pressed() & 0x3f0) ;   //get the input value of SW9-SW4
-//if(switches_input > 0)
-//{
-extra_load = on;
-led_extraload = switches_input;
-//}
-
-workload = switches_input >> 3;
-if(workload >= 100)
+dm_start(extraload_dm);
+switches_input = switches_pressed();
+if (switches_input & LOAD_SWEEP_FLAG)
 {
-ExtraLoad_Percentage = 100;
-simulate_overload(CONTROL_PERIOD);
-//OSTimeDlyHMSM(0,0,0,CONTROL_PERIOD);
-}
-else
+if (!sweeping)
 {
-ExtraLoad_Percentage = workload;
-simulate_overload(CONTROL_PERIOD*(workload)/100);
-//OSTimeDlyHMSM(0,0,0,CONTROL_PERIOD*(workload)/100);
+lg_sweep_init(&load_sweep, dm_misses_total());
+sweeping = 1;
 }
+load = lg_sweep_next(&load_sweep, dm_misses_total(), OSCPUUsage);
+if (load_sweep.phase == LG_DONE && sweeping == 1)
+{
+sweep_finished = 1;
+sweeping = 2; //report once per sweep
 }
 }
-
-void ButtonIO (void* pdata)
+else
 {
-  INT8U err;
-
-while(1) {
-/*Read buttons pressed*/
-int keyPressed = buttons_pressed();
-
+sweeping = 0;
+workload = (switches_input & 0x3f0) >> 3;   //get the input value of SW9-SW4
+if (workload >= 100)
+workload = 100;
+load = workload * (LG_LOAD_MAX / 100);
+}
+extra_load = on;
+disp_red(LED_EXTRALOAD, switches_input);
 
-//READ BRAKE
-if ((keyPressed & BRAKE_PEDAL_FLAG) != 0)
-err = OSMboxPost(Mbox_Brake_Pedal, (void*) on);
-else
-err = OSMboxPost(Mbox_Brake_Pedal, (void*) off);
+ExtraLoad_Percentage = load / 10;
+lg_burn(lg_load_cycles(period_cycles, load));
+dm_complete(extraload_dm);
+}
+}
 
+/*
+ * Input handling: the keys and switches raise edge interrupts and are
+ * only read when they change. Changes are published as one input_state
+ * word and 'ControlTask' is released at once via CONTROL_FLAG_INPUT.
+ */
+#define INPUT_KEYS_MASK     (GAS_PEDAL_FLAG | BRAKE_PEDAL_FLAG | CRUISE_CONTROL_FLAG | REPORT_FLAG)
+#define INPUT_SWITCHES_MASK (TOP_GEAR_FLAG | ENGINE_FLAG)
 
-//READ GAS
-if ((keyPressed & GAS_PEDAL_FLAG) != 0)
-err = OSMboxPost(Mbox_Gas_Pedal, (void*) on);
-else
-err = OSMboxPost(Mbox_Gas_Pedal, (void*) off);
+static int input_keys = 0;      // Debounced state of the keys (pressed = 1)
+static int input_switches = 0;  // Debounced state of the switches
 
+/*
+ * Reads the keys and switches and publishes them if anything changed
+ */
+static void input_sample(void)
+{
+  INT8U err;
+  INT32U signals = 0;
+  int keys = buttons_pressed() & INPUT_KEYS_MASK;
+  int switches = switches_pressed() & INPUT_SWITCHES_MASK;
 
-//READ CRUISE CONTROL
-if ((keyPressed & CRUISE_CONTROL_FLAG) != 0)
-err = OSMboxPost(Mbox_Cruise_Control, (void*) on);
-else
-err = OSMboxPost(Mbox_Cruise_Control, (void*) off);
+  if (keys == input_keys && switches == input_switches)
+    return;
 
-OSSemPend(buttonSem, 0, &err); //Wait
-}
+  if (keys & ~input_keys & REPORT_FLAG)
+    {
+      report_requested = 1;
+#if TRACE_DUMP_EN > 0
+      trace_armed = 1;
+#endif
+    }
+  if (keys & GAS_PEDAL_FLAG)
+    signals |= INPUT_GAS_PEDAL;
+  if (keys & BRAKE_PEDAL_FLAG)
+    signals |= INPUT_BRAKE_PEDAL;
+  if (keys & CRUISE_CONTROL_FLAG)
+    signals |= INPUT_CRUISE_CONTROL;
+  if (switches & TOP_GEAR_FLAG)
+    signals |= INPUT_TOP_GEAR;
+  if (switches & ENGINE_FLAG)
+    signals |= INPUT_ENGINE;
+
+  input_keys = keys;
+  input_switches = switches;
+
+  input_state_publish(signals);
+  OSFlagPost(Control_Flags, CONTROL_FLAG_INPUT, OS_FLAG_SET, &err);
 }
 
-
-void SwitchIO (void* pdata)
+/*
+ * Clears the captured edges and unmasks the edge interrupts
+ */
+static void input_arm(void)
 {
-INT8U err;
+  IOWR_ALTERA_AVALON_PIO_EDGE_CAP(DE2_PIO_KEYS4_BASE, 0);
+  IOWR_ALTERA_AVALON_PIO_EDGE_CAP(DE2_PIO_TOGGLES18_BASE, 0);
+  IOWR_ALTERA_AVALON_PIO_IRQ_MASK(DE2_PIO_KEYS4_BASE, INPUT_KEYS_MASK);
+  IOWR_ALTERA_AVALON_PIO_IRQ_MASK(DE2_PIO_TOGGLES18_BASE, INPUT_SWITCHES_MASK);
+}
 
-while(1) {
-int switchPressed = switches_pressed();
+/*
+ * The task 'InputTask' sleeps until an edge interrupt arrives. The new
+ * state is taken at once (leading-edge debouncing), then the interrupts
+ * stay masked for INPUT_DEBOUNCE_TICKS and the settled state is read.
+ * KEYS4 only captures presses, so while a key is held its release is
+ * polled every INPUT_RELEASE_POLL_TICKS.
+ */
+void InputTask(void* pdata)
+{
+  INT8U err;
+  INT16U timeout;
 
+  printf("Input Task created!\n");
 
-//READ GEAR
-if ((switchPressed & TOP_GEAR_FLAG) != 0)
-err = OSMboxPost(Mbox_Gear, (void*) on);
-else
-err = OSMboxPost(Mbox_Gear, (void*) off);
+  input_arm();
+  input_sample();
 
+  while(1)
+    {
+      timeout = (input_keys != 0) ? INPUT_RELEASE_POLL_TICKS : 0;
+      OSSemPend(Input_Sem, timeout, &err);
+      if (err == OS_NO_ERR)
+        {
+          input_sample();
+          OSTimeDly(INPUT_DEBOUNCE_TICKS);
+          input_arm();
+        }
+      input_sample();
+    }
+}
 
-//READ ENGINE
-if ((switchPressed & ENGINE_FLAG) != 0)
-err = OSMboxPost(Mbox_Engine, (void*) on);
-else
-err = OSMboxPost(Mbox_Engine, (void*) off);
+/*
+ * Records the velocity and throttle messages published since the last
+ * call, the latest of each. aux counts the messages the subscriber skipped.
+ */
+static void telemetry_topics(PS_SUB* velocity_sub, PS_SUB* throttle_sub)
+{
+  static INT16S velocity = 0;
+  static INT8U throttle = 0;
+  INT32U last, skipped = 0;
+  PS_MSG* msg;
+  int fresh = 0;
+
+  last = velocity_sub->seq;
+  msg = ps_read(velocity_sub);
+  if (msg != NULL)
+    {
+      velocity = *PS_DATA(msg, INT16S);
+      if (last != 0)
+        skipped += msg->seq - last - 1;
+      ps_release(msg);
+      fresh = 1;
+    }
+  last = throttle_sub->seq;
+  msg = ps_read(throttle_sub);
+  if (msg != NULL)
+    {
+      throttle = *PS_DATA(msg, INT8U);
+      if (last != 0)
+        skipped += msg->seq - last - 1;
+      ps_release(msg);
+      fresh = 1;
+    }
+  if (fresh)
+    tlm_write(TLM_SRC_TOPICS, 0, velocity, throttle, 0, (INT16U) skipped);
+}
 
+/*
+ * The task 'TelemetryTask' ships the telemetry records over the JTAG UART.
+ * It runs at the lowest priority, so the blocking UART driver only uses
+ * idle time. It also subscribes to the velocity and throttle topics and
+ * records their messages. The deadline monitor and stack reports requested
+ * with KEY0, the CPU time report and the result of the load sweep are
+ * printed here as well, and the kernel trace frozen by WatchDogTask is
+ * dumped.
+ */
+void TelemetryTask(void* pdata)
+{
+  INT8U frames[8 * TLM_FRAME_MAX];
+  int len;
+  PS_SUB velocity_sub;
+  PS_SUB throttle_sub;
+#if CPU_REPORT_EN > 0
+  int cpu_report = 0;
+#endif
+
+  printf("Telemetry Task created!\n");
+  ps_subscribe(&velocity_sub, &velocity_topic);
+  ps_subscribe(&throttle_sub, &throttle_topic);
 
-OSSemPend(switchSem, 0, &err);
-}
+  while(1)
+    {
+      OSTimeDlyHMSM(0, 0, 0, TELEMETRY_PERIOD);
+      telemetry_topics(&velocity_sub, &throttle_sub);
+      fflush(stdout); // keep the remaining text output ahead of the frames
+      while ((len = tlm_drain(frames, sizeof(frames))) > 0)
+        write(STDOUT_FILENO, frames, len);
+      if (report_requested)
+        {
+          report_requested = 0;
+          dm_report();
+          pipe_report();
+          tp_report();
+          sr_report();
+        }
+#if CPU_REPORT_EN > 0
+      if (++cpu_report >= CPU_REPORT_PERIOD / TELEMETRY_PERIOD)
+        {
+          cpu_report = 0;
+          tp_report();
+        }
+#endif
+      if (sweep_finished)
+        {
+          sweep_finished = 0;
+          lg_sweep_report(&load_sweep);
+        }
+#if TRACE_DUMP_EN > 0
+      if (trace_frozen)
+        {
+          trace_frozen = 0;
+          fflush(stdout);
+          trc_dump(STDOUT_FILENO);
+        }
+#endif
+    }
 }
 
 /*
@@ -759,75 +940,67 @@ OSSemPend(switchSem, 0, &err);
 void StartTask(void* pdata)
 {
   INT8U err;
-  void* context;
 
-  static alt_alarm alarm;     /* Is needed for timer ISR function */
+  lg_calibrate();
 
-  /* Base resolution for SW timer : HW_TIMER_PERIOD ms */
-  delay = alt_ticks_per_second() * HW_TIMER_PERIOD / 1000;
-  printf("delay in ticks %d\n", delay);
+#if BENCHMARK_EN > 0
+  benchmark_run();
+#endif
 
   /*
    * Create Semaphores
    */
   Vehicle_Sem = OSSemCreate(0);
-  Control_Sem = OSSemCreate(0);
-  Detection_Sem = OSSemCreate(0);
-  WatchDog_Sem = OSSemCreate(0);
+  Actuate_Sem = OSSemCreate(0);
   ExtraLoad_Sem = OSSemCreate(0);
-  buttonSem = OSSemCreate(0);
-  switchSem = OSSemCreate(0);
+  Input_Sem = OSSemCreate(0);
+
+  // Names for the kernel trace
+  OSEventNameSet(Vehicle_Sem, (INT8U*) "Vehicle_Sem", &err);
+  OSEventNameSet(Actuate_Sem, (INT8U*) "Actuate_Sem", &err);
+  OSEventNameSet(ExtraLoad_Sem, (INT8U*) "ExtraLoad_Sem", &err);
+  OSEventNameSet(Input_Sem, (INT8U*) "Input_Sem", &err);
 
   /*
-   * Create Hardware Timer with a period of 'delay'
+   * Create Event Flags
    */
-  if (alt_alarm_start (&alarm,
-       delay,
-       alarm_handler,
-       context) < 0)
-    {
-      printf("No system clock available!n");
-    }
+  Control_Flags = OSFlagCreate(0, &err);
 
   /*
-   * Create and start Software Timer
+   * Register the periodic tasks with the deadline monitor, before their
+   * timers start. The deadline is the end of the period.
    */
-  WatchDog_Tmr = OSTmrCreate( 0, (CONTROL_PERIOD/100), OS_TMR_OPT_PERIODIC, WatchDog_Callback, NULL, "WatchDog_Task", &err);
-  if (err == OS_ERR_NONE) { printf("WatchDog Soft Timer created! \n"); }
-  OSTmrStart(WatchDog_Tmr, &err);
-  if (err == OS_ERR_NONE) { printf("WatchDog Soft Timer started! \n"); }
+  vehicle_dm = dm_register("Vehicle", VEHICLE_PERIOD * 1000, VEHICLE_PERIOD * 1000);
+  control_dm = dm_register("Control", CONTROL_PERIOD * 1000, CONTROL_PERIOD * 1000);
+  extraload_dm = dm_register("ExtraLoad", CONTROL_PERIOD * 1000, CONTROL_PERIOD * 1000);
 
-  Vehicle_Tmr = OSTmrCreate( 0, (VEHICLE_PERIOD/100), OS_TMR_OPT_PERIODIC, Vehicle_Callback, NULL, "Vehicle Task", &err);
+  /*
+   * Create and start Software Timer
+   */
+#if PIPELINE_EN > 0
+  if (pipe_start(VEHICLE_PERIOD, pipeline, sizeof(pipeline) / sizeof(pipeline[0])) == 0)
+    printf("Control pipeline started! \n");
+  else
+    printf("Control pipeline not started!\n");
+#else
+  Vehicle_Tmr = OSTmrCreate( 0, MS_TO_TMR_TICKS(VEHICLE_PERIOD), OS_TMR_OPT_PERIODIC, Vehicle_Callback, NULL, "Vehicle Task", &err);
   if (err == OS_ERR_NONE) { printf("Vehicle Soft Timer created! \n"); }
   OSTmrStart(Vehicle_Tmr, &err);
   if (err == OS_ERR_NONE) { printf("Vehicle Soft Timer started! \n"); }
 
-  Control_Tmr = OSTmrCreate( 0, (CONTROL_PERIOD/100), OS_TMR_OPT_PERIODIC, Control_Callback, NULL, "Control_Task", &err);
+  Control_Tmr = OSTmrCreate( 0, MS_TO_TMR_TICKS(CONTROL_PERIOD), OS_TMR_OPT_PERIODIC, Control_Callback, NULL, "Control_Task", &err);
   if (err == OS_ERR_NONE) { printf("Control Soft Timer created! \n"); }
   OSTmrStart(Control_Tmr, &err);
   if (err == OS_ERR_NONE) { printf("Control Soft Timer started! \n"); }
+#endif
 
 
 
-  buttonTmr = OSTmrCreate( 0, (BUTTON_PERIOD/100), OS_TMR_OPT_PERIODIC, makeAvailableButtonTask, NULL, "button timer", &err);
-  if (err == OS_ERR_NONE) { printf("button timer created! \n"); }
-  OSTmrStart(buttonTmr, &err);
-  if (err == OS_ERR_NONE) { printf("button timer started! \n"); }
-
-  switchTmr = OSTmrCreate( 0, (SWITCH_PERIOD/100), OS_TMR_OPT_PERIODIC, makeAvailableSwitchTask, NULL, "switch timer", &err);
-  if (err == OS_ERR_NONE) { printf("switch timer created! \n"); }
-  OSTmrStart( switchTmr, &err);
-  if (err == OS_ERR_NONE) { printf("switch timer started! \n"); }
-
-  ExtraLoad_Tmr = OSTmrCreate( 0, (CONTROL_PERIOD/100), OS_TMR_OPT_PERIODIC, ExtraLoad_Callback, NULL, "ExtraLoad_Task", &err);
+  ExtraLoad_Tmr = OSTmrCreate( 0, MS_TO_TMR_TICKS(CONTROL_PERIOD), OS_TMR_OPT_PERIODIC, ExtraLoad_Callback, NULL, "ExtraLoad_Task", &err);
   if (err == OS_ERR_NONE) { printf("ExtraLoad Soft Timer created! \n"); }
   OSTmrStart(ExtraLoad_Tmr, &err);
   if (err == OS_ERR_NONE) { printf("ExtraLoad Soft Timer started! \n"); }
 
-  Detection_Tmr = OSTmrCreate( 0, (CONTROL_PERIOD/100), OS_TMR_OPT_PERIODIC, Detection_Callback, NULL, "Detection_Task", &err);
-  if (err == OS_ERR_NONE) { printf("Detection Soft Timer created! \n"); }
-  OSTmrStart(Detection_Tmr, &err);
-  if (err == OS_ERR_NONE) { printf("Detection Soft Timer started! \n"); }
 
 
 
@@ -843,15 +1016,17 @@ void StartTask(void* pdata)
    * Creation of Kernel Objects
    */
 
-  // Mailboxes
-  Mbox_Throttle =   OSMboxCreate((void*) 0); /* Empty Mailbox - Throttle */
-  Mbox_Velocity =   OSMboxCreate((void*) 0); /* Empty Mailbox - Velocity */
-  Mbox_Detection =   OSMboxCreate((void*) 0); /* Empty Mailbox - Detection */
-  Mbox_Cruise_Control = OSMboxCreate ((void*) 0);
-  Mbox_Gas_Pedal = OSMboxCreate ((void*) 0);
-  Mbox_Brake_Pedal = OSMboxCreate ((void*) 0);
-  Mbox_Engine = OSMboxCreate ((void*) 0);
-  Mbox_Gear = OSMboxCreate ((void*) 0);
+  // Topics of VehicleTask and ControlTask
+  PS_TOPIC_INIT(&velocity_topic, velocity_storage, INT16S, "Velocity");
+  PS_TOPIC_INIT(&throttle_topic, throttle_storage, INT8U, "Throttle");
+
+  /*
+   * Edge capture interrupts of keys and switches, unmasked by InputTask
+   */
+  alt_ic_isr_register(DE2_PIO_KEYS4_IRQ_INTERRUPT_CONTROLLER_ID, DE2_PIO_KEYS4_IRQ,
+                      input_isr, (void*) DE2_PIO_KEYS4_BASE, NULL);
+  alt_ic_isr_register(DE2_PIO_TOGGLES18_IRQ_INTERRUPT_CONTROLLER_ID, DE2_PIO_TOGGLES18_IRQ,
+                      input_isr, (void*) DE2_PIO_TOGGLES18_BASE, NULL);
 
   /*
    * Create statistics task
@@ -864,28 +1039,15 @@ void StartTask(void* pdata)
    */
 
   err = OSTaskCreateExt(
-    ButtonIO, // Pointer to task code
-  NULL,        // Pointer to argument that is
-  // passed to task
-  &ButtonIOTask_Stack[TASK_STACKSIZE-1], // Pointer to top
-  // of task stack
-  BUTTONIOTASK_PRIO,
-  BUTTONIOTASK_PRIO,
-  (void *)&ButtonIOTask_Stack[0],
-  TASK_STACKSIZE,
-  (void *) 0,
-  OS_TASK_OPT_STK_CHK);
-
-  err = OSTaskCreateExt(
-    SwitchIO, // Pointer to task code
+    InputTask, // Pointer to task code
   NULL,        // Pointer to argument that is
   // passed to task
-  &SwitchIOTask_Stack[TASK_STACKSIZE-1], // Pointer to top
+  &InputTask_Stack[INPUTTASK_STACKSIZE-1], // Pointer to top
   // of task stack
-  SWITCHIOTASK_PRIO,
-  SWITCHIOTASK_PRIO,
-  (void *)&SwitchIOTask_Stack[0],
-  TASK_STACKSIZE,
+  INPUTTASK_PRIO,
+  INPUTTASK_PRIO,
+  (void *)&InputTask_Stack[0],
+  INPUTTASK_STACKSIZE,
   (void *) 0,
   OS_TASK_OPT_STK_CHK);
 
@@ -893,12 +1055,12 @@ void StartTask(void* pdata)
 ControlTask, // Pointer to task code
 NULL,        // Pointer to argument that is
                 // passed to task
-&ControlTask_Stack[TASK_STACKSIZE-1], // Pointer to top
+&ControlTask_Stack[CONTROLTASK_STACKSIZE-1], // Pointer to top
 // of task stack
 CONTROLTASK_PRIO,
 CONTROLTASK_PRIO,
 (void *)&ControlTask_Stack[0],
-TASK_STACKSIZE,
+CONTROLTASK_STACKSIZE,
 (void *) 0,
 OS_TASK_OPT_STK_CHK);
 
@@ -906,12 +1068,12 @@ OS_TASK_OPT_STK_CHK);
 VehicleTask, // Pointer to task code
 NULL,        // Pointer to argument that is
                 // passed to task
-&VehicleTask_Stack[TASK_STACKSIZE-1], // Pointer to top
+&VehicleTask_Stack[VEHICLETASK_STACKSIZE-1], // Pointer to top
 // of task stack
 VEHICLETASK_PRIO,
 VEHICLETASK_PRIO,
 (void *)&VehicleTask_Stack[0],
-TASK_STACKSIZE,
+VEHICLETASK_STACKSIZE,
 (void *) 0,
 OS_TASK_OPT_STK_CHK);
 
@@ -919,69 +1081,53 @@ OS_TASK_OPT_STK_CHK);
 ExtraLoadTask, // Pointer to task code
 NULL,        // Pointer to argument that is
                 // passed to task
-&ExtraLoadTask_Stack[TASK_STACKSIZE-1], // Pointer to top
+&ExtraLoadTask_Stack[EXTRALOADTASK_STACKSIZE-1], // Pointer to top
 // of task stack
 EXTRALOADTASK_PRIO,
 EXTRALOADTASK_PRIO,
 (void *)&ExtraLoadTask_Stack[0],
-TASK_STACKSIZE,
+EXTRALOADTASK_STACKSIZE,
 (void *) 0,
 OS_TASK_OPT_STK_CHK);
 
-  err = OSTaskCreateExt(
+  err = OSTaskCreatePeriodic(
   WatchDogTask, // Pointer to task code
 NULL,        // Pointer to argument that is
                 // passed to task
-&WatchDogTask_Stack[TASK_STACKSIZE-1], // Pointer to top
+&WatchDogTask_Stack[WATCHDOGTASK_STACKSIZE-1], // Pointer to top
 // of task stack
 WATCHDOGTASK_PRIO,
 WATCHDOGTASK_PRIO,
 (void *)&WatchDogTask_Stack[0],
-TASK_STACKSIZE,
+WATCHDOGTASK_STACKSIZE,
 (void *) 0,
-OS_TASK_OPT_STK_CHK);
+OS_TASK_OPT_STK_CHK,
+MS_TO_OS_TICKS(CONTROL_PERIOD), // Period
+MS_TO_OS_TICKS(CONTROL_PERIOD), // First release
+0);                             // Deadline at the end of the period
 
   err = OSTaskCreateExt(
-DetectionTask, // Pointer to task code
+TelemetryTask, // Pointer to task code
 NULL,        // Pointer to argument that is
                 // passed to task
-&DetectionTask_Stack[TASK_STACKSIZE-1], // Pointer to top
+&TelemetryTask_Stack[TELEMETRYTASK_STACKSIZE-1], // Pointer to top
 // of task stack
-DETECTIONTASK_PRIO,
-DETECTIONTASK_PRIO,
-(void *)&DetectionTask_Stack[0],
-TASK_STACKSIZE,
+TELEMETRYTASK_PRIO,
+TELEMETRYTASK_PRIO,
+(void *)&TelemetryTask_Stack[0],
+TELEMETRYTASK_STACKSIZE,
 (void *) 0,
 OS_TASK_OPT_STK_CHK);
 
-  err = OSTaskCreateExt(
-    ButtonIO, // Pointer to task code
-  NULL,        // Pointer to argument that is
-  // passed to task
-  &ButtonIOTask_Stack[TASK_STACKSIZE-1], // Pointer to top
-  // of task stack
-  BUTTONIOTASK_PRIO,
-  BUTTONIOTASK_PRIO,
-  (void *)&ButtonIOTask_Stack[0],
-  TASK_STACKSIZE,
-  (void *) 0,
-  OS_TASK_OPT_STK_CHK);
-
-  err = OSTaskCreateExt(
-    SwitchIO, // Pointer to task code
-  NULL,        // Pointer to argument that is
-  // passed to task
-  &SwitchIOTask_Stack[TASK_STACKSIZE-1], // Pointer to top
-  // of task stack
-  SWITCHIOTASK_PRIO,
-  SWITCHIOTASK_PRIO,
-  (void *)&SwitchIOTask_Stack[0],
-  TASK_STACKSIZE,
-  (void *) 0,
-  OS_TASK_OPT_STK_CHK);
-
-
-
+  /*
+   * Task names for the CPU time report
+   */
+  OSTaskNameSet(INPUTTASK_PRIO, (INT8U*) "Input", &err);
+  OSTaskNameSet(CONTROLTASK_PRIO, (INT8U*) "Control", &err);
+  OSTaskNameSet(VEHICLETASK_PRIO, (INT8U*) "Vehicle", &err);
+  OSTaskNameSet(EXTRALOADTASK_PRIO, (INT8U*) "ExtraLoad", &err);
+  OSTaskNameSet(WATCHDOGTASK_PRIO, (INT8U*) "WatchDog", &err);
+  OSTaskNameSet(TELEMETRYTASK_PRIO, (INT8U*) "Telemetry", &err);
 
   printf("All Tasks and Kernel Objects generated!\n");
 
@@ -1001,16 +1147,18 @@ int main(void) {
 
   printf("Lab: Cruise Control\n");
   printf("Alt_ticks_per_second: %d. \n",alt_ticks_per_second());
+  if (OS_TS_START() < 0)
+    printf("No timestamp device available!\n");
   OSTaskCreateExt(
   StartTask, // Pointer to task code
   NULL,      // Pointer to argument that is
   // passed to task
-  (void *)&StartTask_Stack[TASK_STACKSIZE-1], // Pointer to top
+  (void *)&StartTask_Stack[STARTTASK_STACKSIZE-1], // Pointer to top
   // of task stack
   STARTTASK_PRIO,
   STARTTASK_PRIO,
   (void *)&StartTask_Stack[0],
-  TASK_STACKSIZE,
+  STARTTASK_STACKSIZE,
   (void *) 0,
   OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);
 
@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include "system.h"
+#include "sys/alt_alarm.h"
+#include "sys/alt_timestamp.h"
+#include "pipeline.h"
+
+#define PIPE_CYCLES_PER_US (ALT_CPU_FREQ / 1000000)
+
+static alt_alarm pipe_alarm;
+static const PIPE_STAGE* pipe_stages;
+static INT32U pipe_phase[PIPE_MAX_STAGES];  /* Phases in system ticks */
+static INT32U pipe_period;
+static INT8U  pipe_count;
+static INT8U  pipe_next;
+static volatile INT32U pipe_cycles = 0;
+
+/* Latency statistics in cycles */
+static INT32U pipe_lat_count = 0;
+static INT32U pipe_lat_best = 0xFFFFFFFF;
+static INT32U pipe_lat_worst = 0;
+static alt_u64 pipe_lat_total = 0;
+
+/*
+ * Alarm callback: releases all stages of the current phase and returns
+ * the ticks until the next phase
+ */
+static alt_u32 pipe_release(void* context)
+{
+  INT32U phase = pipe_phase[pipe_next];
+
+  if (pipe_next == 0)
+    pipe_cycles++;
+
+  while (pipe_next < pipe_count && pipe_phase[pipe_next] == phase)
+    pipe_stages[pipe_next++].release();
+
+  if (pipe_next == pipe_count) {
+    pipe_next = 0;
+    return pipe_period - phase + pipe_phase[0];
+  }
+
+  return pipe_phase[pipe_next] - phase;
+}
+
+/*
+ * The function 'pipe_start()' starts the pipeline. The stages must be
+ * sorted by phase and the phases must be below the period; stages with
+ * the same phase are released in the order of the array. The first
+ * release is one period from now. Returns 0 on success.
+ */
+INT8U pipe_start(INT16U period_ms, const PIPE_STAGE* stages, INT8U count)
+{
+  INT32U ticks_per_second = alt_ticks_per_second();
+  INT8U i;
+
+  if (count == 0 || count > PIPE_MAX_STAGES || period_ms == 0)
+    return 1;
+
+  pipe_period = ticks_per_second * period_ms / 1000;
+  for (i = 0; i < count; i++) {
+    pipe_phase[i] = ticks_per_second * stages[i].phase / 1000;
+    if (pipe_phase[i] >= pipe_period || (i > 0 && pipe_phase[i] < pipe_phase[i - 1]))
+      return 1;
+  }
+
+  pipe_stages = stages;
+  pipe_count = count;
+  pipe_next = 0;
+
+  if (alt_alarm_start(&pipe_alarm, pipe_period + pipe_phase[0], pipe_release, NULL) < 0)
+    return 1;
+
+  return 0;
+}
+
+/*
+ * Number of the current pipeline period, counted at the first stage
+ */
+INT32U pipe_cycle(void)
+{
+  return pipe_cycles;
+}
+
+void pipe_put(PIPE_SLOT* slot, INT32S value, INT32U stamp)
+{
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  slot->value = value;
+  slot->stamp = stamp;
+  slot->cycle = pipe_cycles;
+  OS_EXIT_CRITICAL();
+}
+
+/*
+ * The function 'pipe_get()' reads a slot. Returns 1 if the slot was
+ * written in the current period, 0 if the value is stale.
+ */
+INT8U pipe_get(PIPE_SLOT* slot, INT32S* value, INT32U* stamp)
+{
+  INT8U fresh;
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  *value = slot->value;
+  *stamp = slot->stamp;
+  fresh = (slot->cycle == pipe_cycles);
+  OS_EXIT_CRITICAL();
+
+  return fresh;
+}
+
+/*
+ * Accounts the latency from the sample taken at 'stamp' to now, called
+ * where the value derived from the sample is applied
+ */
+void pipe_latency(INT32U stamp)
+{
+  INT32U latency = alt_timestamp() - stamp;
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  pipe_lat_count++;
+  pipe_lat_total += latency;
+  if (latency < pipe_lat_best)
+    pipe_lat_best = latency;
+  if (latency > pipe_lat_worst)
+    pipe_lat_worst = latency;
+  OS_EXIT_CRITICAL();
+}
+
+void pipe_report(void)
+{
+  if (pipe_lat_count == 0) {
+    printf("Sample-to-actuation latency: no samples\n");
+    return;
+  }
+
+  printf("Sample-to-actuation latency (us): best %lu, avg %lu, worst %lu (%lu samples)\n",
+         pipe_lat_best / PIPE_CYCLES_PER_US,
+         (INT32U) (pipe_lat_total / pipe_lat_count) / PIPE_CYCLES_PER_US,
+         pipe_lat_worst / PIPE_CYCLES_PER_US, pipe_lat_count);
+}
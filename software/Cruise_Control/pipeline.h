@@ -0,0 +1,43 @@
+/*
+ * Phase-aligned pipeline of periodic stages.
+ *
+ * One HAL alarm releases all stages of the pipeline: each stage has a
+ * phase offset in ms inside the common period and a release callback,
+ * called from the system clock ISR like the soft timer callbacks. The
+ * stages hand their data over in PIPE_SLOTs, single-word slots tagged
+ * with the pipeline period they were written in, so a consumer sees at
+ * once whether the producer made it in time. No kernel call is needed
+ * for the hand-off.
+ *
+ * Each slot also carries the timestamp of the sensor sample its value
+ * derives from. 'pipe_latency()' accounts sample-to-actuation latency in
+ * TIMER_1 cycles for 'pipe_report()'.
+ */
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include "includes.h"
+
+#define PIPE_MAX_STAGES  4
+
+typedef struct {
+  INT16U phase;               /* ms after the start of the period */
+  void   (*release)(void);    /* Called from the system clock ISR */
+} PIPE_STAGE;
+
+typedef struct {
+  INT32U cycle;               /* Pipeline period of the last write */
+  INT32S value;
+  INT32U stamp;               /* alt_timestamp() of the source sample */
+} PIPE_SLOT;
+
+INT8U  pipe_start(INT16U period_ms, const PIPE_STAGE* stages, INT8U count);
+INT32U pipe_cycle(void);
+void   pipe_put(PIPE_SLOT* slot, INT32S value, INT32U stamp);
+INT8U  pipe_get(PIPE_SLOT* slot, INT32S* value, INT32U* stamp);
+
+void   pipe_latency(INT32U stamp);
+void   pipe_report(void);
+
+#endif /* PIPELINE_H_ */
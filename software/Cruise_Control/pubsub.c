@@ -0,0 +1,117 @@
+#include "pubsub.h"
+
+/*
+ * Drops one reference, the buffer goes back to the partition with the
+ * last one
+ */
+static void ps_unref(PS_MSG* msg)
+{
+  INT16U refs;
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  refs = --msg->refs;
+  OS_EXIT_CRITICAL();
+  if (refs == 0)
+    OSMemPut(msg->topic->mem, msg);
+}
+
+/*
+ * The function 'ps_topic_init()' creates the partition of a topic on
+ * 'storage', 'buffers' blocks of 'buffer_size' bytes (use PS_TOPIC_INIT()).
+ * Returns the error of OSMemCreate(), OS_ERR_NONE on success.
+ */
+INT8U ps_topic_init(PS_TOPIC* topic, void* storage, INT16U buffers,
+                    INT16U buffer_size, const char* name)
+{
+  INT8U err;
+
+  topic->latest = NULL;
+  topic->seq = 0;
+  topic->drops = 0;
+  topic->mem = OSMemCreate(storage, buffers, buffer_size, &err);
+  if (err == OS_ERR_NONE)
+    OSMemNameSet(topic->mem, (INT8U*) name, &err);
+  return err;
+}
+
+/*
+ * The function 'ps_alloc()' returns a free buffer of the topic for the
+ * producer, or NULL if all buffers are in use.
+ */
+PS_MSG* ps_alloc(PS_TOPIC* topic)
+{
+  PS_MSG* msg;
+  INT8U err;
+
+  msg = OSMemGet(topic->mem, &err);
+  if (msg == NULL) {
+    topic->drops++;
+    return NULL;
+  }
+  msg->topic = topic;
+  return msg;
+}
+
+/*
+ * The function 'ps_publish()' makes 'msg', filled after 'ps_alloc()', the
+ * latest message of its topic. 'stamp' is the time of the sample it
+ * derives from. The producer must not touch the buffer afterwards.
+ */
+void ps_publish(PS_MSG* msg, INT32U stamp)
+{
+  PS_TOPIC* topic = msg->topic;
+  PS_MSG* old;
+  OS_CPU_SR cpu_sr;
+
+  msg->stamp = stamp;
+  msg->refs = 1;
+  OS_ENTER_CRITICAL();
+  msg->seq = ++topic->seq;
+  old = topic->latest;
+  topic->latest = msg;
+  OS_EXIT_CRITICAL();
+  if (old != NULL)
+    ps_unref(old);
+}
+
+/*
+ * The function 'ps_subscribe()' attaches 'sub' to 'topic'. The first
+ * 'ps_read()' returns the latest message, if any.
+ */
+void ps_subscribe(PS_SUB* sub, PS_TOPIC* topic)
+{
+  sub->topic = topic;
+  sub->seq = 0;
+}
+
+/*
+ * The function 'ps_read()' returns the latest message of the topic if it
+ * is newer than the last one 'sub' read, else NULL. The caller holds a
+ * reference until 'ps_release()' and reads the payload with PS_DATA().
+ */
+PS_MSG* ps_read(PS_SUB* sub)
+{
+  PS_TOPIC* topic = sub->topic;
+  PS_MSG* msg;
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  msg = topic->latest;
+  if (msg == NULL || msg->seq == sub->seq) {
+    OS_EXIT_CRITICAL();
+    return NULL;
+  }
+  msg->refs++;
+  OS_EXIT_CRITICAL();
+  sub->seq = msg->seq;
+  return msg;
+}
+
+/*
+ * The function 'ps_release()' drops the reference taken by 'ps_read()'
+ */
+void ps_release(PS_MSG* msg)
+{
+  ps_unref(msg);
+}
@@ -0,0 +1,68 @@
+/*
+ * Publish/subscribe of fixed-size messages in OS_MEM partitions.
+ *
+ * A topic owns a partition of message buffers. The producer takes a free
+ * buffer with 'ps_alloc()', writes the payload in place and hands it to
+ * the topic with 'ps_publish()', which makes it the latest message. Any
+ * number of subscribers take a reference to the latest message with
+ * 'ps_read()' and drop it with 'ps_release()'; the buffer returns to the
+ * partition with the last reference. Nothing is copied, and no call
+ * depends on the number of subscribers.
+ *
+ * A topic holds the latest message only. A subscriber that reads less
+ * often than the producer publishes skips the older messages, which is
+ * what the periodic control loop wants from a sample.
+ *
+ * Each buffer starts with a PS_MSG header, PS_DATA() returns the payload.
+ * PS_STORAGE() declares the buffers of a topic: one being written, the
+ * latest, and one held by each subscriber.
+ */
+
+#ifndef PUBSUB_H_
+#define PUBSUB_H_
+
+#include "includes.h"
+
+typedef struct ps_msg PS_MSG;
+
+typedef struct {
+  OS_MEM* mem;
+  PS_MSG* latest;     /* NULL before the first publish */
+  INT32U  seq;        /* Messages published            */
+  INT32U  drops;      /* ps_alloc() found no buffer    */
+} PS_TOPIC;
+
+struct ps_msg {
+  PS_TOPIC* topic;
+  INT32U    seq;
+  INT32U    stamp;    /* alt_timestamp() of the source sample */
+  INT16U    refs;     /* The topic while latest, readers      */
+};
+
+typedef struct {
+  PS_TOPIC* topic;
+  INT32U    seq;      /* Last message read */
+} PS_SUB;
+
+#define PS_HEADER_SIZE          ((sizeof(PS_MSG) + 7) & ~7)
+#define PS_BUFFER_SIZE(type)    (PS_HEADER_SIZE + ((sizeof(type) + 3) & ~3))
+#define PS_BUFFERS(subscribers) ((subscribers) + 2)
+
+#define PS_STORAGE(name, type, subscribers) \
+  INT32U name[PS_BUFFERS(subscribers)][PS_BUFFER_SIZE(type) / 4]
+
+#define PS_TOPIC_INIT(topic, storage, type, name) \
+  ps_topic_init((topic), (storage), sizeof(storage) / PS_BUFFER_SIZE(type), \
+                PS_BUFFER_SIZE(type), (name))
+
+#define PS_DATA(msg, type)      ((type*) ((INT8U*) (msg) + PS_HEADER_SIZE))
+
+INT8U   ps_topic_init(PS_TOPIC* topic, void* storage, INT16U buffers,
+                      INT16U buffer_size, const char* name);
+PS_MSG* ps_alloc(PS_TOPIC* topic);
+void    ps_publish(PS_MSG* msg, INT32U stamp);
+void    ps_subscribe(PS_SUB* sub, PS_TOPIC* topic);
+PS_MSG* ps_read(PS_SUB* sub);
+void    ps_release(PS_MSG* msg);
+
+#endif /* PUBSUB_H_ */
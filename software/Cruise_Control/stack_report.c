@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <ctype.h>
+#include "stack_report.h"
+
+/*
+ * The function 'sr_recommend()' returns the stack size in elements for a
+ * watermark of 'used' elements, 0 if nothing is known yet
+ */
+INT32U sr_recommend(INT32U used)
+{
+  INT32U size;
+
+  if (used == 0)
+    return 0;
+  size = used + used * SR_MARGIN_PCT / 100 + SR_HEADROOM;
+  return (size + SR_ROUND - 1) / SR_ROUND * SR_ROUND;
+}
+
+/*
+ * The function 'sr_query()' returns the stack watermark of the task at
+ * 'prio'. OS_ERR_TASK_OPT if the stack of the task is not checked, and
+ * OS_ERR_TASK_NOT_EXIST at the home priority of a task raised by a mutex.
+ */
+INT8U sr_query(INT8U prio, SR_STATS* stats)
+{
+  OS_TCB* tcb;
+  OS_CPU_SR cpu_sr;
+
+  if (prio > OS_LOWEST_PRIO)
+    return OS_ERR_PRIO_INVALID;
+
+  OS_ENTER_CRITICAL();
+  tcb = OSTCBPrioTbl[prio];
+  if (tcb == (OS_TCB*) 0 || tcb == OS_TCB_RESERVED || tcb->OSTCBPrio != prio) {
+    OS_EXIT_CRITICAL();
+    return OS_ERR_TASK_NOT_EXIST;
+  }
+  if ((tcb->OSTCBOpt & OS_TASK_OPT_STK_CHK) == 0) {
+    OS_EXIT_CRITICAL();
+    return OS_ERR_TASK_OPT;
+  }
+  stats->name = (const char*) tcb->OSTCBTaskName;
+  stats->size = tcb->OSTCBStkSize;
+  stats->used = tcb->OSTCBStkUsed / sizeof(OS_STK);
+  OS_EXIT_CRITICAL();
+
+  stats->recommended = sr_recommend(stats->used);
+  return OS_ERR_NONE;
+}
+
+/*
+ * Prints the #define of the stack size of the task at 'prio': the BSP
+ * setting for the kernel tasks, <NAME>TASK_STACKSIZE of main.c for the
+ * application tasks
+ */
+static void sr_print_define(INT8U prio, const SR_STATS* s)
+{
+  const char* c;
+
+  if (prio == OS_TASK_IDLE_PRIO)
+    printf("#define OS_TASK_IDLE_STK_SIZE");
+#if OS_TASK_STAT_EN > 0
+  else if (prio == OS_TASK_STAT_PRIO)
+    printf("#define OS_TASK_STAT_STK_SIZE");
+#endif
+#if OS_TMR_EN > 0
+  else if (prio == OS_TASK_TMR_PRIO)
+    printf("#define OS_TASK_TMR_STK_SIZE");
+#endif
+#if OS_DEFER_EN > 0
+  else if (prio == OS_TASK_DEFER_PRIO)
+    printf("#define OS_TASK_DEFER_STK_SIZE");
+#endif
+  else {
+    printf("#define ");
+    for (c = s->name; *c != '\0'; c++)
+      if (isalnum((unsigned char) *c))
+        putchar(toupper((unsigned char) *c));
+    printf("TASK_STACKSIZE");
+  }
+  printf(" %lu\n", s->recommended);
+}
+
+/*
+ * The function 'sr_report()' prints the stack use of each task, the
+ * recommended sizes and their #define lines. It calls printf, so it
+ * should run in a low priority task.
+ */
+void sr_report(void)
+{
+  SR_STATS s;
+  INT32U size = 0, recommended = 0;
+  int pending = 0;
+  INT8U i;
+
+  printf("--Stack Report-- (elements of %u bytes)\n", (unsigned) sizeof(OS_STK));
+  printf("%-4s %-16s %6s %6s %5s %6s\n", "Prio", "Task", "Size", "Used", "Peak", "Recomm");
+  for (i = 0; i <= OS_LOWEST_PRIO; i++) {
+    if (sr_query(i, &s) != OS_ERR_NONE)
+      continue;
+    size += s.size;
+    if (s.used == 0) {
+      pending = 1;
+      printf("%4d %-16s %6lu %6s\n", i, s.name, s.size, "-");
+      continue;
+    }
+    recommended += s.recommended;
+    printf("%4d %-16s %6lu %6lu %4lu%% %6lu\n", i, s.name, s.size, s.used,
+           s.used * 100 / s.size, s.recommended);
+  }
+  printf("%-21s %6lu %19lu\n", "Total", size, recommended);
+  if (pending)
+    printf("(-: the first sweep of the stack has not finished)\n");
+
+  for (i = 0; i <= OS_LOWEST_PRIO; i++)
+    if (sr_query(i, &s) == OS_ERR_NONE && s.used > 0)
+      sr_print_define(i, &s);
+}
@@ -0,0 +1,39 @@
+/*
+ * Stack watermarks and stack sizes recommended from them.
+ *
+ * The statistics task keeps the deepest use of each task stack in the
+ * OSTCBStkUsed field of its TCB, checking OS_TASK_STAT_STK_SCAN elements
+ * of each stack every 100 ms (see OS_TaskStatStkChk()). 'sr_query()'
+ * returns the watermark of a task and the size it should get: the use
+ * plus SR_MARGIN_PCT percent and SR_HEADROOM elements, rounded up to
+ * SR_ROUND elements. The interrupts run on the stack of the interrupted
+ * task, the headroom covers a handler entered at the deepest point.
+ *
+ * 'sr_report()' prints the table followed by the #define lines to paste
+ * into main.c and the sizes of the kernel tasks for the BSP settings.
+ * A watermark only covers the paths the task has run, so take the report
+ * after exercising every mode: cruise control, the load sweep and the
+ * reports.
+ */
+
+#ifndef STACK_REPORT_H_
+#define STACK_REPORT_H_
+
+#include "includes.h"
+
+#define SR_MARGIN_PCT   25
+#define SR_HEADROOM     64    /* Elements, HAL interrupt frame and handler calls */
+#define SR_ROUND        32    /* Elements */
+
+typedef struct {
+  const char* name;       /* Task name */
+  INT32U size;            /* Stack elements */
+  INT32U used;            /* Deepest use in elements, 0 until the first sweep found it */
+  INT32U recommended;     /* Stack elements to give the task, 0 with 'used' */
+} SR_STATS;
+
+INT32U sr_recommend(INT32U used);
+INT8U  sr_query(INT8U prio, SR_STATS* stats);
+void   sr_report(void);
+
+#endif /* STACK_REPORT_H_ */
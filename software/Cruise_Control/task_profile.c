@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include "system.h"
+#include "sys/alt_timestamp.h"
+#include "task_profile.h"
+
+#define TP_CYCLES_PER_MS (alt_timestamp_freq() / 1000)
+#define TP_SHIFT         10   /* (2^32 >> TP_SHIFT) * 1000 fits in 32 bits */
+
+typedef struct {
+  OS_TCB* tcb;              /* TCB if in use at the last sample, a new task starts from 0 */
+  INT32U  last;             /* Counter at the last sample */
+  INT32U  window;           /* Cycles between the last two samples */
+} TP_ENTRY;
+
+static TP_ENTRY tp_tasks[OS_MAX_TASKS + OS_N_SYS_TASKS];   /* Indexed like OSTCBTbl[] */
+static TP_ENTRY tp_irqs[ALT_NIRQ];
+static INT32U   tp_stamp = 0;     /* Timestamp of the last sample */
+static INT32U   tp_length = 0;    /* Length of the last window */
+
+static INT16U tp_permille(INT32U cycles)
+{
+  if (tp_length >> TP_SHIFT == 0)
+    return 0;
+  return (INT16U) ((cycles >> TP_SHIFT) * 1000 / (tp_length >> TP_SHIFT));
+}
+
+/*
+ * The function 'tp_sample()' ends the current window. The counters are
+ * read with the interrupts disabled, so the shares of a window add up.
+ * The windows are kept per TCB, a task keeps its window when a mutex
+ * raises it to another priority.
+ */
+void tp_sample(void)
+{
+  OS_TCB* tcb;
+  TP_ENTRY* e;
+  INT32U now;
+  INT8U i;
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  now = alt_timestamp();
+  for (i = 0; i < OS_MAX_TASKS + OS_N_SYS_TASKS; i++) {
+    tcb = &OSTCBTbl[i];
+    e = &tp_tasks[i];
+    if (tcb->OSTCBPrio > OS_LOWEST_PRIO || OSTCBPrioTbl[tcb->OSTCBPrio] != tcb) {
+      e->tcb = (OS_TCB*) 0;   /* Free TCB */
+      e->window = 0;
+      continue;
+    }
+    if (tcb != e->tcb) {
+      e->tcb = tcb;
+      e->last = 0;
+    }
+    e->window = tcb->OSTCBCyclesTot - e->last;
+    e->last = tcb->OSTCBCyclesTot;
+  }
+  for (i = 0; i < ALT_NIRQ; i++) {
+    e = &tp_irqs[i];
+    e->window = OSIntCycles[i] - e->last;
+    e->last = OSIntCycles[i];
+  }
+  tp_length = now - tp_stamp;
+  tp_stamp = now;
+  OS_EXIT_CRITICAL();
+}
+
+/*
+ * Length of the last window in cycles
+ */
+INT32U tp_window_cycles(void)
+{
+  return tp_length;
+}
+
+/*
+ * The function 'tp_query()' returns the CPU time of the task at 'prio'.
+ * OS_ERR_TASK_NOT_EXIST for the home priority of a task that a mutex
+ * raised, the task is found at the raised one.
+ */
+INT8U tp_query(INT8U prio, TP_STATS* stats)
+{
+  OS_TCB* tcb;
+  TP_ENTRY* e;
+  OS_CPU_SR cpu_sr;
+
+  if (prio > OS_LOWEST_PRIO)
+    return OS_ERR_PRIO_INVALID;
+
+  OS_ENTER_CRITICAL();
+  tcb = OSTCBPrioTbl[prio];
+  if (tcb == (OS_TCB*) 0 || tcb == OS_TCB_RESERVED || tcb->OSTCBPrio != prio) {
+    OS_EXIT_CRITICAL();
+    return OS_ERR_TASK_NOT_EXIST;
+  }
+  e = &tp_tasks[tcb - OSTCBTbl];
+  stats->name = (const char*) tcb->OSTCBTaskName;
+  stats->cycles = tcb->OSTCBCyclesTot;
+  stats->switches = tcb->OSTCBCtxSwCtr;
+  stats->calls = 0;
+  stats->max = 0;
+  stats->window = (tcb == e->tcb) ? e->window : 0;
+  OS_EXIT_CRITICAL();
+
+  stats->permille = tp_permille(stats->window);
+  return OS_ERR_NONE;
+}
+
+/*
+ * The function 'tp_query_irq()' returns the CPU time of the handler of
+ * interrupt 'irq'.
+ */
+INT8U tp_query_irq(INT8U irq, TP_STATS* stats)
+{
+  OS_CPU_SR cpu_sr;
+
+  if (irq >= ALT_NIRQ)
+    return OS_ERR_PRIO_INVALID;
+
+  OS_ENTER_CRITICAL();
+  stats->name = NULL;
+  stats->cycles = OSIntCycles[irq];
+  stats->switches = 0;
+  stats->calls = OSIntCtr[irq];
+  stats->max = OSIntCyclesMax[irq];
+  stats->window = tp_irqs[irq].window;
+  OS_EXIT_CRITICAL();
+
+  stats->permille = tp_permille(stats->window);
+  return OS_ERR_NONE;
+}
+
+#if OS_CPU_UTIL_EN > 0
+static void tp_print_util(const char* window, INT16U util, INT16U peak)
+{
+  printf("CPU used over %-6s %3u.%02u%%, peak %3u.%02u%%\n", window,
+         util / 100, util % 100, peak / 100, peak % 100);
+}
+#endif
+
+/*
+ * The function 'tp_report()' ends the window and prints the share of
+ * each task and interrupt handler that ran in it. The count is the number
+ * of context switches to a task and of calls of a handler, whose longest
+ * call is shown in the name column, followed by the CPU utilization of
+ * the kernel (OSCPUUtilQuery()). It calls printf,
+ * so it should run in a low priority task.
+ */
+void tp_report(void)
+{
+#if OS_CPU_UTIL_EN > 0
+  OS_CPU_UTIL_DATA util;
+#endif
+  TP_STATS s;
+  INT32U total = 0;
+  INT8U i;
+
+  tp_sample();
+  printf("--CPU Time Report-- (last %lu ms)\n", tp_length / TP_CYCLES_PER_MS);
+  printf("%-4s %-16s %10s %6s %7s\n", "Prio", "Task", "Cycles", "Share", "Count");
+  for (i = 0; i <= OS_LOWEST_PRIO; i++) {
+    if (tp_query(i, &s) != OS_ERR_NONE)
+      continue;
+    total += s.window;
+    printf("%4d %-16s %10lu %4u.%u%% %7lu\n", i, s.name, s.window,
+           s.permille / 10, s.permille % 10, s.switches);
+  }
+  for (i = 0; i < ALT_NIRQ; i++) {
+    tp_query_irq(i, &s);
+    if (s.window == 0)
+      continue;
+    total += s.window;
+    printf("IRQ%-2d max %-11lu %10lu %4u.%u%% %7lu\n", i, s.max, s.window,
+           s.permille / 10, s.permille % 10, s.calls);
+  }
+  printf("%-21s %10lu %5u%%\n", "Accounted", total, tp_permille(total) / 10);
+#if OS_CPU_UTIL_EN > 0
+  if (OSCPUUtilQuery(&util) == OS_ERR_NONE && util.OSUtilSamples > 0) {
+    tp_print_util("100 ms", util.OSUtil100ms, util.OSUtilPeak100ms);
+    tp_print_util("1 s", util.OSUtil1s, util.OSUtilPeak1s);
+    tp_print_util("10 s", util.OSUtil10s, util.OSUtilPeak10s);
+  }
+#endif
+}
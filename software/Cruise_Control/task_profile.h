@@ -0,0 +1,46 @@
+/*
+ * Per-task and per-interrupt CPU time.
+ *
+ * The kernel port accounts the TIMER_1 cycles of each task in the
+ * OSTCBCyclesTot field of its TCB (OSTaskSwHook()) and those of each
+ * interrupt handler in OSIntCycles[] (alt_irq_handler()), and the
+ * longest call of each handler in OSIntCyclesMax[], see os_cpu.h.
+ * The time in the handlers is not charged to the interrupted task.
+ *
+ * This module turns the counters into shares of a window: 'tp_sample()'
+ * closes the window that started with the previous sample, the query
+ * functions return the totals and the last window, and 'tp_report()'
+ * samples and prints one line per task and per active interrupt, and
+ * the utilization averages of the kernel (OSCPUUtilQuery()).
+ *
+ * The running task is charged at its next switch, so the caller of
+ * 'tp_sample()' misses its current slice. The cycles are those of the
+ * free-running TIMER_1 (OS_TS_START()), the totals wrap after 2^32 of
+ * them (86 s at 50 MHz), the windows must be shorter.
+ *
+ * A task raised by a mutex is also found at the raised priority of
+ * OSTCBPrioTbl[], it is listed once, at the priority it runs at.
+ */
+
+#ifndef TASK_PROFILE_H_
+#define TASK_PROFILE_H_
+
+#include "includes.h"
+
+typedef struct {
+  const char* name;       /* Task name, NULL for an interrupt */
+  INT32U cycles;          /* Total since the start, wraps */
+  INT32U switches;        /* Context switches to the task, 0 for an interrupt */
+  INT32U calls;           /* Interrupt handler calls, 0 for a task */
+  INT32U max;             /* Longest handler call in cycles, 0 for a task */
+  INT32U window;          /* Cycles in the last window */
+  INT16U permille;        /* Share of the last window in 0.1% */
+} TP_STATS;
+
+void   tp_sample(void);
+INT32U tp_window_cycles(void);
+INT8U  tp_query(INT8U prio, TP_STATS* stats);
+INT8U  tp_query_irq(INT8U irq, TP_STATS* stats);
+void   tp_report(void);
+
+#endif /* TASK_PROFILE_H_ */
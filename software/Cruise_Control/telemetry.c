@@ -0,0 +1,120 @@
+#include "telemetry.h"
+
+#define TLM_RING_MASK (TLM_RING_SIZE - 1)
+
+typedef struct {
+  INT32U timestamp;
+  INT32U position;
+  INT16S velocity;
+  INT8U  throttle;
+  INT8U  source;
+  INT16U flags;
+  INT16U aux;
+  INT8U  seq;
+} TLM_RECORD;
+
+static TLM_RECORD tlm_ring[TLM_RING_SIZE];
+static volatile INT16U tlm_head = 0;  /* Next record to write, producers only */
+static volatile INT16U tlm_tail = 0;  /* Next record to drain, drain task only */
+static INT8U  tlm_seq = 0;
+static INT32U tlm_lost = 0;
+
+/*
+ * The function 'tlm_write()' stores one record. When the ring is full the
+ * record is dropped; its sequence number is still consumed, so the host
+ * sees the gap.
+ */
+void tlm_write(INT8U source, INT32U position, INT16S velocity,
+               INT8U throttle, INT16U flags, INT16U aux)
+{
+  TLM_RECORD* rec;
+  OS_CPU_SR cpu_sr;
+
+  OS_ENTER_CRITICAL();
+  if ((INT16U) (tlm_head - tlm_tail) >= TLM_RING_SIZE) {
+    tlm_seq++;
+    tlm_lost++;
+    OS_EXIT_CRITICAL();
+    return;
+  }
+  rec = &tlm_ring[tlm_head & TLM_RING_MASK];
+  rec->timestamp = OSTime;
+  rec->position = position;
+  rec->velocity = velocity;
+  rec->throttle = throttle;
+  rec->source = source;
+  rec->flags = flags;
+  rec->aux = aux;
+  rec->seq = tlm_seq++;
+  tlm_head++;
+  OS_EXIT_CRITICAL();
+}
+
+static INT8U* tlm_put16(INT8U* p, INT16U v)
+{
+  *p++ = (INT8U) v;
+  *p++ = (INT8U) (v >> 8);
+  return p;
+}
+
+static INT8U* tlm_put32(INT8U* p, INT32U v)
+{
+  p = tlm_put16(p, (INT16U) v);
+  return tlm_put16(p, (INT16U) (v >> 16));
+}
+
+/*
+ * The function 'tlm_drain()' encodes as many pending records as fit into
+ * 'buf', TLM_FRAME_MAX bytes each at most, and releases them. Returns the
+ * number of bytes written to 'buf'.
+ */
+int tlm_drain(INT8U* buf, int size)
+{
+  TLM_RECORD* rec;
+  INT8U frame[TLM_FRAME_SIZE];
+  INT8U* out = buf;
+  INT8U* p;
+  INT8U* q;
+  INT8U sum;
+  INT16U head;
+
+  head = tlm_head;  /* Single 16-bit load, no lock needed */
+  OS_CPU_BARRIER(); /* The records are read after the head */
+  while (tlm_tail != head && buf + size - out >= TLM_FRAME_MAX) {
+    rec = &tlm_ring[tlm_tail & TLM_RING_MASK];
+    p = frame;
+    *p++ = TLM_SYNC0;
+    *p++ = TLM_SYNC1;
+    q = p;
+    *p++ = rec->seq;
+    p = tlm_put32(p, rec->timestamp);
+    p = tlm_put32(p, rec->position);
+    p = tlm_put16(p, (INT16U) rec->velocity);
+    *p++ = rec->throttle;
+    *p++ = rec->source;
+    p = tlm_put16(p, rec->flags);
+    p = tlm_put16(p, rec->aux);
+    for (sum = 0; q < p; q++)
+      sum += *q;
+    *p++ = sum;
+
+    OS_CPU_BARRIER();
+    tlm_tail++;     /* Frees the slot for the producers */
+    for (q = frame; q < p; q++)
+      if (*q == 0x04 || *q == TLM_ESC) {
+        *out++ = TLM_ESC;
+        *out++ = *q ^ TLM_ESC_XOR;
+      } else
+        *out++ = *q;
+  }
+
+  return out - buf;
+}
+
+/*
+ * Number of records dropped because the ring was full
+ */
+INT32U tlm_dropped(void)
+{
+  return tlm_lost;
+}
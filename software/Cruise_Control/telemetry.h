@@ -0,0 +1,65 @@
+/*
+ * Deferred binary telemetry.
+ *
+ * Tasks store fixed-size records in a RAM ring with 'tlm_write()', which
+ * only copies a few words inside a short critical section. A low priority
+ * task calls 'tlm_drain()' and writes the encoded frames to the JTAG UART,
+ * so the stdio and UART driver cost leaves the control loop.
+ *
+ * Frame layout (20 bytes, multi-byte fields little-endian):
+ *
+ *   offset  size  field
+ *        0     2  sync, 0xA5 0x5A
+ *        2     1  sequence number, gaps mean dropped records
+ *        3     4  timestamp (OS ticks, 1 ms)
+ *        7     4  position (0.1 m)
+ *       11     2  velocity (0.1 m/s, signed)
+ *       13     1  throttle (0.1 V)
+ *       14     1  source (TLM_SRC_*)
+ *       15     2  flags (TLM_FLAG_*)
+ *       17     2  aux, source specific
+ *       19     1  checksum, sum of bytes 2..18 modulo 256
+ *
+ * nios2-terminal quits when it receives a Ctrl-D (0x04), so 0x04 and
+ * TLM_ESC are sent as TLM_ESC followed by the byte XOR TLM_ESC_XOR. The
+ * offsets and the checksum are those of the unescaped frame, which takes
+ * up to TLM_FRAME_MAX bytes on the wire.
+ *
+ * software/host_tools/tlm_decode.c turns a capture back into text or CSV.
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "includes.h"
+
+#define TLM_RING_SIZE      64   /* Records, must be a power of two */
+#define TLM_FRAME_SIZE     20
+#define TLM_FRAME_MAX      (2 * TLM_FRAME_SIZE)   /* Escaped */
+
+#define TLM_ESC          0x1B   /* Escape of 0x04 (Ctrl-D) and of itself */
+#define TLM_ESC_XOR      0x20
+
+#define TLM_SYNC0        0xA5
+#define TLM_SYNC1        0x5A
+
+/* Record sources */
+#define TLM_SRC_VEHICLE     1   /* aux: unused                               */
+#define TLM_SRC_WATCHDOG    2   /* aux: workload of the original system (%)  */
+#define TLM_SRC_TOPICS      3   /* aux: messages skipped by TelemetryTask    */
+
+/* Flags */
+#define TLM_FLAG_ENGINE     0x0001
+#define TLM_FLAG_TOP_GEAR   0x0002
+#define TLM_FLAG_GAS        0x0004
+#define TLM_FLAG_BRAKE      0x0008
+#define TLM_FLAG_CRUISE     0x0010  /* Cruise control button */
+#define TLM_FLAG_CRUISING   0x0020
+#define TLM_FLAG_OVERLOAD   0x0040
+
+void   tlm_write(INT8U source, INT32U position, INT16S velocity,
+                 INT8U throttle, INT16U flags, INT16U aux);
+int    tlm_drain(INT8U* buf, int size);
+INT32U tlm_dropped(void);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,138 @@
+#include <string.h>
+#include <unistd.h>
+#include "system.h"
+#include "sys/alt_timestamp.h"
+#include "trace_dump.h"
+
+#if OS_TRACE_EN > 0
+
+#define TRC_CHUNK  64   /* Records per write() */
+
+/*
+ * The function 'trc_write()' writes 'len' bytes to 'fd' with the Ctrl-D
+ * and escape bytes escaped, see trace_dump.h.
+ */
+static void trc_write(int fd, const INT8U* data, int len)
+{
+  INT8U out[128];   /* An escaped byte takes two */
+  int n = 0;
+
+  while (len-- > 0) {
+    if (*data == 0x04 || *data == TRC_ESC) {
+      out[n++] = TRC_ESC;
+      out[n++] = *data++ ^ TRC_ESC_XOR;
+    } else
+      out[n++] = *data++;
+    if (n >= (int) sizeof(out) - 1 || len == 0) {
+      write(fd, out, n);
+      n = 0;
+    }
+  }
+}
+
+static INT8U* trc_put16(INT8U* p, INT16U v)
+{
+  *p++ = (INT8U) v;
+  *p++ = (INT8U) (v >> 8);
+  return p;
+}
+
+static INT8U* trc_put32(INT8U* p, INT32U v)
+{
+  p = trc_put16(p, (INT16U) v);
+  return trc_put16(p, (INT16U) (v >> 16));
+}
+
+static INT8U* trc_put_name(INT8U* p, INT8U kind, INT8U id, const INT8U* name)
+{
+  INT8U i;
+
+  *p++ = kind;
+  *p++ = id;
+  for (i = 0; i < TRC_NAME_SIZE - 1 && name[i] != '\0'; i++)
+    *p++ = name[i];
+  for (; i < TRC_NAME_SIZE; i++)
+    *p++ = '\0';
+  return p;
+}
+
+/*
+ * Name table of the block: the created tasks and the named events and
+ * timers. Returns the end of the table, 'count' receives its entries.
+ */
+static INT8U* trc_put_names(INT8U* p, INT8U* count)
+{
+  OS_TCB* tcb;
+  INT16U i;
+  INT8U n = 0;
+
+  for (i = 0; i <= OS_LOWEST_PRIO && n < 255; i++) {
+    tcb = OSTCBPrioTbl[i];
+    if (tcb == (OS_TCB*) 0 || tcb == OS_TCB_RESERVED)
+      continue;
+    p = trc_put_name(p, 'T', (INT8U) i, tcb->OSTCBTaskName);
+    n++;
+  }
+  for (i = 0; i < OS_MAX_EVENTS && n < 255; i++) {
+    if (OSEventTbl[i].OSEventType == OS_EVENT_TYPE_UNUSED ||
+        OSEventTbl[i].OSEventName[0] == '?')
+      continue;
+    p = trc_put_name(p, 'E', (INT8U) i, OSEventTbl[i].OSEventName);
+    n++;
+  }
+#if OS_TMR_EN > 0
+  for (i = 0; i < OS_TMR_CFG_MAX && n < 255; i++) {
+    if (OSTmrTbl[i].OSTmrState == OS_TMR_STATE_UNUSED)
+      continue;
+    p = trc_put_name(p, 'M', (INT8U) i, OSTmrTbl[i].OSTmrName);
+    n++;
+  }
+#endif
+  *count = n;
+  return p;
+}
+
+/*
+ * The function 'trc_dump()' writes the trace ring to 'fd'. The recording
+ * is stopped during the dump and resumed afterwards, so the block is
+ * consistent. It blocks in the UART driver and should run in a low
+ * priority task.
+ */
+void trc_dump(int fd)
+{
+  static INT8U buf[17 + 255 * (2 + TRC_NAME_SIZE)];
+  OS_TRACE_REC* rec;
+  INT8U* p;
+  INT32U ctr, n, first, i;
+  INT8U names;
+
+  OSTraceStop();
+  ctr = OSTraceCtr;
+  n = (ctr > OS_TRACE_BUF_SIZE) ? OS_TRACE_BUF_SIZE : ctr;
+  first = ctr - n;
+
+  memcpy(buf, "TRC1", 4);
+  p = trc_put32(buf + 4, alt_timestamp_freq());
+  p = trc_put32(p, n);
+  p = trc_put32(p, first);
+  p = trc_put_names(p + 1, &names);
+  buf[16] = names;
+  trc_write(fd, buf, p - buf);
+
+  for (i = 0; i < n; i++) {
+    if (i % TRC_CHUNK == 0)
+      p = buf;
+    rec = &OSTraceBuf[(first + i) & (OS_TRACE_BUF_SIZE - 1)];
+    p = trc_put32(p, rec->OSTraceTs);
+    *p++ = rec->OSTraceEvent;
+    *p++ = rec->OSTracePrio;
+    p = trc_put16(p, rec->OSTraceArg);
+    if (i % TRC_CHUNK == TRC_CHUNK - 1 || i == n - 1)
+      trc_write(fd, buf, p - buf);
+  }
+  write(fd, "TRCE", 4);
+
+  OSTraceStart();
+}
+
+#endif /* OS_TRACE_EN */
@@ -0,0 +1,47 @@
+/*
+ * Dump of the kernel trace ring (OS_TRACE_EN in os_cfg.h).
+ *
+ * The kernel records context switches, interrupts and semaphore, mailbox
+ * and timer events with TIMER_1 timestamps in OSTraceBuf[]. 'trc_dump()'
+ * writes the ring as one binary block to the JTAG UART, together with the
+ * names of the tasks, events and timers the records refer to.
+ *
+ * Block layout (multi-byte fields little-endian):
+ *
+ *   offset  size  field
+ *        0     4  magic "TRC1"
+ *        4     4  timestamp frequency (Hz)
+ *        8     4  number of records n
+ *       12     4  records lost before the first one
+ *       16     1  number of names m
+ *       17  18*m  names: kind ('T' task, 'E' event, 'M' timer), id
+ *                 (priority, OSEventTbl[] or OSTmrTbl[] index), name
+ *                 (16 bytes, NUL padded)
+ *            8*n  records: timestamp (4), event (1, OS_TRACE_*),
+ *                 priority of the running task (1), argument (2)
+ *                 then "TRCE"
+ *
+ * nios2-terminal quits when it receives a Ctrl-D (0x04), a common byte in
+ * the records, so the block is escaped on the wire as the telemetry frames
+ * are: 0x04 and TRC_ESC are sent as TRC_ESC followed by the byte XOR
+ * TRC_ESC_XOR. The offsets above are those of the unescaped block.
+ *
+ * software/host_tools/trace_json.c converts a capture to Chrome trace
+ * JSON (chrome://tracing, Perfetto).
+ */
+
+#ifndef TRACE_DUMP_H_
+#define TRACE_DUMP_H_
+
+#include "includes.h"
+
+#define TRC_NAME_SIZE  16
+
+#define TRC_ESC        0x1B   /* Same escaping as TLM_ESC in telemetry.h */
+#define TRC_ESC_XOR    0x20
+
+#if OS_TRACE_EN > 0
+void trc_dump(int fd);
+#endif
+
+#endif /* TRACE_DUMP_H_ */
@@ -0,0 +1,64 @@
+#include "track.h"
+
+/*
+ * The function 'track_search()' returns the index of the segment that
+ * contains 'position' by binary search. Positions beyond the end of the
+ * track belong to the last segment.
+ */
+INT16U track_search(INT32U position)
+{
+  INT16U low = 0;
+  INT16U high = track_segment_count - 1;
+  INT16U mid;
+
+  while (low < high) {
+    mid = (low + high) >> 1;
+    if (position < track_segments[mid].end)
+      high = mid;
+    else
+      low = mid + 1;
+  }
+
+  return low;
+}
+
+/*
+ * The function 'track_find()' returns the index of the segment that
+ * contains 'position', starting from the segment 'hint' of the previous
+ * lookup. A vehicle stays in its segment or enters the next one (also
+ * across the end of the track), so the search is only needed for jumps.
+ */
+INT16U track_find(INT32U position, INT16U hint)
+{
+  INT32U start;
+
+  if (hint >= track_segment_count)
+    return track_search(position);
+
+  start = (hint == 0) ? 0 : track_segments[hint - 1].end;
+  if (position >= start && position < track_segments[hint].end)
+    return hint;
+
+  if (position >= track_segments[hint].end) {
+    if (hint + 1 < track_segment_count) {
+      if (position < track_segments[hint + 1].end)
+        return hint + 1;
+    }
+  } else if (hint + 1 == track_segment_count && position < track_segments[0].end)
+    return 0;
+
+  return track_search(position);
+}
+
+/*
+ * Position LED zone (0 = LEDR17) of 'position'
+ */
+INT8U track_zone(INT32U position)
+{
+  INT8U zone = 0;
+
+  while (zone < TRACK_ZONES - 1 && position >= track_zone_end[zone])
+    zone++;
+
+  return zone;
+}
@@ -0,0 +1,37 @@
+/*
+ * Table-driven track model.
+ *
+ * The track is a sequence of segments, each with a grade retardation and
+ * a headwind. The table in track_data.c is generated on the host from a
+ * route profile by software/host_tools/track_gen.c:
+ *
+ *   track_gen tracks/lab.trk > ../Cruise_Control/track_data.c
+ *
+ * Positions are 32-bit (0.1 m). A moving vehicle is found in O(1) from
+ * the segment of its last lookup, other positions by binary search.
+ */
+
+#ifndef TRACK_H_
+#define TRACK_H_
+
+#include "includes.h"
+
+#define TRACK_ZONES  6   /* Position LEDs LEDR17-LEDR12 */
+
+typedef struct {
+  INT32U end;     /* End of the segment (0.1 m), exclusive      */
+  INT8S  grade;   /* Grade retardation (0.1 m/s^2), uphill > 0  */
+  INT8S  wind;    /* Headwind (0.1 m/s), tailwind < 0           */
+} TRACK_SEGMENT;
+
+/* Generated, see track_data.c */
+extern const TRACK_SEGMENT track_segments[];
+extern const INT16U track_segment_count;
+extern const INT32U track_length;
+extern const INT32U track_zone_end[TRACK_ZONES];
+
+INT16U track_search(INT32U position);
+INT16U track_find(INT32U position, INT16U hint);
+INT8U  track_zone(INT32U position);
+
+#endif /* TRACK_H_ */
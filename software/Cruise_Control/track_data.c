@@ -0,0 +1,23 @@
+/*
+ * Generated by software/host_tools/track_gen.c from tracks/lab.trk,
+ * do not edit. See track.h.
+ */
+
+#include "track.h"
+
+const TRACK_SEGMENT track_segments[] = {
+  {     4000,    0,    0 },
+  {     8000,   15,    0 },
+  {    12000,   25,    0 },
+  {    16000,    0,    0 },
+  {    20000,  -10,    0 },
+  {    24000,   -5,    0 },
+};
+
+const INT16U track_segment_count = 6;
+
+const INT32U track_length = 24000;
+
+const INT32U track_zone_end[TRACK_ZONES] = {
+  4000, 8000, 12000, 16000, 20000, 24000
+};
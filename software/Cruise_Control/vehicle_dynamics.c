@@ -0,0 +1,201 @@
+#include "vehicle_dynamics.h"
+
+#define VD_MAX_SPEED   1600  /* Clamp for the wind term, 160.0 m/s */
+
+fix16_t fix16_add_sat(fix16_t a, fix16_t b)
+{
+  INT32U sum = (INT32U) a + (INT32U) b;
+
+  /* Overflow: both operands have the same sign and the sum has the other */
+  if ((~((INT32U) a ^ (INT32U) b) & ((INT32U) a ^ sum)) & 0x80000000u)
+    return (a < 0) ? FIX16_MIN : FIX16_MAX;
+
+  return (fix16_t) sum;
+}
+
+fix16_t fix16_sub_sat(fix16_t a, fix16_t b)
+{
+  INT32U diff = (INT32U) a - (INT32U) b;
+
+  /* Overflow: the operands differ in sign and the result differs from a */
+  if (((INT32U) a ^ (INT32U) b) & ((INT32U) a ^ diff) & 0x80000000u)
+    return (a < 0) ? FIX16_MIN : FIX16_MAX;
+
+  return (fix16_t) diff;
+}
+
+/*
+ * The function 'fix16_mul_sat()' multiplies two Q15.16 values without a
+ * 64-bit intermediate. The magnitudes are split into 16-bit halves:
+ *
+ *   (ah:al * bh:bl) >> 16 = (ah*bh << 16) + ah*bl + al*bh + (al*bl >> 16)
+ *
+ * Partial products with a zero half are skipped. This is the common case
+ * for the small values of the model and saves software multiplications.
+ */
+fix16_t fix16_mul_sat(fix16_t a, fix16_t b)
+{
+  INT32U ua, ub, ah, al, bh, bl, part, res, limit;
+  INT8U neg = 0;
+  INT8U overflow = 0;
+
+  if (a < 0) {
+    ua = 0u - (INT32U) a;
+    neg = 1;
+  } else
+    ua = (INT32U) a;
+
+  if (b < 0) {
+    ub = 0u - (INT32U) b;
+    neg ^= 1;
+  } else
+    ub = (INT32U) b;
+
+  ah = ua >> 16;
+  al = ua & 0xFFFF;
+  bh = ub >> 16;
+  bl = ub & 0xFFFF;
+
+  res = 0;
+  if (ah != 0 && bh != 0) {
+    part = ah * bh;
+    if (part > 0xFFFF)
+      overflow = 1;
+    res = part << 16;
+  }
+  if (ah != 0 && bl != 0) {
+    part = ah * bl;
+    res += part;
+    if (res < part)
+      overflow = 1;
+  }
+  if (al != 0 && bh != 0) {
+    part = al * bh;
+    res += part;
+    if (res < part)
+      overflow = 1;
+  }
+  if (al != 0 && bl != 0) {
+    part = (al * bl) >> 16;
+    res += part;
+    if (res < part)
+      overflow = 1;
+  }
+
+  limit = neg ? 0x80000000u : 0x7FFFFFFFu;
+  if (overflow || res > limit)
+    return neg ? FIX16_MIN : FIX16_MAX;
+
+  return neg ? (fix16_t) (0u - res) : (fix16_t) res;
+}
+
+/*
+ * Wind resistance v^2/10000 + 1 (0.1 m/s^2) with v the air speed in
+ * 0.1 m/s (velocity plus headwind), negated when the air comes from
+ * behind. 1/10000 in Q16 is 6.5536, approximated by 839/128 (error below
+ * 0.02%).
+ */
+static fix16_t vd_wind(fix16_t velocity, INT8S headwind)
+{
+  INT32U speed;
+  fix16_t drag;
+
+  velocity = fix16_add_sat(velocity, INT_TO_FIX16(headwind));
+  if (velocity < 0)
+    speed = (0u - (INT32U) velocity) >> FIX16_SHIFT;
+  else
+    speed = (INT32U) velocity >> FIX16_SHIFT;
+
+  if (speed > VD_MAX_SPEED)
+    speed = VD_MAX_SPEED;
+
+  drag = (fix16_t) ((speed * speed * 839u) >> 7);
+
+  if (velocity > 0)
+    return drag + FIX16_ONE;
+  else
+    return FIX16_ONE - drag;
+}
+
+/*
+ * The function 'vd_init()' resets the vehicle to standstill at the start
+ * of the track. 'period_ms' is the time between two calls of 'vd_step()'
+ * and must be below 32 s.
+ */
+void vd_init(VD_STATE* s, INT16U period_ms)
+{
+  s->position = 0;
+  s->velocity = 0;
+  s->acceleration = 0;
+  s->segment = 0;
+  s->length = track_length << UFIX8_SHIFT;
+
+  /* The only division of the model, done once */
+  s->dt = (fix16_t) ((((INT32U) period_ms << FIX16_SHIFT) + 500) / 1000);
+  s->brake_dv = fix16_mul_sat(INT_TO_FIX16(VD_BRAKE_RETARDATION), s->dt);
+}
+
+/*
+ * The function 'vd_step()' advances the model by one period. 'throttle'
+ * is between 0 and 80 (0.0 V and 8.0 V). The brake overrides the throttle
+ * and stops the vehicle without reversing it.
+ */
+void vd_step(VD_STATE* s, INT8U throttle, INT8U braking)
+{
+  fix16_t v_old = s->velocity;
+  fix16_t v_new;
+  INT32U position;
+  const TRACK_SEGMENT* segment;
+
+  s->segment = track_find(s->position >> UFIX8_SHIFT, s->segment);
+  segment = &track_segments[s->segment];
+
+  if (braking) {
+    s->acceleration = INT_TO_FIX16(-VD_BRAKE_RETARDATION);
+    v_new = (v_old > s->brake_dv) ? v_old - s->brake_dv : 0;
+  } else {
+    /* throttle / 2 - retardation */
+    s->acceleration = fix16_sub_sat((fix16_t) throttle << (FIX16_SHIFT - 1),
+                                    vd_wind(v_old, segment->wind));
+    s->acceleration = fix16_sub_sat(s->acceleration, INT_TO_FIX16(segment->grade));
+    v_new = fix16_add_sat(v_old, fix16_mul_sat(s->acceleration, s->dt));
+  }
+
+  /* Distance from the mean velocity, exact for constant acceleration.
+   * The track is shorter than 2^23 (track_gen.c), so the position stays
+   * positive as INT32S and a step cannot wrap twice. */
+  position = s->position
+    + (INT32U) (fix16_mul_sat((v_old >> 1) + (v_new >> 1), s->dt)
+                >> (FIX16_SHIFT - UFIX8_SHIFT));
+
+  if ((INT32S) position < 0)
+    position += s->length;
+  else if (position >= s->length)
+    position -= s->length;
+
+  s->position = position;
+  s->velocity = v_new;
+}
+
+/*
+ * Current position in 0.1 m
+ */
+INT32U vd_position(const VD_STATE* s)
+{
+  return s->position >> UFIX8_SHIFT;
+}
+
+/*
+ * Current velocity in 0.1 m/s, truncated towards zero
+ */
+INT16S vd_velocity(const VD_STATE* s)
+{
+  INT32U speed;
+
+  if (s->velocity < 0) {
+    speed = (0u - (INT32U) s->velocity) >> FIX16_SHIFT;
+    return (INT16S) -(INT32S) speed;
+  }
+
+  return (INT16S) (s->velocity >> FIX16_SHIFT);
+}
@@ -0,0 +1,58 @@
+/*
+ * Fixed-point model of the vehicle dynamics.
+ *
+ * The CPU is a Nios II/e core without FPU and without hardware multiplier,
+ * so the model uses no float and no division in the per-cycle path. The
+ * units are those of the original VehicleTask:
+ *
+ *   position     : 0.1 m     (Q24.8,  unsigned)
+ *   velocity     : 0.1 m/s   (Q15.16, signed)
+ *   acceleration : 0.1 m/s^2 (Q15.16, signed)
+ *
+ * Grade and wind come from the track table, see track.h.
+ */
+
+#ifndef VEHICLE_DYNAMICS_H_
+#define VEHICLE_DYNAMICS_H_
+
+#include "includes.h"
+#include "track.h"
+
+typedef INT32S fix16_t;   /* Signed Q15.16   */
+typedef INT32U ufix8_t;   /* Unsigned Q24.8  */
+
+#define FIX16_SHIFT      16
+#define FIX16_ONE        ((fix16_t) 1 << FIX16_SHIFT)
+#define FIX16_MAX        ((fix16_t) 0x7FFFFFFF)
+#define FIX16_MIN        (-FIX16_MAX - 1)
+
+#define INT_TO_FIX16(x)  ((fix16_t) (x) << FIX16_SHIFT)
+#define FIX16_TO_INT(x)  ((x) >> FIX16_SHIFT)            /* Rounds towards -inf */
+
+#define UFIX8_SHIFT      8
+
+#define VD_BRAKE_RETARDATION    200  /* 20.0 m/s^2 */
+
+typedef struct {
+  ufix8_t position;
+  fix16_t velocity;
+  fix16_t acceleration;  /* Acceleration applied during the last step */
+  fix16_t dt;            /* Step length in seconds (Q15.16)           */
+  fix16_t brake_dv;      /* Velocity removed by the brake in one step */
+  ufix8_t length;        /* Track length, the position wraps here     */
+  INT16U  segment;       /* Track segment of the last step            */
+} VD_STATE;
+
+/*
+ * Saturating Q15.16 arithmetic
+ */
+fix16_t fix16_add_sat(fix16_t a, fix16_t b);
+fix16_t fix16_sub_sat(fix16_t a, fix16_t b);
+fix16_t fix16_mul_sat(fix16_t a, fix16_t b);
+
+void    vd_init(VD_STATE* s, INT16U period_ms);
+void    vd_step(VD_STATE* s, INT8U throttle, INT8U braking);
+INT32U  vd_position(const VD_STATE* s);
+INT16S  vd_velocity(const VD_STATE* s);
+
+#endif /* VEHICLE_DYNAMICS_H_ */
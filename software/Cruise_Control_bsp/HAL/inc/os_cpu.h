@@ -57,6 +57,7 @@ extern "C"
 #endif /* __cplusplus */
 
 #include "sys/alt_irq.h"
+#include "sys/alt_timestamp.h"
 
 #ifdef  OS_CPU_GLOBALS
 #define OS_CPU_EXT
@@ -92,6 +93,11 @@ typedef unsigned int   OS_STK;                   /* Each stack entry is 32-bits
 
 #define  OS_STK_GROWTH        1        /* Stack grows from HIGH to LOW memory */
 #define  OS_TASK_SW           OSCtxSw  
+#define  OS_TS_GET()          ((INT32U) alt_timestamp())   /* TIMER_1 cycles, for profiling and trace */
+#define  OS_TS_START()        OSTsStart()                  /* Run TIMER_1 continuously, see os_cpu_c.c */
+#define  OS_CPU_BARRIER()     __asm__ __volatile__ ("" : : : "memory")  /* No reordering of memory    */
+                                                           /* accesses by the compiler, the Nios II/e */
+                                                           /* has no data cache and executes in order */
 
 /******************************************************************************************
  *                Disable and Enable Interrupts - 2 methods
@@ -134,6 +140,30 @@ typedef unsigned int   OS_STK;                   /* Each stack entry is 32-bits
 void OSStartHighRdy(void); 
 void OSCtxSw(void); 
 void OSIntCtxSw(void);
+int  OSTsStart(void);
+
+/******************************************************************************************
+ *                           Execution time accounting
+ *
+ * With OS_TASK_PROFILE_EN, OSTaskSwHook() adds the cycles of each task to OSTCBCyclesTot
+ * of its TCB and alt_irq_handler() adds the cycles of each interrupt handler to
+ * OSIntCycles[] and the longest call to OSIntCyclesMax[].  The time in the handlers is
+ * not charged to the interrupted task.  The counters are TIMER_1 timestamps (OS_TS_GET())
+ * and wrap after 2^32 cycles.  With OS_TRACE_EN, the same hooks record the start and end
+ * of each handler in the trace.
+ *****************************************************************************************/
+
+#if OS_TASK_PROFILE_EN > 0
+OS_CPU_EXT INT32U OSIntCyclesTot;              /* Cycles in all interrupt handlers            */
+OS_CPU_EXT INT32U OSIntCycles[ALT_NIRQ];       /* Cycles in the handler of each interrupt     */
+OS_CPU_EXT INT32U OSIntCtr[ALT_NIRQ];          /* Number of calls of each handler             */
+OS_CPU_EXT INT32U OSIntCyclesMax[ALT_NIRQ];    /* Longest call of each handler, in cycles     */
+#endif
+
+#if (OS_TASK_PROFILE_EN > 0) || (OS_TRACE_EN > 0)
+void OSIntProfileEnter(INT32U irq);
+void OSIntProfileExit(INT32U irq);
+#endif
 
 #ifdef __cplusplus
 }
@@ -78,6 +78,7 @@ extern int ioctl (int fd, int req, void* arg);
 
 #define TIOCSTIMEOUT 0x6a01 /* Set Timeout before assuming no host present */
 #define TIOCGCONNECTED 0x6a02 /* Get indication of whether host is connected */
+#define TIOCSDEFER 0x6a03 /* Copy the buffers in the OS deferred work task or in the ISR */
 
 /*
  *
@@ -105,10 +105,16 @@ void alt_irq_handler (void)
   while ((offset = ALT_CI_INTERRUPT_VECTOR) >= 0) {
     struct ALT_IRQ_HANDLER* handler_entry = 
       (struct ALT_IRQ_HANDLER*)(alt_irq_base + offset);
+#ifdef ALT_OS_IRQ_ENTER
+    ALT_OS_IRQ_ENTER(offset >> 3);
+#endif
 #ifdef ALT_ENHANCED_INTERRUPT_API_PRESENT
     handler_entry->handler(handler_entry->context);
 #else
     handler_entry->handler(handler_entry->context, offset >> 3);
+#endif
+#ifdef ALT_OS_IRQ_EXIT
+    ALT_OS_IRQ_EXIT(offset >> 3);
 #endif
   }
 #else /* ALT_CI_INTERRUPT_VECTOR */
@@ -142,10 +148,16 @@ void alt_irq_handler (void)
     {
       if (active & mask)
       { 
+#ifdef ALT_OS_IRQ_ENTER
+        ALT_OS_IRQ_ENTER(i);
+#endif
 #ifdef ALT_ENHANCED_INTERRUPT_API_PRESENT
         alt_irq[i].handler(alt_irq[i].context); 
 #else
         alt_irq[i].handler(alt_irq[i].context, i); 
+#endif
+#ifdef ALT_OS_IRQ_EXIT
+        ALT_OS_IRQ_EXIT(i);
 #endif
         break;
       }
@@ -20,12 +20,24 @@
 
 #include "system.h"
 
+#include "altera_avalon_timer.h"
+#include "altera_avalon_timer_regs.h"
+
+#if OS_TICKLESS_EN > 0
+#include "sys/alt_alarm.h"
+#endif
+
 extern void OSStartTsk;                 /* The entry point for all tasks. */
 
 #if OS_TMR_EN > 0
 static  INT16U  OSTmrCtr;
 #endif
 
+#if OS_TASK_PROFILE_EN > 0
+static  INT32U  OSIntCyclesMark;        /* OSIntCyclesTot when the current task was switched in */
+static  INT32U  OSIntCyclesStart;       /* Timestamp at the start of the running handler */
+#endif
+
 /***********************************************************************************************
  *                                        INITIALIZE A TASK'S STACK
  *
@@ -151,12 +163,96 @@ void OSTaskDelHook (OS_TCB *ptcb)
 *              2) It is assumed that the global pointer 'OSTCBHighRdy' points to the TCB of the task that
 *                 will be 'switched in' (i.e. the highest priority task) and, 'OSTCBCur' points to the
 *                 task being switched out (i.e. the preempted task).
+*              3) With OS_TASK_PROFILE_EN, the cycles since the task was switched in, less the cycles
+*                 spent in interrupt handlers meanwhile, are added to OSTCBCyclesTot.  The first call
+*                 from OSStartHighRdy() only starts the count.
+*              4) With OS_TRACE_EN, the switch is recorded in the trace.
 *********************************************************************************************************
 */
 void OSTaskSwHook (void)
 {
+#if OS_TASK_PROFILE_EN > 0
+    INT32U  now;
+    INT32U  isr;
+#endif
+
+
+    OS_TRACE(OS_TRACE_TASK_SW, OSTCBHighRdy->OSTCBPrio);
+#if OS_TASK_PROFILE_EN > 0
+    now = OS_TS_GET();
+    isr = OSIntCyclesTot;
+    if (OSRunning == OS_TRUE) {
+        OSTCBCur->OSTCBCyclesTot += (now - OSTCBCur->OSTCBCyclesStart) - (isr - OSIntCyclesMark);
+    }
+    OSTCBHighRdy->OSTCBCyclesStart = now;
+    OSIntCyclesMark                = isr;
+#endif
 }
 
+/*
+*********************************************************************************************************
+*                                       START THE TIMESTAMP COUNTER
+*
+* Description: alt_timestamp_start() starts TIMER_1 as a one-shot over 2^32 cycles (86 s at 50 MHz),
+*              after which alt_timestamp() stays 0.  This function restarts it in continuous mode, so
+*              that OS_TS_GET() wraps and the 32-bit differences of the profiling, the trace and the
+*              application stay right.  The application calls it through OS_TS_START() before OSStart().
+*
+* Returns    : 0, or -1 if there is no timestamp device
+*********************************************************************************************************
+*/
+int OSTsStart (void)
+{
+    if (alt_timestamp_start() < 0) {
+        return (-1);
+    }
+    IOWR_ALTERA_AVALON_TIMER_CONTROL(altera_avalon_timer_ts_base,
+                                     ALTERA_AVALON_TIMER_CONTROL_START_MSK |
+                                     ALTERA_AVALON_TIMER_CONTROL_CONT_MSK);
+    return (0);
+}
+
+/*
+*********************************************************************************************************
+*                                      INTERRUPT HANDLER PROFILING
+*
+* Description: These functions are called by alt_irq_handler() around the handler of each interrupt.
+*              They add the cycles of the handler to OSIntCycles[irq] and to OSIntCyclesTot, keep the
+*              longest call in OSIntCyclesMax[irq], and record the start and the end of the handler in
+*              the trace.
+*
+* Arguments  : irq    is the number of the interrupt.
+*
+* Note(s)    : 1) Interrupts are disabled during these calls and the handlers do not nest.
+*********************************************************************************************************
+*/
+#if (OS_TASK_PROFILE_EN > 0) || (OS_TRACE_EN > 0)
+void OSIntProfileEnter (INT32U irq)
+{
+    OS_TRACE(OS_TRACE_IRQ_ENTER, irq);
+#if OS_TASK_PROFILE_EN > 0
+    OSIntCyclesStart = OS_TS_GET();
+#endif
+}
+
+void OSIntProfileExit (INT32U irq)
+{
+#if OS_TASK_PROFILE_EN > 0
+    INT32U  cycles;
+
+
+    cycles            = OS_TS_GET() - OSIntCyclesStart;
+    OSIntCycles[irq] += cycles;
+    OSIntCtr[irq]++;
+    OSIntCyclesTot   += cycles;
+    if (cycles > OSIntCyclesMax[irq]) {
+        OSIntCyclesMax[irq] = cycles;
+    }
+#endif
+    OS_TRACE(OS_TRACE_IRQ_EXIT, irq);
+}
+#endif
+
 /*
 *********************************************************************************************************
 *                                           STATISTIC TASK HOOK
@@ -218,8 +314,124 @@ void OSInitHookEnd(void)
 {
 }
 
+/*
+*********************************************************************************************************
+*                                            TICKLESS IDLE MODE
+*
+* Description: When only the idle task is ready, the idle hook stops the tick interrupt until the first of
+*              the next expiry in the delay list, the next HAL alarm (alt_alarm_start()) and the next
+*              OSTmrSignal() from the tick hook.  The scheduler stays locked while the tick is stopped, so
+*              an interrupt that readies a task ends the sleep before the task runs.  On wake-up the slept
+*              ticks are added to OSTime, _alt_nticks and the tick hook counter in O(1), and the last one
+*              is processed by alt_tick() like a tick interrupt.
+*
+*              OSIdleCtr is still counted during the sleep so that OSCPUUsage stays meaningful.
+*********************************************************************************************************
+*/
+
+#if OS_TICKLESS_EN > 0
+static alt_u32 OS_TicklessAlarmNext (void)
+{
+    alt_alarm  *alarm = (alt_alarm *)alt_alarm_list.next;
+    alt_u32     next  = 0xFFFFFFFF;
+    alt_u32     ticks;
+
+
+    while (alarm != (alt_alarm *)&alt_alarm_list) {
+        if (alarm->rollover == 0 && alarm->time <= _alt_nticks) {
+            return 1;                              /* Due on the next tick                         */
+        }
+        ticks = alarm->time - _alt_nticks;         /* Also right across the roll-over              */
+        if (ticks < next) {
+            next = ticks;
+        }
+        alarm = (alt_alarm *)alarm->llist.next;
+    }
+    return next;
+}
+
+static void OS_TicklessAlarmSkip (alt_u32 ticks)
+{
+    alt_alarm  *alarm;
+    alt_u32     nticks = _alt_nticks + ticks;
+
+
+    if (nticks < _alt_nticks) {                    /* Passed 0, as alt_tick() does at 0            */
+        alarm = (alt_alarm *)alt_alarm_list.next;
+        while (alarm != (alt_alarm *)&alt_alarm_list) {
+            alarm->rollover = 0;
+            alarm = (alt_alarm *)alarm->llist.next;
+        }
+    }
+    _alt_nticks = nticks;
+}
+
+static BOOLEAN OS_TicklessIdleOnly (void)
+{
+#if OS_RDY_MASK_EN > 0
+    return (OSRdyMask == ((INT32U)1 << OS_TASK_IDLE_PRIO));
+#else
+    return (OSRdyGrp == (1 << (OS_TASK_IDLE_PRIO >> 3)) &&
+            OSRdyTbl[OS_TASK_IDLE_PRIO >> 3] == (1 << (OS_TASK_IDLE_PRIO & 0x07)));
+#endif
+}
+
+static void OS_TicklessIdle (void)
+{
+    alt_u32    ticks;
+    alt_u32    next;
+    OS_CPU_SR  cpu_sr;
+
+
+    OS_ENTER_CRITICAL();
+    ticks = OSTimeTickNext();                      /* 0 when no task is delayed                    */
+    if (ticks == 0) {
+        ticks = 0xFFFF;
+    }
+    next = OS_TicklessAlarmNext();
+    if (next < ticks) {
+        ticks = next;
+    }
+#if OS_TMR_EN > 0
+    next = OS_TICKS_PER_SEC / OS_TMR_CFG_TICKS_PER_SEC - OSTmrCtr;
+    if (next < ticks) {
+        ticks = next;
+    }
+#endif
+    if (OSLockNesting > 0 || OS_TicklessIdleOnly() == OS_FALSE ||
+        alt_avalon_timer_sc_sleep(ticks) != 0) {
+        OS_EXIT_CRITICAL();
+        return;
+    }
+    OSLockNesting++;                               /* Same as OSSchedLock()                        */
+    OS_EXIT_CRITICAL();
+
+    while (alt_avalon_timer_sc_sleeping() && OS_TicklessIdleOnly()) {
+        OS_ENTER_CRITICAL();
+        OSIdleCtr++;
+        OS_EXIT_CRITICAL();
+    }
+
+    OS_ENTER_CRITICAL();
+    ticks = alt_avalon_timer_sc_wake();
+    if (ticks > 0) {
+        OS_TicklessAlarmSkip(ticks - 1);           /* No alarm, delay or timer is due before ...   */
+        OSTimeTickSkip((INT16U)(ticks - 1));
+#if OS_TMR_EN > 0
+        OSTmrCtr += (INT16U)(ticks - 1);
+#endif
+        alt_tick();                                /* ... the last tick                            */
+    }
+    OS_EXIT_CRITICAL();
+    OSSchedUnlock();                               /* Runs the task readied during the sleep       */
+}
+#endif
+
 void OSTaskIdleHook(void)
 {
+#if OS_TICKLESS_EN > 0
+    OS_TicklessIdle();
+#endif
 }
 
 void OSTCBInitHook(OS_TCB *ptcb)
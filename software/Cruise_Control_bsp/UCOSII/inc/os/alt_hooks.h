@@ -60,6 +60,11 @@ extern OS_EVENT *alt_heapsem;
 #define ALT_OS_INT_ENTER OSIntEnter
 #define ALT_OS_INT_EXIT  OSIntExit
 
+#if (OS_TASK_PROFILE_EN > 0) || (OS_TRACE_EN > 0)
+#define ALT_OS_IRQ_ENTER(irq) OSIntProfileEnter(irq)
+#define ALT_OS_IRQ_EXIT(irq)  OSIntProfileExit(irq)
+#endif
+
 #endif /* ALT_ASM_SRC */
 
 /* These macros are used by the VIC funnel assembly code */
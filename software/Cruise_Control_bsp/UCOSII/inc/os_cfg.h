@@ -44,17 +44,60 @@ extern "C"
  */
                                        /* ---------------------- MISCELLANEOUS ----------------------- */
 #define OS_APP_HOOKS_EN           1    /* Application-defined hooks are called from the uC/OS-II hooks */
+#define OS_CPU_UTIL_EN            1    /* CPU utilization from the cycles of the idle task, in 0.01%,  */
+                                       /* see os_util.c, requires OS_TASK_STAT_EN, OS_TASK_PROFILE_EN  */
 #define OS_EVENT_MULTI_EN         1    /* Include code for OSEventPendMulti()                          */
+#define OS_EVSET_EN               1    /* Include code for the event sets, see os_evset.c              */
+#define OS_RDY_MASK_EN            1    /* Ready list in one 32-bit word instead of OSRdyGrp/OSRdyTbl[],*/
+                                       /* requires OS_LOWEST_PRIO <= 31                                */
+
+                                       /* ----------------------- DEFERRED WORK ---------------------- */
+#define OS_DEFER_EN               1    /*     Include code for the deferred work task, see os_defer.c  */
+#define OS_DEFER_PRIOS            4    /*     Priority levels of the work items, 1 to 8                */
+#define OS_TASK_DEFER_PRIO        1    /*     Priority of the deferred work task, above the app tasks  */
+#define OS_TASK_DEFER_STK_SIZE  512    /*     Stack of the deferred work task, in OS_STK elements      */
 
                                        /* -------------------- MESSAGE MAILBOXES --------------------- */
 #define OS_MBOX_PEND_ABORT_EN     1    /*     Include code for OSMboxPendAbort()                       */
 
+                                       /* --------------- MUTUAL EXCLUSION SEMAPHORES ---------------- */
+#define OS_MUTEX_CEIL_EN          1    /*     Include code for OSMutexCreateExt() and the immediate    */
+                                       /*     priority ceiling mutexes                                 */
+
                                        /* ---------------------- MESSAGE QUEUES ---------------------- */
 #define OS_Q_PEND_ABORT_EN        1    /*     Include code for OSQPendAbort()                          */
 
+                                       /* ----------------------- RING BUFFERS ---------------------- */
+#define OS_RING_EN                1    /*     Include code for the lock-free single-producer/single-   */
+                                       /*     consumer OS_RING, see os_ring.c                          */
+
                                        /* ------------------------ SEMAPHORES ------------------------ */
 #define OS_SEM_PEND_ABORT_EN      1    /*    Include code for OSSemPendAbort()                         */
 
+                                       /* --------------------- TASK MANAGEMENT ---------------------- */
+#define OS_TASK_PERIODIC_EN       1    /*     Include code for OSTaskCreatePeriodic() and              */
+                                       /*     OSTimeDlyPeriod(), released by OSTimeTick()              */
+#define OS_TASK_STAT_STK_SCAN   128    /*     Stack words OS_TaskStatStkChk() checks per task and pass */
+                                       /*     to lower the watermark in the TCB, 0 scans whole stacks  */
+
+                                       /* --------------------- TIME MANAGEMENT ---------------------- */
+#define OS_TICK_DELTA_EN          1    /*     Delta-ordered delay list, OSTimeTick() only visits the   */
+                                       /*     first delayed task and the tasks that expire             */
+#define OS_TICKLESS_EN            0    /*     Idle task stops the tick until the next delay, alarm or  */
+                                       /*     OSTmrSignal(), requires OS_TICK_DELTA_EN                 */
+
+                                       /* --------------------- TIMER MANAGEMENT --------------------- */
+#define OS_TMR_HIER_EN            1    /*     Hierarchical timer wheel with O(1) insert and expiry     */
+#define OS_TMR_CFG_WHEEL_BITS     4    /*     Spokes per level as a power of 2 (16 spokes)             */
+#define OS_TMR_CFG_WHEEL_LEVELS   3    /*     Levels, timers up to 2^(4*3) timer ticks ahead are O(1)  */
+
+                                       /* -------------------------- TRACE --------------------------- */
+#define OS_TRACE_EN               1    /*     Record context switches, interrupts and semaphore,       */
+                                       /*     mailbox and timer events in OSTraceBuf[]                 */
+#define OS_TRACE_BUF_SIZE      2048    /*     Records in the trace ring (8 bytes each), power of 2     */
+                                       /*     The ring is in the .sram section, the off-chip SRAM of   */
+                                       /*     the board (altera_up_avalon_sram), not on-chip memory    */
+
                                                                                                                      
 #include "system.h"
 
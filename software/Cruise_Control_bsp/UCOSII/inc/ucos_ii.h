@@ -89,6 +89,7 @@ extern "C" {
 #define  OS_TASK_IDLE_ID          65535u                /* ID numbers for Idle, Stat and Timer tasks   */
 #define  OS_TASK_STAT_ID          65534u
 #define  OS_TASK_TMR_ID           65533u
+#define  OS_TASK_DEFER_ID         65532u
 
 #define  OS_EVENT_EN           (((OS_Q_EN > 0) && (OS_MAX_QS > 0)) || (OS_MBOX_EN > 0) || (OS_SEM_EN > 0) || (OS_MUTEX_EN > 0))
 
@@ -131,6 +132,7 @@ extern "C" {
 #define  OS_EVENT_TYPE_SEM            3u
 #define  OS_EVENT_TYPE_MUTEX          4u
 #define  OS_EVENT_TYPE_FLAG           5u
+#define  OS_EVENT_TYPE_MUTEX_CEIL     6u    /* Mutex with the immediate priority ceiling protocol      */
 
 #define  OS_TMR_TYPE                100u    /* Used to identify Timers ...                             */
                                             /* ... (Must be different value than OS_EVENT_TYPE_xxx)    */
@@ -226,6 +228,22 @@ extern "C" {
 #define  OS_TMR_OPT_CALLBACK          3u    /* OSTmrStop() option to call 'callback' w/ timer arg.     */
 #define  OS_TMR_OPT_CALLBACK_ARG      4u    /* OSTmrStop() option to call 'callback' w/ new   arg.     */
 
+/*
+*********************************************************************************************************
+*                                  RING OPTIONS (see OSRingCreate())
+*********************************************************************************************************
+*/
+#define  OS_RING_OPT_NONE             0u    /* The consumer polls                                      */
+#define  OS_RING_OPT_NOTIFY           1u    /* OSRingPend() waits, woken when the ring becomes non-empty */
+
+/*
+*********************************************************************************************************
+*                                 MUTEX OPTIONS (see OSMutexCreateExt())
+*********************************************************************************************************
+*/
+#define  OS_MUTEX_OPT_INHERIT         0u    /* Owner inherits 'prio' when a higher priority task waits */
+#define  OS_MUTEX_OPT_CEILING         1u    /* Owner runs at 'prio' from lock to unlock, nobody waits  */
+
 /*
 *********************************************************************************************************
 *                                            TIMER STATES
@@ -236,6 +254,22 @@ extern "C" {
 #define  OS_TMR_STATE_COMPLETED       2u
 #define  OS_TMR_STATE_RUNNING         3u
 
+/*
+*********************************************************************************************************
+*                                             TRACE EVENTS
+*********************************************************************************************************
+*/
+#define  OS_TRACE_TASK_SW             1u    /* Context switch,          arg: priority of the new task  */
+#define  OS_TRACE_INT_ENTER           2u    /* OSIntEnter(),            arg: new nesting level         */
+#define  OS_TRACE_INT_EXIT            3u    /* OSIntExit(),             arg: nesting level             */
+#define  OS_TRACE_IRQ_ENTER           4u    /* Start of a handler,      arg: IRQ number                */
+#define  OS_TRACE_IRQ_EXIT            5u    /* End of a handler,        arg: IRQ number                */
+#define  OS_TRACE_SEM_POST            6u    /* OSSemPost(),             arg: index in OSEventTbl[]     */
+#define  OS_TRACE_SEM_PEND            7u    /* OSSemPend(),             arg: index in OSEventTbl[]     */
+#define  OS_TRACE_MBOX_POST           8u    /* OSMboxPost[Opt](),       arg: index in OSEventTbl[]     */
+#define  OS_TRACE_MBOX_PEND           9u    /* OSMboxPend(),            arg: index in OSEventTbl[]     */
+#define  OS_TRACE_TMR_EXPIRE         10u    /* Timer callback,          arg: index in OSTmrTbl[]       */
+
 /*
 *********************************************************************************************************
 *                                             ERROR CODES
@@ -287,6 +321,8 @@ extern "C" {
 #define OS_ERR_TASK_SUSPEND_IDLE     71u
 #define OS_ERR_TASK_SUSPEND_PRIO     72u
 #define OS_ERR_TASK_WAITING          73u
+#define OS_ERR_TASK_NOT_PERIODIC     74u
+#define OS_ERR_TASK_PERIOD           75u
 
 #define OS_ERR_TIME_NOT_DLY          80u
 #define OS_ERR_TIME_INVALID_MINUTES  81u
@@ -294,6 +330,8 @@ extern "C" {
 #define OS_ERR_TIME_INVALID_MS       83u
 #define OS_ERR_TIME_ZERO_DLY         84u
 #define OS_ERR_TIME_DLY_ISR          85u
+#define OS_ERR_TIME_DEADLINE         86u
+#define OS_ERR_TIME_OVERRUN          87u
 
 #define OS_ERR_MEM_INVALID_PART      90u
 #define OS_ERR_MEM_INVALID_BLKS      91u
@@ -316,6 +354,8 @@ extern "C" {
 #define OS_ERR_FLAG_NAME_TOO_LONG   115u
 
 #define OS_ERR_PIP_LOWER            120u
+#define OS_ERR_MUTEX_BUSY           121u
+#define OS_ERR_MUTEX_ORDER          122u
 
 #define OS_ERR_TMR_INVALID_DLY      130u
 #define OS_ERR_TMR_INVALID_PERIOD   131u
@@ -332,6 +372,13 @@ extern "C" {
 #define OS_ERR_TMR_STOPPED          142u
 #define OS_ERR_TMR_NO_CALLBACK      143u
 
+#define OS_ERR_RING_SIZE            150u
+
+#define OS_ERR_EVSET_MEMBER         160u
+#define OS_ERR_EVSET_NOT_MEMBER     161u
+
+#define OS_ERR_DEFER_QUEUED         170u
+
 /*
 *********************************************************************************************************
 *                                    OLD ERROR CODE NAMES (< V2.84)
@@ -385,6 +432,10 @@ extern "C" {
 *********************************************************************************************************
 */
 
+#if OS_EVSET_EN > 0
+typedef struct os_evset_member OS_EVSET_MEMBER;
+#endif
+
 #if (OS_EVENT_EN) && (OS_MAX_EVENTS > 0)
 typedef struct os_event {
     INT8U    OSEventType;                    /* Type of event control block (see OS_EVENT_TYPE_xxxx)    */
@@ -401,6 +452,12 @@ typedef struct os_event {
 #if OS_EVENT_NAME_SIZE > 1
     INT8U    OSEventName[OS_EVENT_NAME_SIZE];
 #endif
+#if OS_EVSET_EN > 0
+    OS_EVSET_MEMBER *OSEventSetMember;       /* Membership in an event set, NULL if none                */
+#endif
+#if OS_MUTEX_CEIL_EN > 0
+    struct os_event *OSEventCeilPrev;        /* Ceiling mutex the owner locked before this one          */
+#endif
 } OS_EVENT;
 #endif
 
@@ -554,6 +611,84 @@ typedef struct os_q_data {
 } OS_Q_DATA;
 #endif
 
+/*
+*********************************************************************************************************
+*                                    SINGLE-PRODUCER/SINGLE-CONSUMER RING
+*
+* OSRingIn is only written by the producer and OSRingOut only by the consumer, so neither side disables
+* interrupts.  Both count entries and wrap at 2^16, their difference is the number of entries in the ring.
+*********************************************************************************************************
+*/
+
+#if OS_RING_EN > 0
+typedef struct os_ring {                /* RING CONTROL BLOCK                                          */
+    INT8U           *OSRingStart;       /* Pointer to the first entry                                  */
+    INT16U           OSRingMask;        /* Number of entries - 1, the number is a power of 2           */
+    INT8U            OSRingShift;       /* log2 of the entry size, the size is a power of 2            */
+    volatile BOOLEAN OSRingWaiting;     /* The consumer is about to pend or pends on OSRingSem         */
+    volatile INT16U  OSRingIn;          /* Entries committed by the producer                           */
+    volatile INT16U  OSRingOut;         /* Entries released by the consumer                            */
+    INT32U           OSRingFull;        /* Number of times the producer found the ring full            */
+#if OS_SEM_EN > 0
+    OS_EVENT        *OSRingSem;         /* Wake-up of the consumer, NULL without OS_RING_OPT_NOTIFY    */
+#endif
+} OS_RING;
+#endif
+
+/*
+*********************************************************************************************************
+*                                               EVENT SETS
+*
+* A member links a semaphore, mailbox or queue to one set.  The posts append the member to the set's
+* ready list when its source goes from empty to holding a count or a message, so waiting on the set and
+* taking a ready member do not depend on the number of members.
+*********************************************************************************************************
+*/
+
+#if OS_EVSET_EN > 0
+typedef struct os_evset {               /* EVENT SET CONTROL BLOCK                                     */
+    OS_EVSET_MEMBER *OSEvSetRdyHead;    /* Members whose source may hold a count or a message          */
+    OS_EVSET_MEMBER *OSEvSetRdyTail;
+    OS_EVSET_MEMBER *OSEvSetMembers;    /* All the members                                             */
+    OS_EVENT        *OSEvSetSem;        /* Wake-up of the task waiting in OSEvSetPend()                */
+} OS_EVSET;
+
+struct os_evset_member {                /* EVENT SET MEMBER                                            */
+    OS_EVSET        *OSEvSetMemberSet;      /* Set of the member, NULL once removed                    */
+    OS_EVENT        *OSEvSetMemberEvent;    /* Semaphore, mailbox or queue                             */
+    OS_EVSET_MEMBER *OSEvSetMemberNext;     /* Next member of the set                                  */
+    OS_EVSET_MEMBER *OSEvSetMemberRdyNext;  /* Next member in the ready list                           */
+    BOOLEAN          OSEvSetMemberRdy;      /* In the ready list                                       */
+    void            *OSEvSetMemberArg;      /* Application data, e.g. the handler of the source        */
+};
+#endif
+
+/*
+*********************************************************************************************************
+*                                          DEFERRED WORK ITEM
+*
+* An interrupt handler posts an item with OSDeferPost() and the deferred work task calls its function
+* later with interrupts enabled.  Posts of an item that is still queued are counted into its next run.
+*********************************************************************************************************
+*/
+
+#if OS_DEFER_EN > 0
+typedef  void (*OS_DEFER_FNCT)(void *parg, INT16U cnt);
+
+typedef struct os_defer {               /* DEFERRED WORK ITEM                                          */
+    struct os_defer *OSDeferNext;       /* Next queued item of the same priority                       */
+    OS_DEFER_FNCT    OSDeferFnct;       /* Function, called with the posts since the last run          */
+    void            *OSDeferArg;        /* Its argument                                                */
+    INT8U            OSDeferPrio;       /* 0 (runs first) to OS_DEFER_PRIOS - 1                        */
+    BOOLEAN          OSDeferQueued;     /* Posted and not yet taken by the task                        */
+    INT16U           OSDeferCnt;        /* Posts since the last run                                    */
+    INT32U           OSDeferStamp;      /* OS_TS_GET() at the first of them                            */
+    INT32U           OSDeferPosts;      /* Statistics: posts, runs and the longest time from the first */
+    INT32U           OSDeferRuns;       /*             post to the run in OS_TS_GET() cycles           */
+    INT32U           OSDeferLatMax;
+} OS_DEFER;
+#endif
+
 /*
 *********************************************************************************************************
 *                                           SEMAPHORE DATA
@@ -586,6 +721,27 @@ typedef struct os_stk_data {
 } OS_STK_DATA;
 #endif
 
+/*
+*********************************************************************************************************
+*                                          CPU UTILIZATION DATA
+*
+* The shares of the CPU used outside the idle task, in 0.01% (10000 is 100%), over the last sample of the
+* statistics task (100 ms), the last 10 samples (1 s) and the last 100 samples (10 s).
+*********************************************************************************************************
+*/
+
+#if OS_CPU_UTIL_EN > 0
+typedef struct os_cpu_util_data {
+    INT16U  OSUtil100ms;               /* Last sample                                                  */
+    INT16U  OSUtil1s;                  /* Last 10 samples                                              */
+    INT16U  OSUtil10s;                 /* Last 100 samples                                             */
+    INT16U  OSUtilPeak100ms;           /* Highest values since the start or OSCPUUtilPeakReset()       */
+    INT16U  OSUtilPeak1s;
+    INT16U  OSUtilPeak10s;
+    INT32U  OSUtilSamples;             /* Samples taken since the start                                */
+} OS_CPU_UTIL_DATA;
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -602,6 +758,10 @@ typedef struct os_tcb {
     INT32U           OSTCBStkSize;          /* Size of task stack (in number of stack elements)        */
     INT16U           OSTCBOpt;              /* Task options as passed by OSTaskCreateExt()             */
     INT16U           OSTCBId;               /* Task ID (0..65535)                                      */
+#if (OS_TASK_STAT_STK_CHK_EN > 0) && (OS_TASK_STAT_STK_SCAN > 0)
+    INT32U           OSTCBStkFree;          /* Stack elements never used at the bottom, the watermark  */
+    INT32U           OSTCBStkScan;          /* Next element OS_TaskStatStkChk() checks                 */
+#endif
 #endif
 
     struct os_tcb   *OSTCBNext;             /* Pointer to next     TCB in the TCB list                 */
@@ -627,6 +787,19 @@ typedef struct os_tcb {
 #endif
 
     INT16U           OSTCBDly;              /* Nbr ticks to delay task or, timeout waiting for event   */
+#if OS_TICK_DELTA_EN > 0                    /* With the delta list OSTCBDly is the delay at insertion  */
+                                            /* and only tells whether the task is in the list          */
+    struct os_tcb   *OSTCBDlyNext;          /* Pointer to next     TCB in the delay list               */
+    struct os_tcb   *OSTCBDlyPrev;          /* Pointer to previous TCB in the delay list               */
+    INT16U           OSTCBDlyDelta;         /* Ticks after the expiry of the previous TCB in the list  */
+#endif
+#if OS_TASK_PERIODIC_EN > 0
+    INT16U           OSTCBPeriod;           /* Period in ticks, 0 for a task that is not periodic      */
+    INT16U           OSTCBDeadline;         /* Deadline in ticks, relative to the release              */
+    INT32U           OSTCBRelease;          /* OSTime of the current release                           */
+    INT32U           OSTCBJobs;             /* Number of releases so far                               */
+    INT32U           OSTCBMisses;           /* Number of jobs completed after their deadline           */
+#endif
     INT8U            OSTCBStat;             /* Task      status                                        */
     INT8U            OSTCBStatPend;         /* Task PEND status                                        */
     INT8U            OSTCBPrio;             /* Task priority (0 == highest)                            */
@@ -640,11 +813,18 @@ typedef struct os_tcb {
     INT16U           OSTCBBitX;             /* Bit mask to access bit position in ready table          */
     INT16U           OSTCBBitY;             /* Bit mask to access bit position in ready group          */
 #endif
+#if OS_RDY_MASK_EN > 0
+    INT32U           OSTCBBitPrio;          /* Bit mask of the task priority in OSRdyMask              */
+#endif
 
 #if OS_TASK_DEL_EN > 0
     INT8U            OSTCBDelReq;           /* Indicates whether a task needs to delete itself         */
 #endif
 
+#if (OS_MUTEX_EN > 0) && (OS_MUTEX_CEIL_EN > 0)
+    OS_EVENT        *OSTCBCeilTop;          /* Ceiling mutex locked last and still owned, NULL if none */
+#endif
+
 #if OS_TASK_PROFILE_EN > 0
     INT32U           OSTCBCtxSwCtr;         /* Number of time the task was switched in                 */
     INT32U           OSTCBCyclesTot;        /* Total number of clock cycles the task has been running  */
@@ -679,6 +859,9 @@ typedef  struct  os_tmr {
     INT32U           OSTmrMatch;                      /* Timer expires when OSTmrTime == OSTmrMatch                    */
     INT32U           OSTmrDly;                        /* Delay time before periodic update starts                      */
     INT32U           OSTmrPeriod;                     /* Period to repeat timer                                        */
+#if OS_TMR_HIER_EN > 0
+    INT16U           OSTmrSpoke;                      /* Index of the spoke in OSTmrWheelTbl[] holding the timer       */
+#endif
 #if OS_TMR_CFG_NAME_SIZE > 0
     INT8U            OSTmrName[OS_TMR_CFG_NAME_SIZE]; /* Name to give the timer                                        */
 #endif
@@ -691,12 +874,35 @@ typedef  struct  os_tmr {
 
 
 
+#if OS_TMR_HIER_EN > 0                                /* Each spoke of level n covers 2^(n*BITS) timer ticks           */
+#define  OS_TMR_WHEEL_MASK     ((1u << OS_TMR_CFG_WHEEL_BITS) - 1u)
+#define  OS_TMR_WHEEL_SPOKES   (OS_TMR_CFG_WHEEL_LEVELS << OS_TMR_CFG_WHEEL_BITS)
+#else
+#define  OS_TMR_WHEEL_SPOKES   OS_TMR_CFG_WHEEL_SIZE
+#endif
+
 typedef  struct  os_tmr_wheel {
     OS_TMR          *OSTmrFirst;                      /* Pointer to first timer in linked list                         */
     INT16U           OSTmrEntries;
 } OS_TMR_WHEEL;
 #endif
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                          TRACE DATA TYPES
+*********************************************************************************************************
+*/
+
+#if OS_TRACE_EN > 0
+typedef struct os_trace_rec {
+    INT32U           OSTraceTs;             /* Timestamp, OS_TS_GET()                                  */
+    INT8U            OSTraceEvent;          /* Event type (see OS_TRACE_xxx)                           */
+    INT8U            OSTracePrio;           /* Priority of the running task (OSPrioCur)                */
+    INT16U           OSTraceArg;            /* Event specific argument                                 */
+} OS_TRACE_REC;
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -731,7 +937,9 @@ OS_EXT  INT8U             OSLockNesting;            /* Multitasking lock nesting
 OS_EXT  INT8U             OSPrioCur;                /* Priority of current task                        */
 OS_EXT  INT8U             OSPrioHighRdy;            /* Priority of highest priority task               */
 
-#if OS_LOWEST_PRIO <= 63
+#if OS_RDY_MASK_EN > 0
+OS_EXT  INT32U            OSRdyMask;                       /* Bit 'prio' set if the task is ready      */
+#elif OS_LOWEST_PRIO <= 63
 OS_EXT  INT8U             OSRdyGrp;                        /* Ready list group                         */
 OS_EXT  INT8U             OSRdyTbl[OS_RDY_TBL_SIZE];       /* Table of tasks which are ready to run    */
 #else
@@ -752,6 +960,9 @@ OS_EXT  OS_TCB           *OSTCBCur;                        /* Pointer to current
 OS_EXT  OS_TCB           *OSTCBFreeList;                   /* Pointer to list of free TCBs             */
 OS_EXT  OS_TCB           *OSTCBHighRdy;                    /* Pointer to highest priority TCB R-to-R   */
 OS_EXT  OS_TCB           *OSTCBList;                       /* Pointer to doubly linked list of TCBs    */
+#if OS_TICK_DELTA_EN > 0
+OS_EXT  OS_TCB           *OSDlyList;                       /* Pointer to delta-ordered list of delays  */
+#endif
 OS_EXT  OS_TCB           *OSTCBPrioTbl[OS_LOWEST_PRIO + 1];/* Table of pointers to created TCBs        */
 OS_EXT  OS_TCB            OSTCBTbl[OS_MAX_TASKS + OS_N_SYS_TASKS];   /* Table of TCBs                  */
 
@@ -785,7 +996,14 @@ OS_EXT  OS_TMR            OSTmrTbl[OS_TMR_CFG_MAX]; /* Table containing pool of
 OS_EXT  OS_TMR           *OSTmrFreeList;            /* Pointer to free list of timers                  */
 OS_EXT  OS_STK            OSTmrTaskStk[OS_TASK_TMR_STK_SIZE];
 
-OS_EXT  OS_TMR_WHEEL      OSTmrWheelTbl[OS_TMR_CFG_WHEEL_SIZE];
+OS_EXT  OS_TMR_WHEEL      OSTmrWheelTbl[OS_TMR_WHEEL_SPOKES];
+#endif
+
+#if OS_TRACE_EN > 0
+extern  OS_TRACE_REC      OSTraceBuf[OS_TRACE_BUF_SIZE];   /* Trace ring, in SRAM                      */
+OS_EXT  INT32U            OSTraceCtr;               /* Number of records written, the next goes to ... */
+                                                    /* ... OSTraceBuf[OSTraceCtr % OS_TRACE_BUF_SIZE]  */
+OS_EXT  BOOLEAN           OSTraceOn;                /* Records are written while OS_TRUE               */
 #endif
 
 extern  INT8U   const     OSUnMapTbl[256];          /* Priority->Index    lookup table                 */
@@ -975,6 +1193,12 @@ BOOLEAN       OSMutexAccept           (OS_EVENT        *pevent,
 OS_EVENT     *OSMutexCreate           (INT8U            prio,
                                        INT8U           *perr);
 
+#if OS_MUTEX_CEIL_EN > 0
+OS_EVENT     *OSMutexCreateExt        (INT8U            prio,
+                                       INT8U            opt,
+                                       INT8U           *perr);
+#endif
+
 #if OS_MUTEX_DEL_EN > 0
 OS_EVENT     *OSMutexDel              (OS_EVENT        *pevent,
                                        INT8U            opt,
@@ -1054,6 +1278,105 @@ INT8U         OSQQuery                (OS_EVENT        *pevent,
 
 #endif
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                   SINGLE-PRODUCER/SINGLE-CONSUMER RINGS
+*********************************************************************************************************
+*/
+
+#if OS_RING_EN > 0
+
+void          OSRingCreate            (OS_RING         *pring,
+                                       void            *pbuf,
+                                       INT16U           entries,
+                                       INT16U           entry_size,
+                                       INT8U            opt,
+                                       INT8U           *perr);
+
+#if (OS_SEM_EN > 0) && (OS_SEM_DEL_EN > 0)
+void          OSRingDel               (OS_RING         *pring,
+                                       INT8U           *perr);
+#endif
+
+void         *OSRingPutPtr            (OS_RING         *pring,
+                                       INT16U          *pn);
+
+void          OSRingPutCommit         (OS_RING         *pring,
+                                       INT16U           n);
+
+void         *OSRingGetPtr            (OS_RING         *pring,
+                                       INT16U          *pn);
+
+void          OSRingGetRelease        (OS_RING         *pring,
+                                       INT16U           n);
+
+#if OS_SEM_EN > 0
+void         *OSRingPend              (OS_RING         *pring,
+                                       INT16U          *pn,
+                                       INT16U           timeout,
+                                       INT8U           *perr);
+#endif
+
+#define       OSRingCount(pring)      ((INT16U) ((pring)->OSRingIn - (pring)->OSRingOut))
+
+#endif
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                               EVENT SETS
+*********************************************************************************************************
+*/
+
+#if OS_EVSET_EN > 0
+
+void          OSEvSetCreate           (OS_EVSET        *pset,
+                                       INT8U           *perr);
+
+#if OS_SEM_DEL_EN > 0
+void          OSEvSetDel              (OS_EVSET        *pset,
+                                       INT8U           *perr);
+#endif
+
+void          OSEvSetAdd              (OS_EVSET        *pset,
+                                       OS_EVSET_MEMBER *pmember,
+                                       OS_EVENT        *pevent,
+                                       void            *parg,
+                                       INT8U           *perr);
+
+void          OSEvSetRemove           (OS_EVSET_MEMBER *pmember,
+                                       INT8U           *perr);
+
+OS_EVSET_MEMBER *OSEvSetAccept        (OS_EVSET        *pset,
+                                       void           **pmsg);
+
+OS_EVSET_MEMBER *OSEvSetPend          (OS_EVSET        *pset,
+                                       INT16U           timeout,
+                                       void           **pmsg,
+                                       INT8U           *perr);
+
+#endif
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                             DEFERRED WORK
+*********************************************************************************************************
+*/
+
+#if OS_DEFER_EN > 0
+
+void          OSDeferInit             (OS_DEFER        *pwork,
+                                       OS_DEFER_FNCT    fnct,
+                                       void            *parg,
+                                       INT8U            prio,
+                                       INT8U           *perr);
+
+INT8U         OSDeferPost             (OS_DEFER        *pwork);
+
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -1129,6 +1452,21 @@ INT8U         OSTaskCreateExt         (void           (*task)(void *p_arg),
                                        INT16U           opt);
 #endif
 
+#if (OS_TASK_CREATE_EXT_EN > 0) && (OS_TASK_PERIODIC_EN > 0)
+INT8U         OSTaskCreatePeriodic    (void           (*task)(void *p_arg),
+                                       void            *p_arg,
+                                       OS_STK          *ptos,
+                                       INT8U            prio,
+                                       INT16U           id,
+                                       OS_STK          *pbos,
+                                       INT32U           stk_size,
+                                       void            *pext,
+                                       INT16U           opt,
+                                       INT16U           period,
+                                       INT16U           offset,
+                                       INT16U           deadline);
+#endif
+
 #if OS_TASK_DEL_EN > 0
 INT8U         OSTaskDel               (INT8U            prio);
 INT8U         OSTaskDelReq            (INT8U            prio);
@@ -1175,6 +1513,10 @@ INT8U         OSTimeDlyHMSM           (INT8U            hours,
                                        INT16U           milli);
 #endif
 
+#if OS_TASK_PERIODIC_EN > 0
+INT8U         OSTimeDlyPeriod         (void);
+#endif
+
 #if OS_TIME_DLY_RESUME_EN > 0
 INT8U         OSTimeDlyResume         (INT8U            prio);
 #endif
@@ -1186,6 +1528,12 @@ void          OSTimeSet               (INT32U           ticks);
 
 void          OSTimeTick              (void);
 
+#if OS_TICKLESS_EN > 0
+INT16U        OSTimeTickNext          (void);
+
+void          OSTimeTickSkip          (INT16U           ticks);
+#endif
+
 /*
 *********************************************************************************************************
 *                                            TIMER MANAGEMENT
@@ -1246,6 +1594,18 @@ void          OSStart                 (void);
 
 void          OSStatInit              (void);
 
+#if OS_CPU_UTIL_EN > 0
+INT8U         OSCPUUtilQuery          (OS_CPU_UTIL_DATA *p_util_data);
+void          OSCPUUtilPeakReset      (void);
+#endif
+
+#if OS_TRACE_EN > 0
+void          OSTraceRecord           (INT8U            event,
+                                       INT16U           arg);
+void          OSTraceStart            (void);
+void          OSTraceStop             (void);
+#endif
+
 INT16U        OSVersion               (void);
 
 /*$PAGE*/
@@ -1286,6 +1646,53 @@ void          OS_FlagInit             (void);
 void          OS_FlagUnlink           (OS_FLAG_NODE    *pnode);
 #endif
 
+#if OS_TICK_DELTA_EN > 0
+void          OS_DlyInsert            (OS_TCB          *ptcb,
+                                       INT16U           ticks);
+
+void          OS_DlyRemove            (OS_TCB          *ptcb);
+
+#define       OS_DLY_SET(ptcb, ticks)  OS_DlyInsert((ptcb), (ticks))
+#define       OS_DLY_CLR(ptcb)         OS_DlyRemove(ptcb)
+#else
+#define       OS_DLY_SET(ptcb, ticks)  ((ptcb)->OSTCBDly = (ticks))
+#define       OS_DLY_CLR(ptcb)         ((ptcb)->OSTCBDly = 0)
+#endif
+
+#if OS_EVSET_EN > 0                     /* A post stored a count or a message, OS_TRUE to reschedule   */
+BOOLEAN       OS_EvSetSignal          (OS_EVENT        *pevent);
+
+#define       OS_EVSET_SIGNAL(pevent)  (((pevent)->OSEventSetMember != (OS_EVSET_MEMBER *)0) ? \
+                                        OS_EvSetSignal(pevent) : OS_FALSE)
+#else
+#define       OS_EVSET_SIGNAL(pevent)  OS_FALSE
+#endif
+
+#if OS_RDY_MASK_EN > 0                  /* Make a task ready, not ready, or test it in the ready list  */
+#define       OS_RDY_SET(ptcb)         (OSRdyMask |=  (ptcb)->OSTCBBitPrio)
+#define       OS_RDY_CLR(ptcb)         (OSRdyMask &= ~(ptcb)->OSTCBBitPrio)
+#define       OS_RDY_IS_SET(ptcb)      ((OSRdyMask & (ptcb)->OSTCBBitPrio) != 0)
+#else
+#define       OS_RDY_SET(ptcb)         do {                                                        \
+                                           OSRdyGrp               |= (ptcb)->OSTCBBitY;            \
+                                           OSRdyTbl[(ptcb)->OSTCBY] |= (ptcb)->OSTCBBitX;          \
+                                       } while (0)
+#define       OS_RDY_CLR(ptcb)         do {                                                        \
+                                           OSRdyTbl[(ptcb)->OSTCBY] &= ~(ptcb)->OSTCBBitX;         \
+                                           if (OSRdyTbl[(ptcb)->OSTCBY] == 0) {                    \
+                                               OSRdyGrp &= ~(ptcb)->OSTCBBitY;                     \
+                                           }                                                       \
+                                       } while (0)
+#define       OS_RDY_IS_SET(ptcb)      ((OSRdyTbl[(ptcb)->OSTCBY] & (ptcb)->OSTCBBitX) != 0)
+#endif
+
+#if OS_TRACE_EN > 0
+#define       OS_TRACE(event, arg)     OSTraceRecord((event), (INT16U)(arg))
+#define       OS_TRACE_EVENT_IX(pevent) ((INT16U)((pevent) - OSEventTbl))
+#else
+#define       OS_TRACE(event, arg)
+#endif
+
 void          OS_MemClr               (INT8U           *pdest,
                                        INT16U           size);
 
@@ -1316,6 +1723,10 @@ void          OS_TaskIdle             (void            *p_arg);
 void          OS_TaskStat             (void            *p_arg);
 #endif
 
+#if OS_CPU_UTIL_EN > 0
+void          OS_CPUUtilSample        (void);
+#endif
+
 #if (OS_TASK_STAT_STK_CHK_EN > 0) && (OS_TASK_CREATE_EXT_EN > 0)
 void          OS_TaskStkClr           (OS_STK          *pbos,
                                        INT32U           size,
@@ -1338,6 +1749,10 @@ INT8U         OS_TCBInit              (INT8U            prio,
 void          OSTmr_Init              (void);
 #endif
 
+#if OS_DEFER_EN > 0
+void          OS_DeferInit            (void);
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -1549,6 +1964,10 @@ void          OSCtxSw                 (void);
     #ifndef OS_MUTEX_QUERY_EN
     #error  "OS_CFG.H, Missing OS_MUTEX_QUERY_EN: Include code for OSMutexQuery()"
     #endif
+
+    #ifndef OS_MUTEX_CEIL_EN
+    #error  "OS_CFG.H, Missing OS_MUTEX_CEIL_EN: Include code for OSMutexCreateExt() and priority ceiling mutexes"
+    #endif
 #endif
 
 /*
@@ -1670,6 +2089,10 @@ void          OSCtxSw                 (void);
 #error  "OS_CFG.H, Missing OS_TASK_STAT_STK_CHK_EN: Check task stacks from statistics task"
 #endif
 
+#ifndef OS_TASK_STAT_STK_SCAN
+#error  "OS_CFG.H, Missing OS_TASK_STAT_STK_SCAN: Stack elements checked per task by the statistics task"
+#endif
+
 #ifndef OS_TASK_CHANGE_PRIO_EN
 #error  "OS_CFG.H, Missing OS_TASK_CHANGE_PRIO_EN: Include code for OSTaskChangePrio()"
 #endif
@@ -1720,6 +2143,29 @@ void          OSCtxSw                 (void);
 #error  "OS_CFG.H, Missing OS_TIME_GET_SET_EN: Include code for OSTimeGet() and OSTimeSet()"
 #endif
 
+#ifndef OS_TASK_PERIODIC_EN
+#error  "OS_CFG.H, Missing OS_TASK_PERIODIC_EN: Include code for OSTaskCreatePeriodic() and OSTimeDlyPeriod()"
+#elif   OS_TASK_PERIODIC_EN > 0
+    #if     OS_SCHED_LOCK_EN == 0
+    #error  "OS_CFG.H, OSSchedLock() is required (set OS_SCHED_LOCK_EN to 1) when enabling periodic tasks."
+    #endif
+#endif
+
+#ifndef OS_TICK_DELTA_EN
+#error  "OS_CFG.H, Missing OS_TICK_DELTA_EN: Delta-ordered delay list for OSTimeTick()"
+#endif
+
+#ifndef OS_TICKLESS_EN
+#error  "OS_CFG.H, Missing OS_TICKLESS_EN: Tickless idle mode"
+#elif   OS_TICKLESS_EN > 0
+    #if     OS_TICK_DELTA_EN == 0
+    #error  "OS_CFG.H, The delay list is required (set OS_TICK_DELTA_EN to 1) when enabling the tickless idle mode."
+    #endif
+    #if     OS_SCHED_LOCK_EN == 0
+    #error  "OS_CFG.H, OSSchedUnlock() is required (set OS_SCHED_LOCK_EN to 1) when enabling the tickless idle mode."
+    #endif
+#endif
+
 /*
 *********************************************************************************************************
 *                                             TIMER MANAGEMENT
@@ -1758,6 +2204,20 @@ void          OSCtxSw                 (void);
         #endif
     #endif
 
+    #ifndef OS_TMR_HIER_EN
+    #error  "OS_CFG.H, Missing OS_TMR_HIER_EN: Hierarchical timer wheel"
+    #elif   OS_TMR_HIER_EN > 0
+        #if     !defined(OS_TMR_CFG_WHEEL_BITS) || !defined(OS_TMR_CFG_WHEEL_LEVELS)
+        #error  "OS_CFG.H, Missing OS_TMR_CFG_WHEEL_BITS or OS_TMR_CFG_WHEEL_LEVELS: Size of the hierarchical timer wheel"
+        #endif
+        #if     OS_TMR_CFG_WHEEL_BITS < 1 || OS_TMR_CFG_WHEEL_LEVELS < 1 || OS_TMR_CFG_WHEEL_BITS * OS_TMR_CFG_WHEEL_LEVELS > 32
+        #error  "OS_CFG.H, The hierarchical timer wheel needs 1 or more levels of 1 or more bits, 32 bits in total at most"
+        #endif
+        #if     (OS_TMR_CFG_WHEEL_LEVELS << OS_TMR_CFG_WHEEL_BITS) > 1024
+        #error  "OS_CFG.H, The hierarchical timer wheel should have 1024 spokes at most"
+        #endif
+    #endif
+
     #ifndef OS_TMR_CFG_NAME_SIZE
     #error  "OS_CFG.H, Missing OS_TMR_CFG_NAME_SIZE: Determines the number of characters used for Timer names"
     #endif
@@ -1841,6 +2301,67 @@ void          OSCtxSw                 (void);
 #error  "OS_CFG.H, Missing OS_TIME_TICK_HOOK_EN: Allows you to include the code for OSTimeTickHook() or not"
 #endif
 
+
+#ifndef OS_RDY_MASK_EN
+#error  "OS_CFG.H, Missing OS_RDY_MASK_EN: Keep the ready list in a single 32-bit word"
+#elif   OS_RDY_MASK_EN > 0
+    #if     OS_LOWEST_PRIO > 31
+    #error  "OS_CFG.H, OS_RDY_MASK_EN requires OS_LOWEST_PRIO <= 31"
+    #endif
+#endif
+
+
+#ifndef OS_CPU_UTIL_EN
+#error  "OS_CFG.H, Missing OS_CPU_UTIL_EN: CPU utilization from the cycles of the idle task"
+#elif   OS_CPU_UTIL_EN > 0
+    #if     (OS_TASK_STAT_EN == 0) || (OS_TASK_PROFILE_EN == 0)
+    #error  "OS_CFG.H, OS_CPU_UTIL_EN requires OS_TASK_STAT_EN and OS_TASK_PROFILE_EN"
+    #endif
+#endif
+
+
+#ifndef OS_EVSET_EN
+#error  "OS_CFG.H, Missing OS_EVSET_EN: Include code for the event sets"
+#elif   OS_EVSET_EN > 0
+    #if     OS_SEM_EN == 0
+    #error  "OS_CFG.H, OS_EVSET_EN requires OS_SEM_EN"
+    #endif
+#endif
+
+
+#ifndef OS_DEFER_EN
+#error  "OS_CFG.H, Missing OS_DEFER_EN: Include code for the deferred work task"
+#elif   OS_DEFER_EN > 0
+    #if     OS_SEM_EN == 0
+    #error  "OS_CFG.H, OS_DEFER_EN requires OS_SEM_EN"
+    #endif
+    #if     !defined(OS_DEFER_PRIOS) || (OS_DEFER_PRIOS < 1) || (OS_DEFER_PRIOS > 8)
+    #error  "OS_CFG.H, OS_DEFER_PRIOS must be between 1 and 8"
+    #endif
+    #ifndef OS_TASK_DEFER_PRIO
+    #error  "OS_CFG.H, Missing OS_TASK_DEFER_PRIO: Priority of the deferred work task"
+    #elif   OS_TASK_DEFER_PRIO >= OS_TASK_STAT_PRIO
+    #error  "OS_CFG.H, OS_TASK_DEFER_PRIO must be above the statistics task"
+    #endif
+    #if     !defined(OS_TASK_DEFER_STK_SIZE) || (OS_TASK_DEFER_STK_SIZE == 0)
+    #error  "OS_CFG.H, Missing OS_TASK_DEFER_STK_SIZE: Stack of the deferred work task"
+    #endif
+#endif
+
+
+#ifndef OS_RING_EN
+#error  "OS_CFG.H, Missing OS_RING_EN: Include code for the lock-free single-producer/single-consumer rings"
+#endif
+
+
+#ifndef OS_TRACE_EN
+#error  "OS_CFG.H, Missing OS_TRACE_EN: Record kernel events in OSTraceBuf[]"
+#elif   OS_TRACE_EN > 0
+    #if     (OS_TRACE_BUF_SIZE & (OS_TRACE_BUF_SIZE - 1)) != 0
+    #error  "OS_CFG.H, OS_TRACE_BUF_SIZE must be a power of 2"
+    #endif
+#endif
+
 /*
 *********************************************************************************************************
 *                                         SAFETY CRITICAL USE
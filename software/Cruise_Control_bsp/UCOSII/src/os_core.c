@@ -54,6 +54,19 @@ INT8U  const  OSUnMapTbl[256] = {
     4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0        /* 0xF0 to 0xFF                             */
 };
 
+/*
+*********************************************************************************************************
+*                                              TRACE RING
+*
+* Note: The ring is kept in the .sram partition, the off-chip SRAM chip of the board, apart from the SDRAM
+*       that holds the code and the data.
+*********************************************************************************************************
+*/
+
+#if OS_TRACE_EN > 0
+OS_TRACE_REC  OSTraceBuf[OS_TRACE_BUF_SIZE] __attribute__ ((section (".sram")));
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -135,6 +148,7 @@ INT8U  OSEventNameGet (OS_EVENT *pevent, INT8U *pname, INT8U *perr)
     switch (pevent->OSEventType) {
         case OS_EVENT_TYPE_SEM:
         case OS_EVENT_TYPE_MUTEX:
+        case OS_EVENT_TYPE_MUTEX_CEIL:
         case OS_EVENT_TYPE_MBOX:
         case OS_EVENT_TYPE_Q:
              break;
@@ -209,6 +223,7 @@ void  OSEventNameSet (OS_EVENT *pevent, INT8U *pname, INT8U *perr)
     switch (pevent->OSEventType) {
         case OS_EVENT_TYPE_SEM:
         case OS_EVENT_TYPE_MUTEX:
+        case OS_EVENT_TYPE_MUTEX_CEIL:
         case OS_EVENT_TYPE_MBOX:
         case OS_EVENT_TYPE_Q:
              break;
@@ -458,7 +473,7 @@ INT16U  OSEventPendMulti (OS_EVENT **pevents_pend, OS_EVENT **pevents_rdy, void
     OSTCBCur->OSTCBStat     |= events_stat  |           /* Resource not available, ...                 */
                                OS_STAT_MULTI;           /* ... pend on multiple events                 */
     OSTCBCur->OSTCBStatPend  = OS_STAT_PEND_OK;
-    OSTCBCur->OSTCBDly       = timeout;                 /* Store pend timeout in TCB                   */
+    OS_DLY_SET(OSTCBCur, timeout);                      /* Store pend timeout in TCB                   */
     OS_EventTaskWaitMulti(pevents_pend);                /* Suspend task until events or timeout occurs */
 
     OS_EXIT_CRITICAL();
@@ -584,6 +599,10 @@ void  OSInit (void)
     OSTmr_Init();                                                /* Initialize the Timer Manager             */
 #endif
 
+#if OS_DEFER_EN > 0
+    OS_DeferInit();                                              /* Create the Deferred Work Task            */
+#endif
+
     OSInitHookEnd();                                             /* Call port specific init. code            */
 
 #if OS_DEBUG_EN > 0
@@ -625,6 +644,7 @@ void  OSIntEnter (void)
         if (OSIntNesting < 255u) {
             OSIntNesting++;                      /* Increment ISR nesting level                        */
         }
+        OS_TRACE(OS_TRACE_INT_ENTER, OSIntNesting);
         OS_EXIT_CRITICAL();
     }
 }
@@ -658,6 +678,7 @@ void  OSIntExit (void)
 
     if (OSRunning == OS_TRUE) {
         OS_ENTER_CRITICAL();
+        OS_TRACE(OS_TRACE_INT_EXIT, OSIntNesting);
         if (OSIntNesting > 0) {                            /* Prevent OSIntNesting from wrapping       */
             OSIntNesting--;
         }
@@ -842,6 +863,10 @@ void  OSStatInit (void)
 *              as a 'clock tick').  This function should be called by the ticker ISR but, can also be
 *              called by a high priority task.
 *
+*              With OS_TICK_DELTA_EN the delayed tasks are kept in a list ordered by expiry where each
+*              TCB holds its delay relative to the previous one.  A tick then decrements the head of
+*              the list only and removes the tasks that expire, instead of visiting every TCB.
+*
 * Arguments  : none
 *
 * Returns    : none
@@ -893,6 +918,34 @@ void  OSTimeTick (void)
             return;
         }
 #endif
+#if OS_TICK_DELTA_EN > 0
+        OS_ENTER_CRITICAL();
+        ptcb = OSDlyList;                                  /* Point at the first task to expire            */
+        if (ptcb != (OS_TCB *)0) {
+            ptcb->OSTCBDlyDelta--;
+            while (ptcb != (OS_TCB *)0 && ptcb->OSTCBDlyDelta == 0) {
+                OSDlyList = ptcb->OSTCBDlyNext;            /* Remove the expired task from the list        */
+                if (OSDlyList != (OS_TCB *)0) {
+                    OSDlyList->OSTCBDlyPrev = (OS_TCB *)0;
+                }
+                ptcb->OSTCBDlyNext = (OS_TCB *)0;
+                ptcb->OSTCBDly     = 0;
+                                                           /* Check for timeout                            */
+                if ((ptcb->OSTCBStat & OS_STAT_PEND_ANY) != OS_STAT_RDY) {
+                    ptcb->OSTCBStat  &= ~(INT8U)OS_STAT_PEND_ANY;              /* Yes, Clear status flag   */
+                    ptcb->OSTCBStatPend = OS_STAT_PEND_TO;                     /* Indicate PEND timeout    */
+                } else {
+                    ptcb->OSTCBStatPend = OS_STAT_PEND_OK;
+                }
+
+                if ((ptcb->OSTCBStat & OS_STAT_SUSPEND) == OS_STAT_RDY) {      /* Is task suspended?       */
+                    OS_RDY_SET(ptcb);                                          /* No,  Make ready          */
+                }
+                ptcb = OSDlyList;                          /* Tasks with a delta of 0 expire together      */
+            }
+        }
+        OS_EXIT_CRITICAL();
+#else
         ptcb = OSTCBList;                                  /* Point at first TCB in TCB list               */
         while (ptcb->OSTCBPrio != OS_TASK_IDLE_PRIO) {     /* Go through all TCBs in TCB list              */
             OS_ENTER_CRITICAL();
@@ -907,16 +960,228 @@ void  OSTimeTick (void)
                     }
 
                     if ((ptcb->OSTCBStat & OS_STAT_SUSPEND) == OS_STAT_RDY) {  /* Is task suspended?       */
-                        OSRdyGrp               |= ptcb->OSTCBBitY;             /* No,  Make ready          */
-                        OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+                        OS_RDY_SET(ptcb);                                      /* No,  Make ready          */
                     }
                 }
             }
             ptcb = ptcb->OSTCBNext;                        /* Point at next TCB in TCB list                */
             OS_EXIT_CRITICAL();
         }
+#endif
+    }
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                        TICKS TO THE NEXT EXPIRY
+*
+* Description: This function returns the number of ticks until the first delayed task or timeout expires.
+*              The tickless idle mode of the port uses it to decide how long the tick can be stopped.
+*
+* Arguments  : none
+*
+* Returns    : the number of ticks, 0 when no task is delayed
+*
+* Note(s)    : 1) Interrupts must be disabled when calling this function.
+*********************************************************************************************************
+*/
+
+#if OS_TICKLESS_EN > 0
+INT16U  OSTimeTickNext (void)
+{
+    if (OSDlyList == (OS_TCB *)0) {
+        return (0);
+    }
+    return (OSDlyList->OSTCBDlyDelta);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                          SKIP TICKS WITHOUT EXPIRY
+*
+* Description: This function accounts for ticks that passed while the tick interrupt was stopped.  It
+*              advances OSTime and the head of the delay list in O(1), which is valid because the port
+*              stops the tick for fewer ticks than OSTimeTickNext() returned.  The tick that ends the
+*              idle period is processed by OSTimeTick() as usual.
+*
+* Arguments  : ticks    is the number of ticks to skip
+*
+* Returns    : none
+*
+* Note(s)    : 1) Interrupts must be disabled when calling this function.
+*********************************************************************************************************
+*/
+
+void  OSTimeTickSkip (INT16U ticks)
+{
+#if OS_TIME_GET_SET_EN > 0
+    OSTime += ticks;
+#endif
+    if (OSDlyList != (OS_TCB *)0) {
+        if (OSDlyList->OSTCBDlyDelta > ticks) {
+            OSDlyList->OSTCBDlyDelta -= ticks;
+        } else {
+            OSDlyList->OSTCBDlyDelta  = 1;                 /* Late, expire on the next tick                */
+        }
+    }
+}
+#endif
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                    INSERT A TASK IN THE DELAY LIST
+*
+* Description: This function sets the delay of a task and inserts it in the delta-ordered delay list.
+*              The list is walked from the head, subtracting the delays of the tasks that expire
+*              earlier, so the insertion is O(n) in the number of delayed tasks while OSTimeTick() is
+*              O(1) plus the expiring tasks.  A task with the same expiry goes after the tasks already
+*              in the list.
+*
+* Arguments  : ptcb     is a pointer to the TCB of the task
+*
+*              ticks    is the delay in ticks, 0 removes the task from the list
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts must be disabled when calling this function.
+*********************************************************************************************************
+*/
+
+#if OS_TICK_DELTA_EN > 0
+void  OS_DlyInsert (OS_TCB *ptcb, INT16U ticks)
+{
+    OS_TCB  *pprev;
+    OS_TCB  *pnext;
+
+
+    OS_DlyRemove(ptcb);                                    /* A task is in the list at most once           */
+    if (ticks == 0) {
+        return;
+    }
+    ptcb->OSTCBDly = ticks;
+
+    pprev = (OS_TCB *)0;
+    pnext = OSDlyList;
+    while (pnext != (OS_TCB *)0 && pnext->OSTCBDlyDelta <= ticks) {
+        ticks -= pnext->OSTCBDlyDelta;                     /* Skip the tasks that expire no later          */
+        pprev  = pnext;
+        pnext  = pnext->OSTCBDlyNext;
+    }
+
+    ptcb->OSTCBDlyDelta = ticks;
+    ptcb->OSTCBDlyPrev  = pprev;
+    ptcb->OSTCBDlyNext  = pnext;
+    if (pnext != (OS_TCB *)0) {
+        pnext->OSTCBDlyDelta -= ticks;                     /* The next task now expires after this one     */
+        pnext->OSTCBDlyPrev   = ptcb;
+    }
+    if (pprev != (OS_TCB *)0) {
+        pprev->OSTCBDlyNext = ptcb;
+    } else {
+        OSDlyList = ptcb;
+    }
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                   REMOVE A TASK FROM THE DELAY LIST
+*
+* Description: This function clears the delay of a task and unlinks it from the delay list in O(1).  The
+*              remaining delta is added to the next task, so its expiry does not change.
+*
+* Arguments  : ptcb     is a pointer to the TCB of the task
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) Interrupts must be disabled when calling this function.
+*********************************************************************************************************
+*/
+
+void  OS_DlyRemove (OS_TCB *ptcb)
+{
+    OS_TCB  *pnext;
+
+
+    if (ptcb->OSTCBDly == 0) {                             /* Not in the delay list                        */
+        return;
+    }
+    ptcb->OSTCBDly = 0;
+
+    pnext = ptcb->OSTCBDlyNext;
+    if (pnext != (OS_TCB *)0) {
+        pnext->OSTCBDlyDelta += ptcb->OSTCBDlyDelta;
+        pnext->OSTCBDlyPrev   = ptcb->OSTCBDlyPrev;
+    }
+    if (ptcb->OSTCBDlyPrev != (OS_TCB *)0) {
+        ptcb->OSTCBDlyPrev->OSTCBDlyNext = pnext;
+    } else {
+        OSDlyList = pnext;
     }
+    ptcb->OSTCBDlyNext = (OS_TCB *)0;
+    ptcb->OSTCBDlyPrev = (OS_TCB *)0;
 }
+#endif
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                          RECORD A TRACE EVENT
+*
+* Description: This function writes one record to the trace ring, overwriting the oldest record when the
+*              ring is full.  It is called by the kernel and the port through OS_TRACE() and may be called
+*              by the application with its own event codes (above OS_TRACE_TMR_EXPIRE).
+*
+* Arguments  : event     is the event type (see OS_TRACE_xxx).
+*
+*              arg       is an event specific argument.
+*
+* Returns    : none
+*
+* Notes      : 1) The ring holds the last OS_TRACE_BUF_SIZE records.  OSTraceCtr counts all records, so
+*                 OSTraceCtr - OS_TRACE_BUF_SIZE records were lost when it is larger than the ring.
+*              2) OSTraceStop() freezes the ring, e.g. to dump it after an overload, and OSTraceStart()
+*                 resumes the recording.
+*********************************************************************************************************
+*/
+
+#if OS_TRACE_EN > 0
+void  OSTraceRecord (INT8U event, INT16U arg)
+{
+    OS_TRACE_REC  *prec;
+#if OS_CRITICAL_METHOD == 3                                /* Allocate storage for CPU status register */
+    OS_CPU_SR      cpu_sr = 0;
+#endif
+
+
+
+    OS_ENTER_CRITICAL();
+    if (OSTraceOn == OS_TRUE) {
+        prec               = &OSTraceBuf[OSTraceCtr & (OS_TRACE_BUF_SIZE - 1)];
+        prec->OSTraceTs    = OS_TS_GET();
+        prec->OSTraceEvent = event;
+        prec->OSTracePrio  = OSPrioCur;
+        prec->OSTraceArg   = arg;
+        OSTraceCtr++;
+    }
+    OS_EXIT_CRITICAL();
+}
+
+void  OSTraceStart (void)
+{
+    OSTraceOn = OS_TRUE;
+}
+
+void  OSTraceStop (void)
+{
+    OSTraceOn = OS_FALSE;
+}
+#endif
 
 /*$PAGE*/
 /*
@@ -1017,7 +1282,7 @@ INT8U  OS_EventTaskRdy (OS_EVENT *pevent, void *pmsg, INT8U msk, INT8U pend_stat
 #endif
 
     ptcb                  =  OSTCBPrioTbl[prio];        /* Point to this task's OS_TCB                 */
-    ptcb->OSTCBDly        =  0;                         /* Prevent OSTimeTick() from readying task     */
+    OS_DLY_CLR(ptcb);                                   /* Prevent OSTimeTick() from readying task     */
 #if ((OS_Q_EN > 0) && (OS_MAX_QS > 0)) || (OS_MBOX_EN > 0)
     ptcb->OSTCBMsg        =  pmsg;                      /* Send message directly to waiting task       */
 #else
@@ -1027,8 +1292,7 @@ INT8U  OS_EventTaskRdy (OS_EVENT *pevent, void *pmsg, INT8U msk, INT8U pend_stat
     ptcb->OSTCBStatPend   =  pend_stat;                 /* Set pend status of post or abort            */
                                                         /* See if task is ready (could be susp'd)      */
     if ((ptcb->OSTCBStat &   OS_STAT_SUSPEND) == OS_STAT_RDY) {
-        OSRdyGrp         |=  ptcb->OSTCBBitY;           /* Put task in the ready to run list           */
-        OSRdyTbl[y]      |=  ptcb->OSTCBBitX;
+        OS_RDY_SET(ptcb);                               /* Put task in the ready to run list           */
     }
 
     OS_EventTaskRemove(ptcb, pevent);                   /* Remove this task from event   wait list     */
@@ -1060,19 +1324,12 @@ INT8U  OS_EventTaskRdy (OS_EVENT *pevent, void *pmsg, INT8U msk, INT8U pend_stat
 #if (OS_EVENT_EN)
 void  OS_EventTaskWait (OS_EVENT *pevent)
 {
-    INT8U  y;
-
-
     OSTCBCur->OSTCBEventPtr               = pevent;                 /* Store ptr to ECB in TCB         */
 
     pevent->OSEventTbl[OSTCBCur->OSTCBY] |= OSTCBCur->OSTCBBitX;    /* Put task in waiting list        */
     pevent->OSEventGrp                   |= OSTCBCur->OSTCBBitY;
 
-    y             =  OSTCBCur->OSTCBY;            /* Task no longer ready                              */
-    OSRdyTbl[y]  &= ~OSTCBCur->OSTCBBitX;
-    if (OSRdyTbl[y] == 0) {
-        OSRdyGrp &= ~OSTCBCur->OSTCBBitY;         /* Clear event grp bit if this was only task pending */
-    }
+    OS_RDY_CLR(OSTCBCur);                         /* Task no longer ready                              */
 }
 #endif
 /*$PAGE*/
@@ -1096,7 +1353,6 @@ void  OS_EventTaskWaitMulti (OS_EVENT **pevents_wait)
 {
     OS_EVENT **pevents;
     OS_EVENT  *pevent;
-    INT8U      y;
 
 
     OSTCBCur->OSTCBEventPtr      = (OS_EVENT  *)0;
@@ -1111,11 +1367,7 @@ void  OS_EventTaskWaitMulti (OS_EVENT **pevents_wait)
         pevent = *pevents;
     }
 
-    y             =  OSTCBCur->OSTCBY;            /* Task no longer ready                              */
-    OSRdyTbl[y]  &= ~OSTCBCur->OSTCBBitX;
-    if (OSRdyTbl[y] == 0) {
-        OSRdyGrp &= ~OSTCBCur->OSTCBBitY;         /* Clear event grp bit if this was only task pending */
-    }
+    OS_RDY_CLR(OSTCBCur);                         /* Task no longer ready                              */
 }
 #endif
 /*$PAGE*/
@@ -1221,6 +1473,9 @@ void  OS_EventWaitListInit (OS_EVENT *pevent)
 
 
     pevent->OSEventGrp = 0;                      /* No task waiting on event                           */
+#if OS_EVSET_EN > 0
+    pevent->OSEventSetMember = (OS_EVSET_MEMBER *)0; /* Not in an event set                            */
+#endif
     ptbl               = &pevent->OSEventTbl[0];
 
     for (i = 0; i < OS_EVENT_TBL_SIZE; i++) {
@@ -1310,6 +1565,13 @@ static  void  OS_InitMisc (void)
     OSRunning     = OS_FALSE;                              /* Indicate that multitasking not started   */
 
     OSCtxSwCtr    = 0;                                     /* Clear the context switch counter         */
+#if OS_TRACE_EN > 0
+    OSTraceCtr    = 0;                                     /* Empty trace, recording from the start    */
+    OSTraceOn     = OS_TRUE;
+#endif
+#if OS_TICK_DELTA_EN > 0
+    OSDlyList     = (OS_TCB *)0;                           /* No task is delayed                       */
+#endif
     OSIdleCtr     = 0L;                                    /* Clear the 32-bit idle counter            */
 
 #if OS_TASK_STAT_EN > 0
@@ -1334,6 +1596,9 @@ static  void  OS_InitMisc (void)
 
 static  void  OS_InitRdyList (void)
 {
+#if OS_RDY_MASK_EN > 0
+    OSRdyMask     = 0;                                     /* Clear the ready list                     */
+#else
     INT8U    i;
 #if OS_LOWEST_PRIO <= 63
     INT8U   *prdytbl;
@@ -1347,6 +1612,7 @@ static  void  OS_InitRdyList (void)
     for (i = 0; i < OS_RDY_TBL_SIZE; i++) {
         *prdytbl++ = 0;
     }
+#endif
 
     OSPrioCur     = 0;
     OSPrioHighRdy = 0;
@@ -1646,12 +1912,26 @@ void  OS_Sched (void)
 *
 * Notes      : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
 *              2) Interrupts are assumed to be disabled when this function is called.
+*              3) With OS_RDY_MASK_EN the highest priority is the index of the lowest bit set in OSRdyMask.
+*                 The Nios II has no count-leading-zeros instruction, a multiply (de Bruijn) is a library
+*                 call on the /e core and its shifts take one cycle per bit, so the index is built from
+*                 five mask tests, each turned into 0 or a power of 2 without a branch or a shift.
 *********************************************************************************************************
 */
 
 static  void  OS_SchedNew (void)
 {
-#if OS_LOWEST_PRIO <= 63                         /* See if we support up to 64 tasks                   */
+#if OS_RDY_MASK_EN > 0                           /* Ready list in a single word                        */
+    INT32U  bit;
+
+
+    bit           = OSRdyMask & (0u - OSRdyMask);  /* Lowest bit set, never 0: the idle task is ready */
+    OSPrioHighRdy = (INT8U)(((0u - (INT32U)((bit & 0xFFFF0000uL) != 0)) & 16u)
+                          | ((0u - (INT32U)((bit & 0xFF00FF00uL) != 0)) &  8u)
+                          | ((0u - (INT32U)((bit & 0xF0F0F0F0uL) != 0)) &  4u)
+                          | ((0u - (INT32U)((bit & 0xCCCCCCCCuL) != 0)) &  2u)
+                          | ((0u - (INT32U)((bit & 0xAAAAAAAAuL) != 0)) &  1u));
+#elif OS_LOWEST_PRIO <= 63                       /* See if we support up to 64 tasks                   */
     INT8U   y;
 
 
@@ -1802,13 +2082,15 @@ void  OS_TaskIdle (void *p_arg)
 *              2) You can disable this task by setting the configuration #define OS_TASK_STAT_EN to 0.
 *              3) You MUST have at least a delay of 2/10 seconds to allow for the system to establish the
 *                 maximum value for the idle counter.
+*              4) With OS_CPU_UTIL_EN, the CPU usage is measured from the cycles of the idle task instead
+*                 of the idle counter, see OS_CPUUtilSample().
 *********************************************************************************************************
 */
 
 #if OS_TASK_STAT_EN > 0
 void  OS_TaskStat (void *p_arg)
 {
-#if OS_CRITICAL_METHOD == 3                      /* Allocate storage for CPU status register           */
+#if (OS_CRITICAL_METHOD == 3) && (OS_CPU_UTIL_EN == 0)   /* Allocate storage for CPU status register   */
     OS_CPU_SR  cpu_sr = 0;
 #endif
 
@@ -1818,17 +2100,23 @@ void  OS_TaskStat (void *p_arg)
     while (OSStatRdy == OS_FALSE) {
         OSTimeDly(2 * OS_TICKS_PER_SEC / 10);    /* Wait until statistic task is ready                 */
     }
+#if OS_CPU_UTIL_EN == 0
     OSIdleCtrMax /= 100L;
     if (OSIdleCtrMax == 0L) {
         OSCPUUsage = 0;
         (void)OSTaskSuspend(OS_PRIO_SELF);
     }
+#endif
     for (;;) {
+#if OS_CPU_UTIL_EN > 0
+        OS_CPUUtilSample();                      /* Close the window of the past 1/10 second           */
+#else
         OS_ENTER_CRITICAL();
         OSIdleCtrRun = OSIdleCtr;                /* Obtain the of the idle counter for the past second */
         OSIdleCtr    = 0L;                       /* Reset the idle counter for the next second         */
         OS_EXIT_CRITICAL();
         OSCPUUsage   = (INT8U)(100L - OSIdleCtrRun / OSIdleCtrMax);
+#endif
         OSTaskStatHook();                        /* Invoke user definable hook                         */
 #if (OS_TASK_STAT_STK_CHK_EN > 0) && (OS_TASK_CREATE_EXT_EN > 0)
         OS_TaskStatStkChk();                     /* Check the stacks for each task                     */
@@ -1844,13 +2132,88 @@ void  OS_TaskStat (void *p_arg)
 *
 * Description: This function is called by OS_TaskStat() to check the stacks of each active task.
 *
+*              With OS_TASK_STAT_STK_SCAN > 0 each call checks that many stack elements of each task,
+*              sweeping from the bottom of the stack up to the watermark kept in OSTCBStkFree.  A used
+*              element lowers the watermark and starts the next sweep from the bottom, so a deeper use
+*              is seen within OSTCBStkFree / OS_TASK_STAT_STK_SCAN calls.  Otherwise the whole free part
+*              of each stack is scanned by OSTaskStkChk() on every call.
+*
 * Arguments  : none
 *
 * Returns    : none
+*
+* Notes      : 1) The elements are read with interrupts enabled, like in OSTaskStkChk().
 *********************************************************************************************************
 */
 
 #if (OS_TASK_STAT_STK_CHK_EN > 0) && (OS_TASK_CREATE_EXT_EN > 0)
+#if OS_TASK_STAT_STK_SCAN > 0
+void  OS_TaskStatStkChk (void)
+{
+    OS_TCB      *ptcb;
+    OS_STK      *pbos;
+    OS_STK      *pchk;
+    INT32U       nfree;
+    INT32U       ix;
+    INT16U       n;
+    INT8U        prio;
+#if OS_CRITICAL_METHOD == 3                                          /* Storage for CPU status register */
+    OS_CPU_SR    cpu_sr = 0;
+#endif
+
+
+
+    for (prio = 0; prio <= OS_TASK_IDLE_PRIO; prio++) {
+        OS_ENTER_CRITICAL();
+        ptcb = OSTCBPrioTbl[prio];
+        if (ptcb == (OS_TCB *)0 || ptcb == OS_TCB_RESERVED) {
+            OS_EXIT_CRITICAL();
+            continue;
+        }
+        if ((ptcb->OSTCBOpt & OS_TASK_OPT_STK_CHK) == 0) {
+            OS_EXIT_CRITICAL();
+            continue;
+        }
+        pbos  = ptcb->OSTCBStkBottom;
+        nfree = ptcb->OSTCBStkFree;
+        ix    = ptcb->OSTCBStkScan;
+        OS_EXIT_CRITICAL();
+#if OS_STK_GROWTH == 1
+        pchk  = pbos + ix;
+#else
+        pchk  = pbos - ix;
+#endif
+        for (n = OS_TASK_STAT_STK_SCAN; n > 0 && ix < nfree; n--) {
+#if OS_STK_GROWTH == 1
+            if (*pchk++ != (OS_STK)0) {
+#else
+            if (*pchk-- != (OS_STK)0) {
+#endif
+                nfree = ix;                                          /* Lower the watermark            */
+                break;
+            }
+            ix++;
+        }
+        if (ix >= nfree) {                                           /* Sweep again from the bottom    */
+            ix = 0L;
+        }
+        OS_ENTER_CRITICAL();
+        if (OSTCBPrioTbl[prio] == ptcb && ptcb->OSTCBStkBottom == pbos) {  /* Still the same task?     */
+            ptcb->OSTCBStkFree = nfree;
+            ptcb->OSTCBStkScan = ix;
+#if OS_TASK_PROFILE_EN > 0
+            #if OS_STK_GROWTH == 1
+            ptcb->OSTCBStkBase = ptcb->OSTCBStkBottom + ptcb->OSTCBStkSize;
+            #else
+            ptcb->OSTCBStkBase = ptcb->OSTCBStkBottom - ptcb->OSTCBStkSize;
+            #endif
+            ptcb->OSTCBStkUsed = (ptcb->OSTCBStkSize - nfree) * sizeof(OS_STK);
+#endif
+        }
+        OS_EXIT_CRITICAL();
+    }
+}
+#else
 void  OS_TaskStatStkChk (void)
 {
     OS_TCB      *ptcb;
@@ -1879,6 +2242,7 @@ void  OS_TaskStatStkChk (void)
     }
 }
 #endif
+#endif
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -1942,6 +2306,18 @@ INT8U  OS_TCBInit (INT8U prio, OS_STK *ptos, OS_STK *pbos, INT16U id, INT32U stk
         ptcb->OSTCBStat          = OS_STAT_RDY;            /* Task is ready to run                     */
         ptcb->OSTCBStatPend      = OS_STAT_PEND_OK;        /* Clear pend status                        */
         ptcb->OSTCBDly           = 0;                      /* Task is not delayed                      */
+#if OS_TICK_DELTA_EN > 0
+        ptcb->OSTCBDlyNext       = (OS_TCB *)0;
+        ptcb->OSTCBDlyPrev       = (OS_TCB *)0;
+        ptcb->OSTCBDlyDelta      = 0;
+#endif
+#if OS_TASK_PERIODIC_EN > 0
+        ptcb->OSTCBPeriod        = 0;                      /* Task is not periodic                     */
+        ptcb->OSTCBDeadline      = 0;
+        ptcb->OSTCBRelease       = 0;
+        ptcb->OSTCBJobs          = 0;
+        ptcb->OSTCBMisses        = 0;
+#endif
 
 #if OS_TASK_CREATE_EXT_EN > 0
         ptcb->OSTCBExtPtr        = pext;                   /* Store pointer to TCB extension           */
@@ -1949,6 +2325,10 @@ INT8U  OS_TCBInit (INT8U prio, OS_STK *ptos, OS_STK *pbos, INT16U id, INT32U stk
         ptcb->OSTCBStkBottom     = pbos;                   /* Store pointer to bottom of stack         */
         ptcb->OSTCBOpt           = opt;                    /* Store task options                       */
         ptcb->OSTCBId            = id;                     /* Store task ID                            */
+#if (OS_TASK_STAT_STK_CHK_EN > 0) && (OS_TASK_STAT_STK_SCAN > 0)
+        ptcb->OSTCBStkFree       = stk_size;               /* No stack used yet                        */
+        ptcb->OSTCBStkScan       = 0L;
+#endif
 #else
         pext                     = pext;                   /* Prevent compiler warning if not used     */
         stk_size                 = stk_size;
@@ -1961,6 +2341,10 @@ INT8U  OS_TCBInit (INT8U prio, OS_STK *ptos, OS_STK *pbos, INT16U id, INT32U stk
         ptcb->OSTCBDelReq        = OS_ERR_NONE;
 #endif
 
+#if (OS_MUTEX_EN > 0) && (OS_MUTEX_CEIL_EN > 0)
+        ptcb->OSTCBCeilTop       = (OS_EVENT *)0;          /* Owns no ceiling mutex                    */
+#endif
+
 #if OS_LOWEST_PRIO <= 63
         ptcb->OSTCBY             = (INT8U)(prio >> 3);          /* Pre-compute X, Y, BitX and BitY     */
         ptcb->OSTCBX             = (INT8U)(prio & 0x07);
@@ -1972,6 +2356,9 @@ INT8U  OS_TCBInit (INT8U prio, OS_STK *ptos, OS_STK *pbos, INT16U id, INT32U stk
         ptcb->OSTCBBitY          = (INT16U)(1 << ptcb->OSTCBY);
         ptcb->OSTCBBitX          = (INT16U)(1 << ptcb->OSTCBX);
 #endif
+#if OS_RDY_MASK_EN > 0
+        ptcb->OSTCBBitPrio       = (INT32U)1 << prio;
+#endif
 
 #if (OS_EVENT_EN)
         ptcb->OSTCBEventPtr      = (OS_EVENT  *)0;         /* Task is not pending on an  event         */
@@ -2013,8 +2400,7 @@ INT8U  OS_TCBInit (INT8U prio, OS_STK *ptos, OS_STK *pbos, INT16U id, INT32U stk
             OSTCBList->OSTCBPrev = ptcb;
         }
         OSTCBList               = ptcb;
-        OSRdyGrp               |= ptcb->OSTCBBitY;         /* Make task ready to run                   */
-        OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+        OS_RDY_SET(ptcb);                                  /* Make task ready to run                   */
         OSTaskCtr++;                                       /* Increment the #tasks counter             */
         OS_EXIT_CRITICAL();
         return (OS_ERR_NONE);
@@ -87,7 +87,11 @@ INT16U  const  OSQSize             = sizeof(OS_Q);              /* Size in bytes
 INT16U  const  OSQSize             = 0;
 #endif
 
+#if OS_RDY_MASK_EN > 0
+INT16U  const  OSRdyTblSize        = sizeof(OSRdyMask);         /* Number of bytes in the ready table  */
+#else
 INT16U  const  OSRdyTblSize        = OS_RDY_TBL_SIZE;           /* Number of bytes in the ready table  */
+#endif
 
 INT16U  const  OSSemEn             = OS_SEM_EN;
 
@@ -114,7 +118,11 @@ INT16U  const  OSVersionNbr        = OS_VERSION;
 INT16U  const  OSTmrEn             = OS_TMR_EN;
 INT16U  const  OSTmrCfgMax         = OS_TMR_CFG_MAX;
 INT16U  const  OSTmrCfgNameSize    = OS_TMR_CFG_NAME_SIZE;
+#if (OS_TMR_EN > 0) && (OS_TMR_HIER_EN > 0)
+INT16U  const  OSTmrCfgWheelSize   = OS_TMR_WHEEL_SPOKES;       /* Spokes of all the levels            */
+#else
 INT16U  const  OSTmrCfgWheelSize   = OS_TMR_CFG_WHEEL_SIZE;
+#endif
 INT16U  const  OSTmrCfgTicksPerSec = OS_TMR_CFG_TICKS_PER_SEC;
 
 #if (OS_TMR_EN > 0) && (OS_TMR_CFG_MAX > 0)
@@ -185,8 +193,12 @@ INT16U  const  OSDataSize = sizeof(OSCtxSwCtr)
                           + sizeof(OSLockNesting)
                           + sizeof(OSPrioCur)
                           + sizeof(OSPrioHighRdy)
+#if OS_RDY_MASK_EN > 0
+                          + sizeof(OSRdyMask)
+#else
                           + sizeof(OSRdyGrp)
                           + sizeof(OSRdyTbl)
+#endif
                           + sizeof(OSRunning)
                           + sizeof(OSTaskCtr)
                           + sizeof(OSIdleCtr)
@@ -0,0 +1,300 @@
+/*
+*********************************************************************************************************
+*                                                uC/OS-II
+*                                          The Real-Time Kernel
+*                                             DEFERRED WORK
+*
+* File    : OS_DEFER.C
+* Version : V2.86
+*
+* An interrupt handler should only take the data from its device and leave the rest of the work, which
+* runs with interrupts disabled on this port, to a task.  OSDeferPost() queues a work item in O(1), from
+* an interrupt handler or from a task, and the deferred work task at OS_TASK_DEFER_PRIO calls the function
+* of each queued item with interrupts enabled.  The task wakes up once for a batch: it runs the items
+* until the queues are empty, the lowest item priority first and the items of a priority in the order
+* of their posts.
+*
+* An item is queued only once.  A post of an item that is still queued only increments its count, the
+* function receives the number of posts since its last run, e.g. to skip the work of the older ones.
+* An item posted while its function runs is queued again and runs once more.
+*********************************************************************************************************
+*/
+
+#ifndef  OS_MASTER_FILE
+#include <ucos_ii.h>
+#endif
+
+#if OS_DEFER_EN > 0
+/*
+*********************************************************************************************************
+*                                            LOCAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  OS_DEFER  *OSDeferHead[OS_DEFER_PRIOS];    /* Queued items of each priority                    */
+static  OS_DEFER  *OSDeferTail[OS_DEFER_PRIOS];
+static  INT8U      OSDeferRdy;                     /* Bit n is set while priority n holds items        */
+static  BOOLEAN    OSDeferIdle;                    /* The task waits on OSDeferSem for the next post   */
+static  OS_EVENT  *OSDeferSem;
+static  OS_STK     OSDeferTaskStk[OS_TASK_DEFER_STK_SIZE];
+
+static  void  OS_DeferTask(void *p_arg);
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                        INITIALIZE A WORK ITEM
+*
+* Description: This function prepares a work item for OSDeferPost().
+*
+* Arguments  : pwork         is a pointer to the work item
+*
+*              fnct          is the function the deferred work task calls for the item.  It runs with
+*                            interrupts enabled and receives 'parg' and the number of posts since its
+*                            last run.
+*
+*              parg          is the argument of 'fnct'
+*
+*              prio          is the priority of the item, from 0 (runs first) to OS_DEFER_PRIOS - 1
+*
+*              perr          is a pointer to an error code:
+*                            OS_ERR_NONE           the item is ready to be posted
+*                            OS_ERR_PDATA_NULL     'pwork' or 'fnct' is a NULL pointer
+*                            OS_ERR_PRIO_INVALID   'prio' is not below OS_DEFER_PRIOS
+*                            OS_ERR_DEFER_QUEUED   the item is queued and cannot be changed
+*
+* Returns    : none
+*********************************************************************************************************
+*/
+
+void  OSDeferInit (OS_DEFER *pwork, OS_DEFER_FNCT fnct, void *parg, INT8U prio, INT8U *perr)
+{
+#if OS_ARG_CHK_EN > 0
+    if (perr == (INT8U *)0) {                              /* Validate 'perr'                          */
+        return;
+    }
+    if (pwork == (OS_DEFER *)0 || fnct == (OS_DEFER_FNCT)0) {
+        *perr = OS_ERR_PDATA_NULL;
+        return;
+    }
+    if (prio >= OS_DEFER_PRIOS) {
+        *perr = OS_ERR_PRIO_INVALID;
+        return;
+    }
+#endif
+    if (pwork->OSDeferQueued == OS_TRUE) {                 /* Still linked in a queue                  */
+        *perr = OS_ERR_DEFER_QUEUED;
+        return;
+    }
+    pwork->OSDeferNext   = (OS_DEFER *)0;
+    pwork->OSDeferFnct   = fnct;
+    pwork->OSDeferArg    = parg;
+    pwork->OSDeferPrio   = prio;
+    pwork->OSDeferQueued = OS_FALSE;
+    pwork->OSDeferCnt    = 0;
+    pwork->OSDeferStamp  = 0L;
+    pwork->OSDeferPosts  = 0L;
+    pwork->OSDeferRuns   = 0L;
+    pwork->OSDeferLatMax = 0L;
+    *perr                = OS_ERR_NONE;
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                           POST A WORK ITEM
+*
+* Description: This function queues a work item for the deferred work task.  If the item is already
+*              queued, the post is counted into its next run.  It may be called from an interrupt
+*              handler.
+*
+* Arguments  : pwork         is a pointer to a work item prepared by OSDeferInit()
+*
+* Returns    : OS_ERR_NONE         the item is queued
+*              OS_ERR_PDATA_NULL   'pwork' is a NULL pointer
+*
+* Note(s)    : 1) Only the first post into empty queues signals the task, the others find it busy.
+*********************************************************************************************************
+*/
+
+INT8U  OSDeferPost (OS_DEFER *pwork)
+{
+    INT8U      prio;
+    BOOLEAN    signal;
+#if OS_CRITICAL_METHOD == 3                                /* Allocate storage for CPU status register */
+    OS_CPU_SR  cpu_sr = 0;
+#endif
+
+
+
+#if OS_ARG_CHK_EN > 0
+    if (pwork == (OS_DEFER *)0) {                          /* Validate 'pwork'                         */
+        return (OS_ERR_PDATA_NULL);
+    }
+#endif
+    signal = OS_FALSE;
+    OS_ENTER_CRITICAL();
+    pwork->OSDeferPosts++;
+    if (pwork->OSDeferCnt < 65535u) {
+        pwork->OSDeferCnt++;
+    }
+    if (pwork->OSDeferQueued == OS_FALSE) {                /* Append the item to its queue             */
+        prio                 = pwork->OSDeferPrio;
+        pwork->OSDeferQueued = OS_TRUE;
+        pwork->OSDeferStamp  = OS_TS_GET();
+        pwork->OSDeferNext   = (OS_DEFER *)0;
+        if (OSDeferTail[prio] == (OS_DEFER *)0) {
+            OSDeferHead[prio] = pwork;
+        } else {
+            OSDeferTail[prio]->OSDeferNext = pwork;
+        }
+        OSDeferTail[prio] = pwork;
+        OSDeferRdy       |= (INT8U)(1u << prio);
+        if (OSDeferIdle == OS_TRUE) {
+            OSDeferIdle = OS_FALSE;
+            signal      = OS_TRUE;
+        }
+    }
+    OS_EXIT_CRITICAL();
+    if (signal == OS_TRUE) {
+        (void)OSSemPost(OSDeferSem);
+    }
+    return (OS_ERR_NONE);
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                          DEFERRED WORK TASK
+*
+* Description: This task takes the queued items one at a time and calls their functions.  It waits on
+*              OSDeferSem when the queues are empty.
+*
+* Arguments  : p_arg         is not used
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to this file.
+*              2) The highest queued priority is taken again before each item, so an item posted
+*                 during a batch runs before the items of lower priority that are still queued.
+*********************************************************************************************************
+*/
+
+static  void  OS_DeferTask (void *p_arg)
+{
+    OS_DEFER  *pwork;
+    INT8U      prio;
+    INT16U     cnt;
+    INT32U     lat;
+    INT8U      err;
+#if OS_CRITICAL_METHOD == 3                                /* Allocate storage for CPU status register */
+    OS_CPU_SR  cpu_sr = 0;
+#endif
+
+
+
+    (void)p_arg;                                           /* Prevent compiler warning                 */
+    for (;;) {
+        OS_ENTER_CRITICAL();
+        if (OSDeferRdy == 0) {                             /* Queues empty, wait for the next post     */
+            OSDeferIdle = OS_TRUE;
+            OS_EXIT_CRITICAL();
+            OSSemPend(OSDeferSem, 0, &err);
+            continue;
+        }
+        prio              = OSUnMapTbl[OSDeferRdy];
+        pwork             = OSDeferHead[prio];
+        OSDeferHead[prio] = pwork->OSDeferNext;
+        if (OSDeferHead[prio] == (OS_DEFER *)0) {
+            OSDeferTail[prio] = (OS_DEFER *)0;
+            OSDeferRdy       &= (INT8U)~(1u << prio);
+        }
+        pwork->OSDeferQueued = OS_FALSE;
+        cnt                  = pwork->OSDeferCnt;
+        pwork->OSDeferCnt    = 0;
+        lat                  = OS_TS_GET() - pwork->OSDeferStamp;
+        OS_EXIT_CRITICAL();
+
+        pwork->OSDeferRuns++;
+        if (lat > pwork->OSDeferLatMax) {
+            pwork->OSDeferLatMax = lat;
+        }
+        (*pwork->OSDeferFnct)(pwork->OSDeferArg, cnt);
+    }
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                   INITIALIZE THE DEFERRED WORK TASK
+*
+* Description: This function is called by OSInit() to create the deferred work task and its semaphore.
+*
+* Arguments  : none
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*********************************************************************************************************
+*/
+
+void  OS_DeferInit (void)
+{
+#if (OS_EVENT_NAME_SIZE > 8) || (OS_TASK_NAME_SIZE > 8)
+    INT8U  err;
+#endif
+
+
+
+    OSDeferRdy  = 0;
+    OSDeferIdle = OS_FALSE;                                /* The task looks at the queues first       */
+    OSDeferSem  = OSSemCreate(0);
+#if OS_EVENT_NAME_SIZE > 14
+    OSEventNameSet(OSDeferSem, (INT8U *)"uC/OS-II Defer", &err);
+#else
+#if OS_EVENT_NAME_SIZE > 8
+    OSEventNameSet(OSDeferSem, (INT8U *)"OS-Defer", &err);
+#endif
+#endif
+
+#if OS_TASK_CREATE_EXT_EN > 0
+    #if OS_STK_GROWTH == 1
+    (void)OSTaskCreateExt(OS_DeferTask,
+                          (void *)0,
+                          &OSDeferTaskStk[OS_TASK_DEFER_STK_SIZE - 1],     /* Set Top-Of-Stack                        */
+                          OS_TASK_DEFER_PRIO,
+                          OS_TASK_DEFER_ID,
+                          &OSDeferTaskStk[0],                              /* Set Bottom-Of-Stack                     */
+                          OS_TASK_DEFER_STK_SIZE,
+                          (void *)0,                                       /* No TCB extension                        */
+                          OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);      /* Enable stack checking + clear stack     */
+    #else
+    (void)OSTaskCreateExt(OS_DeferTask,
+                          (void *)0,
+                          &OSDeferTaskStk[0],                              /* Set Top-Of-Stack                        */
+                          OS_TASK_DEFER_PRIO,
+                          OS_TASK_DEFER_ID,
+                          &OSDeferTaskStk[OS_TASK_DEFER_STK_SIZE - 1],     /* Set Bottom-Of-Stack                     */
+                          OS_TASK_DEFER_STK_SIZE,
+                          (void *)0,                                       /* No TCB extension                        */
+                          OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);      /* Enable stack checking + clear stack     */
+    #endif
+#else
+    #if OS_STK_GROWTH == 1
+    (void)OSTaskCreate(OS_DeferTask,
+                       (void *)0,
+                       &OSDeferTaskStk[OS_TASK_DEFER_STK_SIZE - 1],
+                       OS_TASK_DEFER_PRIO);
+    #else
+    (void)OSTaskCreate(OS_DeferTask,
+                       (void *)0,
+                       &OSDeferTaskStk[0],
+                       OS_TASK_DEFER_PRIO);
+    #endif
+#endif
+
+#if OS_TASK_NAME_SIZE > 14
+    OSTaskNameSet(OS_TASK_DEFER_PRIO, (INT8U *)"uC/OS-II Defer", &err);
+#else
+#if OS_TASK_NAME_SIZE > 8
+    OSTaskNameSet(OS_TASK_DEFER_PRIO, (INT8U *)"OS-Defer", &err);
+#endif
+#endif
+}
+#endif                                                     /* OS_DEFER_EN                              */
@@ -0,0 +1,545 @@
+/*
+*********************************************************************************************************
+*                                                uC/OS-II
+*                                          The Real-Time Kernel
+*                                         EVENT SET MANAGEMENT
+*
+* File    : OS_EVSET.C
+* Version : V2.86
+*
+* An event set lets one task wait on several semaphores, mailboxes and queues at once, like
+* OSEventPendMulti(), without scanning the sources on every call.  The sources are registered once with
+* OSEvSetAdd().  When a post stores a count or a message in a source that nobody pends on directly, it
+* appends the member of the source to the set's ready list and wakes the task waiting on the set.
+* OSEvSetPend() and OSEvSetAccept() take one count or message from the member at the head of the list,
+* so the cost of a post, a wait and a take does not depend on the number of members.  A member that
+* still holds data afterwards goes back to the tail of the list, which serves the ready sources in turn.
+*
+* A task pending on a source itself (OSSemPend(), OSMboxPend(), OSQPend()) is served first, as before;
+* the set only sees what is left in the source.  Only one task may wait on a set at a time.
+*********************************************************************************************************
+*/
+
+#ifndef  OS_MASTER_FILE
+#include <ucos_ii.h>
+#endif
+
+#if OS_EVSET_EN > 0
+/*
+*********************************************************************************************************
+*                                      APPEND A MEMBER TO THE READY LIST
+*
+* Description: This function appends a member to the ready list of its set, unless it is already in it.
+*
+* Arguments  : pset          is a pointer to the event set
+*
+*              pmember       is a pointer to the member
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to this file and must be called with interrupts disabled.
+*********************************************************************************************************
+*/
+
+static  void  OS_EvSetRdyAppend (OS_EVSET *pset, OS_EVSET_MEMBER *pmember)
+{
+    if (pmember->OSEvSetMemberRdy == OS_TRUE) {
+        return;
+    }
+    pmember->OSEvSetMemberRdy     = OS_TRUE;
+    pmember->OSEvSetMemberRdyNext = (OS_EVSET_MEMBER *)0;
+    if (pset->OSEvSetRdyTail == (OS_EVSET_MEMBER *)0) {
+        pset->OSEvSetRdyHead = pmember;
+    } else {
+        pset->OSEvSetRdyTail->OSEvSetMemberRdyNext = pmember;
+    }
+    pset->OSEvSetRdyTail = pmember;
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                     TAKE A COUNT OR A MESSAGE FROM A SET
+*
+* Description: This function takes one count or message from the member at the head of the ready list.
+*              Members whose source turned out to be empty, because a task pending on the source itself
+*              took the data, are dropped from the list on the way.
+*
+* Arguments  : pset          is a pointer to the event set
+*
+*              pmsg          is a pointer to where the message of a mailbox or a queue is deposited, NULL
+*                            for a semaphore
+*
+* Returns    : the member the count or the message was taken from, NULL if no source holds any
+*
+* Note(s)    : 1) This function is INTERNAL to this file.
+*********************************************************************************************************
+*/
+
+static  OS_EVSET_MEMBER  *OS_EvSetTake (OS_EVSET *pset, void **pmsg)
+{
+    OS_EVSET_MEMBER  *pmember;
+    OS_EVENT         *pevent;
+    BOOLEAN           more;
+#if (OS_Q_EN > 0) && (OS_MAX_QS > 0)
+    OS_Q             *pq;
+#endif
+#if OS_CRITICAL_METHOD == 3                                /* Allocate storage for CPU status register */
+    OS_CPU_SR         cpu_sr = 0;
+#endif
+
+
+
+    *pmsg = (void *)0;
+    OS_ENTER_CRITICAL();
+    for (;;) {
+        pmember = pset->OSEvSetRdyHead;
+        if (pmember == (OS_EVSET_MEMBER *)0) {
+            break;
+        }
+        pset->OSEvSetRdyHead = pmember->OSEvSetMemberRdyNext;  /* Pop the head                         */
+        if (pset->OSEvSetRdyHead == (OS_EVSET_MEMBER *)0) {
+            pset->OSEvSetRdyTail = (OS_EVSET_MEMBER *)0;
+        }
+        pmember->OSEvSetMemberRdy = OS_FALSE;
+        pevent = pmember->OSEvSetMemberEvent;
+        more   = OS_FALSE;
+        switch (pevent->OSEventType) {
+            case OS_EVENT_TYPE_SEM:
+                 if (pevent->OSEventCnt == 0) {
+                     continue;
+                 }
+                 pevent->OSEventCnt--;
+                 more = (BOOLEAN)(pevent->OSEventCnt > 0);
+                 break;
+
+#if (OS_MBOX_EN > 0) && (OS_MAX_EVENTS > 0)
+            case OS_EVENT_TYPE_MBOX:
+                 if (pevent->OSEventPtr == (void *)0) {
+                     continue;
+                 }
+                 *pmsg              = pevent->OSEventPtr;
+                 pevent->OSEventPtr = (void *)0;
+                 break;
+#endif
+
+#if (OS_Q_EN > 0) && (OS_MAX_QS > 0)
+            case OS_EVENT_TYPE_Q:
+                 pq = (OS_Q *)pevent->OSEventPtr;
+                 if (pq->OSQEntries == 0) {
+                     continue;
+                 }
+                 *pmsg = *pq->OSQOut++;                    /* Same order as OSQAccept()                */
+                 pq->OSQEntries--;
+                 if (pq->OSQOut == pq->OSQEnd) {
+                     pq->OSQOut = pq->OSQStart;
+                 }
+                 more = (BOOLEAN)(pq->OSQEntries > 0);
+                 break;
+#endif
+
+            default:
+                 continue;
+        }
+        if (more == OS_TRUE) {                             /* Serve the other ready sources first      */
+            OS_EvSetRdyAppend(pset, pmember);
+        }
+        break;
+    }
+    if (pset->OSEvSetRdyHead == (OS_EVSET_MEMBER *)0) {    /* Nothing left: no wake-up pending         */
+        pset->OSEvSetSem->OSEventCnt = 0;
+    }
+    OS_EXIT_CRITICAL();
+    return (pmember);
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                            CREATE AN EVENT SET
+*
+* Description: This function initializes an empty event set.
+*
+* Arguments  : pset          is a pointer to the event set
+*
+*              perr          is a pointer to where an error message will be deposited.  Possible error
+*                            messages are:
+*
+*                            OS_ERR_NONE         The set was created
+*                            OS_ERR_PDATA_NULL   'pset' is a NULL pointer
+*                            OS_ERR_CREATE_ISR   The function was called from an ISR
+*                            OS_ERR_PEVENT_NULL  No event control block left for the semaphore of the set
+*
+* Returns    : none
+*********************************************************************************************************
+*/
+
+void  OSEvSetCreate (OS_EVSET *pset, INT8U *perr)
+{
+#if OS_ARG_CHK_EN > 0
+    if (perr == (INT8U *)0) {                              /* Validate 'perr'                          */
+        return;
+    }
+    if (pset == (OS_EVSET *)0) {                           /* Validate 'pset'                          */
+        *perr = OS_ERR_PDATA_NULL;
+        return;
+    }
+#endif
+    if (OSIntNesting > 0) {                                /* OSSemCreate() is not allowed in an ISR   */
+        *perr = OS_ERR_CREATE_ISR;
+        return;
+    }
+    pset->OSEvSetRdyHead = (OS_EVSET_MEMBER *)0;
+    pset->OSEvSetRdyTail = (OS_EVSET_MEMBER *)0;
+    pset->OSEvSetMembers = (OS_EVSET_MEMBER *)0;
+    pset->OSEvSetSem     = OSSemCreate(0);
+    if (pset->OSEvSetSem == (OS_EVENT *)0) {
+        *perr = OS_ERR_PEVENT_NULL;
+        return;
+    }
+    *perr = OS_ERR_NONE;
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                            DELETE AN EVENT SET
+*
+* Description: This function removes all the members of a set and deletes its semaphore.  The sources are
+*              not affected; the data they hold stays in them.
+*
+* Arguments  : pset          is a pointer to the event set
+*
+*              perr          is a pointer to where an error message will be deposited.  Possible error
+*                            messages are the ones of OSSemDel(), with OS_DEL_ALWAYS.
+*
+* Returns    : none
+*
+* Note(s)    : 1) A task waiting in OSEvSetPend() returns with OS_ERR_PEND_ABORT.
+*********************************************************************************************************
+*/
+
+#if OS_SEM_DEL_EN > 0
+void  OSEvSetDel (OS_EVSET *pset, INT8U *perr)
+{
+    OS_EVSET_MEMBER  *pmember;
+#if OS_CRITICAL_METHOD == 3                                /* Allocate storage for CPU status register */
+    OS_CPU_SR         cpu_sr = 0;
+#endif
+
+
+
+#if OS_ARG_CHK_EN > 0
+    if (perr == (INT8U *)0) {                              /* Validate 'perr'                          */
+        return;
+    }
+    if (pset == (OS_EVSET *)0) {                           /* Validate 'pset'                          */
+        *perr = OS_ERR_PDATA_NULL;
+        return;
+    }
+#endif
+    OS_ENTER_CRITICAL();
+    pmember = pset->OSEvSetMembers;
+    while (pmember != (OS_EVSET_MEMBER *)0) {              /* Detach the members from their sources    */
+        pmember->OSEvSetMemberEvent->OSEventSetMember = (OS_EVSET_MEMBER *)0;
+        pmember->OSEvSetMemberSet                     = (OS_EVSET *)0;
+        pmember->OSEvSetMemberRdy                     = OS_FALSE;
+        pmember                                       = pmember->OSEvSetMemberNext;
+    }
+    pset->OSEvSetRdyHead = (OS_EVSET_MEMBER *)0;
+    pset->OSEvSetRdyTail = (OS_EVSET_MEMBER *)0;
+    pset->OSEvSetMembers = (OS_EVSET_MEMBER *)0;
+    OS_EXIT_CRITICAL();
+    (void)OSSemDel(pset->OSEvSetSem, OS_DEL_ALWAYS, perr);
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                        ADD A SOURCE TO AN EVENT SET
+*
+* Description: This function makes a semaphore, a mailbox or a queue a member of a set.  If the source
+*              already holds a count or a message, the member is ready at once.
+*
+* Arguments  : pset          is a pointer to the event set
+*
+*              pmember       is a pointer to the member, storage provided by the caller that must stay
+*                            valid until the member is removed or the set deleted
+*
+*              pevent        is a pointer to the semaphore, mailbox or queue
+*
+*              parg          is a pointer to application data returned with the member, e.g. a handler
+*
+*              perr          is a pointer to where an error message will be deposited.  Possible error
+*                            messages are:
+*
+*                            OS_ERR_NONE          The source was added
+*                            OS_ERR_PDATA_NULL    'pset' or 'pmember' is a NULL pointer
+*                            OS_ERR_PEVENT_NULL   'pevent' is a NULL pointer
+*                            OS_ERR_EVENT_TYPE    'pevent' is not a semaphore, a mailbox or a queue
+*                            OS_ERR_EVSET_MEMBER  'pmember' or 'pevent' is already in a set
+*
+* Returns    : none
+*
+* Note(s)    : 1) A source belongs to one set at most.  Remove it with OSEvSetRemove() before deleting it,
+*                 OSSemDel(), OSMboxDel() and OSQDel() return OS_ERR_EVSET_MEMBER for a member.
+*********************************************************************************************************
+*/
+
+void  OSEvSetAdd (OS_EVSET *pset, OS_EVSET_MEMBER *pmember, OS_EVENT *pevent, void *parg, INT8U *perr)
+{
+    BOOLEAN  rdy;
+#if OS_CRITICAL_METHOD == 3                                /* Allocate storage for CPU status register */
+    OS_CPU_SR  cpu_sr = 0;
+#endif
+
+
+
+#if OS_ARG_CHK_EN > 0
+    if (perr == (INT8U *)0) {                              /* Validate 'perr'                          */
+        return;
+    }
+    if (pset == (OS_EVSET *)0 || pmember == (OS_EVSET_MEMBER *)0) {
+        *perr = OS_ERR_PDATA_NULL;
+        return;
+    }
+    if (pevent == (OS_EVENT *)0) {                         /* Validate 'pevent'                        */
+        *perr = OS_ERR_PEVENT_NULL;
+        return;
+    }
+#endif
+    OS_ENTER_CRITICAL();
+    switch (pevent->OSEventType) {                         /* Does the source hold data already?       */
+        case OS_EVENT_TYPE_SEM:
+             rdy = (BOOLEAN)(pevent->OSEventCnt > 0);
+             break;
+
+        case OS_EVENT_TYPE_MBOX:
+             rdy = (BOOLEAN)(pevent->OSEventPtr != (void *)0);
+             break;
+
+#if (OS_Q_EN > 0) && (OS_MAX_QS > 0)
+        case OS_EVENT_TYPE_Q:
+             rdy = (BOOLEAN)(((OS_Q *)pevent->OSEventPtr)->OSQEntries > 0);
+             break;
+#endif
+
+        default:
+             OS_EXIT_CRITICAL();
+             *perr = OS_ERR_EVENT_TYPE;
+             return;
+    }
+    if (pevent->OSEventSetMember != (OS_EVSET_MEMBER *)0 || pmember->OSEvSetMemberSet != (OS_EVSET *)0) {
+        OS_EXIT_CRITICAL();
+        *perr = OS_ERR_EVSET_MEMBER;
+        return;
+    }
+    pmember->OSEvSetMemberSet     = pset;
+    pmember->OSEvSetMemberEvent   = pevent;
+    pmember->OSEvSetMemberArg     = parg;
+    pmember->OSEvSetMemberRdy     = OS_FALSE;
+    pmember->OSEvSetMemberRdyNext = (OS_EVSET_MEMBER *)0;
+    pmember->OSEvSetMemberNext    = pset->OSEvSetMembers;
+    pset->OSEvSetMembers          = pmember;
+    pevent->OSEventSetMember      = pmember;
+    *perr                         = OS_ERR_NONE;
+    if (rdy == OS_TRUE) {
+        if (OS_EvSetSignal(pevent) == OS_TRUE) {           /* Wake the task waiting on the set         */
+            OS_EXIT_CRITICAL();
+            OS_Sched();
+            return;
+        }
+    }
+    OS_EXIT_CRITICAL();
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                     REMOVE A SOURCE FROM AN EVENT SET
+*
+* Description: This function removes a member from its set.  The data held by the source stays in it.
+*
+* Arguments  : pmember       is a pointer to the member
+*
+*              perr          is a pointer to where an error message will be deposited.  Possible error
+*                            messages are:
+*
+*                            OS_ERR_NONE              The member was removed
+*                            OS_ERR_PDATA_NULL        'pmember' is a NULL pointer
+*                            OS_ERR_EVSET_NOT_MEMBER  'pmember' is not in a set
+*
+* Returns    : none
+*
+* Note(s)    : 1) The lists of the set are walked to unlink the member: the time taken depends on the
+*                 number of members, which is fine for a configuration change.
+*********************************************************************************************************
+*/
+
+void  OSEvSetRemove (OS_EVSET_MEMBER *pmember, INT8U *perr)
+{
+    OS_EVSET          *pset;
+    OS_EVSET_MEMBER  **pprev;
+    OS_EVSET_MEMBER   *plast;
+#if OS_CRITICAL_METHOD == 3                                /* Allocate storage for CPU status register */
+    OS_CPU_SR          cpu_sr = 0;
+#endif
+
+
+
+#if OS_ARG_CHK_EN > 0
+    if (perr == (INT8U *)0) {                              /* Validate 'perr'                          */
+        return;
+    }
+    if (pmember == (OS_EVSET_MEMBER *)0) {                 /* Validate 'pmember'                       */
+        *perr = OS_ERR_PDATA_NULL;
+        return;
+    }
+#endif
+    OS_ENTER_CRITICAL();
+    pset = pmember->OSEvSetMemberSet;
+    if (pset == (OS_EVSET *)0) {
+        OS_EXIT_CRITICAL();
+        *perr = OS_ERR_EVSET_NOT_MEMBER;
+        return;
+    }
+    pprev = &pset->OSEvSetMembers;                         /* Unlink from the members                  */
+    while (*pprev != pmember) {
+        pprev = &(*pprev)->OSEvSetMemberNext;
+    }
+    *pprev = pmember->OSEvSetMemberNext;
+    if (pmember->OSEvSetMemberRdy == OS_TRUE) {            /* Unlink from the ready list               */
+        pprev = &pset->OSEvSetRdyHead;
+        plast = (OS_EVSET_MEMBER *)0;
+        while (*pprev != pmember) {
+            plast = *pprev;
+            pprev = &plast->OSEvSetMemberRdyNext;
+        }
+        *pprev = pmember->OSEvSetMemberRdyNext;
+        if (pset->OSEvSetRdyTail == pmember) {
+            pset->OSEvSetRdyTail = plast;
+        }
+        pmember->OSEvSetMemberRdy = OS_FALSE;
+    }
+    pmember->OSEvSetMemberEvent->OSEventSetMember = (OS_EVSET_MEMBER *)0;
+    pmember->OSEvSetMemberSet                     = (OS_EVSET *)0;
+    OS_EXIT_CRITICAL();
+    *perr = OS_ERR_NONE;
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                  TAKE FROM AN EVENT SET WITHOUT WAITING
+*
+* Description: This function takes one count or message from a ready member of the set, if any.
+*
+* Arguments  : pset          is a pointer to the event set
+*
+*              pmsg          is a pointer to where the message is deposited, NULL for a semaphore or if
+*                            no member is ready
+*
+* Returns    : the member the count or the message was taken from, its OSEvSetMemberEvent and
+*              OSEvSetMemberArg tell which source it is
+*              NULL if no member is ready
+*********************************************************************************************************
+*/
+
+OS_EVSET_MEMBER  *OSEvSetAccept (OS_EVSET *pset, void **pmsg)
+{
+#if OS_ARG_CHK_EN > 0
+    if (pset == (OS_EVSET *)0 || pmsg == (void **)0) {     /* Validate 'pset' and 'pmsg'               */
+        return ((OS_EVSET_MEMBER *)0);
+    }
+#endif
+    return (OS_EvSetTake(pset, pmsg));
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                         WAIT ON AN EVENT SET
+*
+* Description: This function takes one count or message from a ready member of the set, and waits for
+*              one if no member is ready.
+*
+* Arguments  : pset          is a pointer to the event set
+*
+*              timeout       is an optional timeout in clock ticks, 0 to wait forever
+*
+*              pmsg          is a pointer to where the message is deposited, NULL for a semaphore or on
+*                            error
+*
+*              perr          is a pointer to where an error message will be deposited.  Possible error
+*                            messages are:
+*
+*                            OS_ERR_NONE         A count or a message was taken
+*                            OS_ERR_PDATA_NULL   'pset' or 'pmsg' is a NULL pointer
+*                            any error of OSSemPend() on the semaphore of the set, e.g. OS_ERR_TIMEOUT
+*
+* Returns    : the member the count or the message was taken from, NULL on error
+*
+* Note(s)    : 1) A wake-up can find the ready list empty if a task pending on a source itself took the
+*                 data first.  The function then waits again with the full timeout.
+*********************************************************************************************************
+*/
+
+OS_EVSET_MEMBER  *OSEvSetPend (OS_EVSET *pset, INT16U timeout, void **pmsg, INT8U *perr)
+{
+    OS_EVSET_MEMBER  *pmember;
+
+
+#if OS_ARG_CHK_EN > 0
+    if (perr == (INT8U *)0) {                              /* Validate 'perr'                          */
+        return ((OS_EVSET_MEMBER *)0);
+    }
+    if (pset == (OS_EVSET *)0 || pmsg == (void **)0) {     /* Validate 'pset' and 'pmsg'               */
+        *perr = OS_ERR_PDATA_NULL;
+        return ((OS_EVSET_MEMBER *)0);
+    }
+#endif
+    for (;;) {
+        pmember = OS_EvSetTake(pset, pmsg);
+        if (pmember != (OS_EVSET_MEMBER *)0) {
+            *perr = OS_ERR_NONE;
+            return (pmember);
+        }
+        OSSemPend(pset->OSEvSetSem, timeout, perr);
+        if (*perr != OS_ERR_NONE) {
+            pmember = OS_EvSetTake(pset, pmsg);            /* A post may have arrived meanwhile        */
+            if (pmember != (OS_EVSET_MEMBER *)0) {
+                *perr = OS_ERR_NONE;
+            }
+            return (pmember);
+        }
+    }
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                      SIGNAL A MEMBER OF AN EVENT SET
+*
+* Description: This function is called by the posts when they store a count or a message in a source
+*              that is a member of a set (see OS_EVSET_SIGNAL()).  It makes the member ready and wakes
+*              the task waiting on the set.
+*
+* Arguments  : pevent        is a pointer to the source
+*
+* Returns    : OS_TRUE       if a task was made ready, the caller should call OS_Sched()
+*              OS_FALSE      otherwise
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and must be called with interrupts disabled.
+*********************************************************************************************************
+*/
+
+BOOLEAN  OS_EvSetSignal (OS_EVENT *pevent)
+{
+    OS_EVSET  *pset;
+    OS_EVENT  *psem;
+
+
+    pset = pevent->OSEventSetMember->OSEvSetMemberSet;
+    OS_EvSetRdyAppend(pset, pevent->OSEventSetMember);
+    psem = pset->OSEvSetSem;
+    if (psem->OSEventGrp != 0) {                           /* Is a task waiting on the set?            */
+        (void)OS_EventTaskRdy(psem, (void *)0, OS_STAT_SEM, OS_STAT_PEND_OK);
+        return (OS_TRUE);
+    }
+    psem->OSEventCnt = 1;                                  /* No, the next OSEvSetPend() won't wait    */
+    return (OS_FALSE);
+}
+#endif                                                     /* OS_EVSET_EN                              */
@@ -988,12 +988,11 @@ OS_FLAGS  OSFlagQuery (OS_FLAG_GRP *pgrp, INT8U *perr)
 static  void  OS_FlagBlock (OS_FLAG_GRP *pgrp, OS_FLAG_NODE *pnode, OS_FLAGS flags, INT8U wait_type, INT16U timeout)
 {
     OS_FLAG_NODE  *pnode_next;
-    INT8U          y;
 
 
     OSTCBCur->OSTCBStat      |= OS_STAT_FLAG;
     OSTCBCur->OSTCBStatPend   = OS_STAT_PEND_OK;
-    OSTCBCur->OSTCBDly        = timeout;              /* Store timeout in task's TCB                   */
+    OS_DLY_SET(OSTCBCur, timeout);                    /* Store timeout in task's TCB                   */
 #if OS_TASK_DEL_EN > 0
     OSTCBCur->OSTCBFlagNode   = pnode;                /* TCB to link to node                           */
 #endif
@@ -1009,11 +1008,7 @@ static  void  OS_FlagBlock (OS_FLAG_GRP *pgrp, OS_FLAG_NODE *pnode, OS_FLAGS fla
     }
     pgrp->OSFlagWaitList = (void *)pnode;
 
-    y            =  OSTCBCur->OSTCBY;                 /* Suspend current task until flag(s) received   */
-    OSRdyTbl[y] &= ~OSTCBCur->OSTCBBitX;
-    if (OSRdyTbl[y] == 0x00) {
-        OSRdyGrp &= ~OSTCBCur->OSTCBBitY;
-    }
+    OS_RDY_CLR(OSTCBCur);                             /* Suspend current task until flag(s) received   */
 }
 
 /*$PAGE*/
@@ -1105,13 +1100,12 @@ static  BOOLEAN  OS_FlagTaskRdy (OS_FLAG_NODE *pnode, OS_FLAGS flags_rdy)
 
 
     ptcb                 = (OS_TCB *)pnode->OSFlagNodeTCB; /* Point to TCB of waiting task             */
-    ptcb->OSTCBDly       = 0;
+    OS_DLY_CLR(ptcb);
     ptcb->OSTCBFlagsRdy  = flags_rdy;
     ptcb->OSTCBStat     &= ~(INT8U)OS_STAT_FLAG;
     ptcb->OSTCBStatPend  = OS_STAT_PEND_OK;
     if (ptcb->OSTCBStat == OS_STAT_RDY) {                  /* Task now ready?                          */
-        OSRdyGrp               |= ptcb->OSTCBBitY;         /* Put task into ready list                 */
-        OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+        OS_RDY_SET(ptcb);                                  /* Put task into ready list                 */
         sched                   = OS_TRUE;
     } else {
         sched                   = OS_FALSE;
@@ -137,6 +137,7 @@ OS_EVENT  *OSMboxCreate (void *pmsg)
 *                            OS_ERR_TASK_WAITING     One or more tasks were waiting on the mailbox
 *                            OS_ERR_EVENT_TYPE       If you didn't pass a pointer to a mailbox
 *                            OS_ERR_PEVENT_NULL      If 'pevent' is a NULL pointer.
+*                            OS_ERR_EVSET_MEMBER     If the mailbox is still a member of an event set
 *
 * Returns    : pevent        upon error
 *              (OS_EVENT *)0 if the mailbox was successfully deleted.
@@ -149,6 +150,7 @@ OS_EVENT  *OSMboxCreate (void *pmsg)
 *              4) Because ALL tasks pending on the mailbox will be readied, you MUST be careful in
 *                 applications where the mailbox is used for mutual exclusion because the resource(s)
 *                 will no longer be guarded by the mailbox.
+*              5) A member of an event set is not deleted, remove it with OSEvSetRemove() first.
 *********************************************************************************************************
 */
 
@@ -181,6 +183,13 @@ OS_EVENT  *OSMboxDel (OS_EVENT *pevent, INT8U opt, INT8U *perr)
         return (pevent);
     }
     OS_ENTER_CRITICAL();
+#if OS_EVSET_EN > 0
+    if (pevent->OSEventSetMember != (OS_EVSET_MEMBER *)0) {
+        OS_EXIT_CRITICAL();
+        *perr = OS_ERR_EVSET_MEMBER;                       /* The set would keep a dangling member     */
+        return (pevent);
+    }
+#endif
     if (pevent->OSEventGrp != 0) {                         /* See if any tasks waiting on mailbox      */
         tasks_waiting = OS_TRUE;                           /* Yes                                      */
     } else {
@@ -301,6 +310,7 @@ void  *OSMboxPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
         *perr = OS_ERR_PEND_LOCKED;                   /* ... can't PEND when locked                    */
         return ((void *)0);
     }
+    OS_TRACE(OS_TRACE_MBOX_PEND, OS_TRACE_EVENT_IX(pevent));
     OS_ENTER_CRITICAL();
     pmsg = pevent->OSEventPtr;
     if (pmsg != (void *)0) {                          /* See if there is already a message             */
@@ -311,7 +321,7 @@ void  *OSMboxPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
     }
     OSTCBCur->OSTCBStat     |= OS_STAT_MBOX;          /* Message not available, task will pend         */
     OSTCBCur->OSTCBStatPend  = OS_STAT_PEND_OK;
-    OSTCBCur->OSTCBDly       = timeout;               /* Load timeout in TCB                           */
+    OS_DLY_SET(OSTCBCur, timeout);                    /* Load timeout in TCB                           */
     OS_EventTaskWait(pevent);                         /* Suspend task until event or timeout occurs    */
     OS_EXIT_CRITICAL();
     OS_Sched();                                       /* Find next highest priority task ready to run  */
@@ -471,6 +481,7 @@ INT8U  OSMboxPost (OS_EVENT *pevent, void *pmsg)
     if (pevent->OSEventType != OS_EVENT_TYPE_MBOX) {  /* Validate event block type                     */
         return (OS_ERR_EVENT_TYPE);
     }
+    OS_TRACE(OS_TRACE_MBOX_POST, OS_TRACE_EVENT_IX(pevent));
     OS_ENTER_CRITICAL();
     if (pevent->OSEventGrp != 0) {                    /* See if any task pending on mailbox            */
                                                       /* Ready HPT waiting on event                    */
@@ -484,6 +495,11 @@ INT8U  OSMboxPost (OS_EVENT *pevent, void *pmsg)
         return (OS_ERR_MBOX_FULL);
     }
     pevent->OSEventPtr = pmsg;                        /* Place message in mailbox                      */
+    if (OS_EVSET_SIGNAL(pevent) == OS_TRUE) {         /* Wake the task waiting on the event set        */
+        OS_EXIT_CRITICAL();
+        OS_Sched();
+        return (OS_ERR_NONE);
+    }
     OS_EXIT_CRITICAL();
     return (OS_ERR_NONE);
 }
@@ -542,6 +558,7 @@ INT8U  OSMboxPostOpt (OS_EVENT *pevent, void *pmsg, INT8U opt)
     if (pevent->OSEventType != OS_EVENT_TYPE_MBOX) {  /* Validate event block type                     */
         return (OS_ERR_EVENT_TYPE);
     }
+    OS_TRACE(OS_TRACE_MBOX_POST, OS_TRACE_EVENT_IX(pevent));
     OS_ENTER_CRITICAL();
     if (pevent->OSEventGrp != 0) {                    /* See if any task pending on mailbox            */
         if ((opt & OS_POST_OPT_BROADCAST) != 0x00) {  /* Do we need to post msg to ALL waiting tasks ? */
@@ -562,6 +579,13 @@ INT8U  OSMboxPostOpt (OS_EVENT *pevent, void *pmsg, INT8U opt)
         return (OS_ERR_MBOX_FULL);
     }
     pevent->OSEventPtr = pmsg;                        /* Place message in mailbox                      */
+    if (OS_EVSET_SIGNAL(pevent) == OS_TRUE) {         /* Wake the task waiting on the event set        */
+        OS_EXIT_CRITICAL();
+        if ((opt & OS_POST_OPT_NO_SCHED) == 0) {
+            OS_Sched();
+        }
+        return (OS_ERR_NONE);
+    }
     OS_EXIT_CRITICAL();
     return (OS_ERR_NONE);
 }
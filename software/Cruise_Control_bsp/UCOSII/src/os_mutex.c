@@ -38,6 +38,13 @@
 
 #define  OS_MUTEX_AVAILABLE      ((INT16U)0x00FFu)
 
+#if OS_MUTEX_CEIL_EN > 0                                   /* Del() and Query() take both mutex types  */
+#define  OS_MUTEX_TYPE_OK(pevent) ((pevent)->OSEventType == OS_EVENT_TYPE_MUTEX || \
+                                   (pevent)->OSEventType == OS_EVENT_TYPE_MUTEX_CEIL)
+#else
+#define  OS_MUTEX_TYPE_OK(pevent) ((pevent)->OSEventType == OS_EVENT_TYPE_MUTEX)
+#endif
+
 /*
 *********************************************************************************************************
 *                                            LOCAL CONSTANTS
@@ -46,6 +53,14 @@
 
 static  void  OSMutex_RdyAtPrio(OS_TCB *ptcb, INT8U prio);
 
+#if OS_MUTEX_CEIL_EN > 0
+static  INT8U  OSMutex_CeilLock(OS_EVENT *pevent);
+static  INT8U  OSMutex_CeilUnlock(OS_EVENT *pevent);
+#if OS_MUTEX_DEL_EN
+static  void   OSMutex_CeilUnlink(OS_TCB *ptcb, OS_EVENT *pevent);
+#endif
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -62,6 +77,7 @@ static  void  OSMutex_RdyAtPrio(OS_TCB *ptcb, INT8U prio);
 *                            OS_ERR_EVENT_TYPE   if 'pevent' is not a pointer to a mutex
 *                            OS_ERR_PEVENT_NULL  'pevent' is a NULL pointer
 *                            OS_ERR_PEND_ISR     if you called this function from an ISR
+*                            OS_ERR_MUTEX_BUSY   if a priority ceiling mutex is owned (see OSMutexPend())
 *                            OS_ERR_PIP_LOWER    If the priority of the task that owns the Mutex is
 *                                                HIGHER (i.e. a lower number) than the PIP.  This error
 *                                                indicates that you did not set the PIP higher (lower
@@ -98,6 +114,15 @@ BOOLEAN  OSMutexAccept (OS_EVENT *pevent, INT8U *perr)
         *perr = OS_ERR_PEVENT_NULL;
         return (OS_FALSE);
     }
+#endif
+#if OS_MUTEX_CEIL_EN > 0
+    if (pevent->OSEventType == OS_EVENT_TYPE_MUTEX_CEIL) {
+        *perr = OSMutex_CeilLock(pevent);              /* Never waits anyway                           */
+        if (*perr != OS_ERR_NONE) {
+            return (OS_FALSE);
+        }
+        return (OS_TRUE);
+    }
 #endif
     if (pevent->OSEventType != OS_EVENT_TYPE_MUTEX) {  /* Validate event block type                    */
         *perr = OS_ERR_EVENT_TYPE;
@@ -213,6 +238,72 @@ OS_EVENT  *OSMutexCreate (INT8U prio, INT8U *perr)
     return (pevent);
 }
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                         CREATE A MUTUAL EXCLUSION SEMAPHORE WITH A PROTOCOL
+*
+* Description: This function creates a mutual exclusion semaphore that uses either priority inheritance,
+*              like OSMutexCreate(), or the immediate priority ceiling protocol.
+*
+* Arguments  : prio          is the priority to use when accessing the mutual exclusion semaphore, as for
+*                            OSMutexCreate().  It MUST be higher (lower in value) than ANY of the tasks
+*                            that use the mutex.
+*
+*              opt           selects the protocol:
+*                               OS_MUTEX_OPT_INHERIT  the owner is raised to 'prio' only while a higher
+*                                                     priority task waits for the mutex (OSMutexCreate()).
+*                               OS_MUTEX_OPT_CEILING  the owner is raised to 'prio' as soon as it locks the
+*                                                     mutex and runs there until it unlocks it.  No task
+*                                                     that uses the mutex can run in between, so no task
+*                                                     ever waits for it: OSMutexPend() never suspends, the
+*                                                     wait list is never used and tasks that nest ceiling
+*                                                     mutexes cannot deadlock.  A task is blocked at most
+*                                                     once, for one critical section, by a lower priority
+*                                                     task, and only before it starts to run.
+*
+*              perr          is a pointer to an error code which will be returned to your application:
+*                               OS_ERR_NONE         if the call was successful.
+*                               OS_ERR_INVALID_OPT  if 'opt' is not one of the above.
+*                               any error of OSMutexCreate().
+*
+* Returns    : != (void *)0  is a pointer to the event control clock (OS_EVENT) associated with the
+*                            created mutex.
+*              == (void *)0  if an error is detected.
+*
+* Note(s)    : 1) The owner of a ceiling mutex MUST NOT pend or delay while it owns the mutex.  If it
+*                 does, OSMutexPend() returns OS_ERR_MUTEX_BUSY to the other users instead of waiting.
+*
+*              2) Ceiling mutexes MUST be unlocked in the reverse order they were locked.  Each task keeps
+*                 the ceiling mutexes it owns on a stack, OSMutexPost() returns OS_ERR_MUTEX_ORDER for
+*                 any mutex but the one on top.
+*********************************************************************************************************
+*/
+
+#if OS_MUTEX_CEIL_EN > 0
+OS_EVENT  *OSMutexCreateExt (INT8U prio, INT8U opt, INT8U *perr)
+{
+    OS_EVENT  *pevent;
+
+
+
+#if OS_ARG_CHK_EN > 0
+    if (perr == (INT8U *)0) {                              /* Validate 'perr'                          */
+        return ((OS_EVENT *)0);
+    }
+#endif
+    if (opt != OS_MUTEX_OPT_INHERIT && opt != OS_MUTEX_OPT_CEILING) {
+        *perr = OS_ERR_INVALID_OPT;
+        return ((OS_EVENT *)0);
+    }
+    pevent = OSMutexCreate(prio, perr);
+    if (pevent != (OS_EVENT *)0 && opt == OS_MUTEX_OPT_CEILING) {
+        pevent->OSEventType = OS_EVENT_TYPE_MUTEX_CEIL;    /* Not visible to other tasks yet           */
+    }
+    return (pevent);
+}
+#endif
+
 /*$PAGE*/
 /*
 *********************************************************************************************************
@@ -250,7 +341,9 @@ OS_EVENT  *OSMutexCreate (INT8U prio, INT8U *perr)
 *              4) IMPORTANT: In the 'OS_DEL_ALWAYS' case, we assume that the owner of the Mutex (if there
 *                            is one) is ready-to-run and is thus NOT pending on another kernel object or
 *                            has delayed itself.  In other words, if a task owns the mutex being deleted,
-*                            that task will be made ready-to-run at its original priority.
+*                            that task will be made ready-to-run at its original priority.  The
+*                            same applies to the owner of a priority ceiling mutex in the
+*                            'OS_DEL_NO_PEND' case.
 *********************************************************************************************************
 */
 
@@ -277,7 +370,7 @@ OS_EVENT  *OSMutexDel (OS_EVENT *pevent, INT8U opt, INT8U *perr)
         return (pevent);
     }
 #endif
-    if (pevent->OSEventType != OS_EVENT_TYPE_MUTEX) {      /* Validate event block type                */
+    if (!OS_MUTEX_TYPE_OK(pevent)) {                       /* Validate event block type                */
         *perr = OS_ERR_EVENT_TYPE;
         return (pevent);
     }
@@ -294,6 +387,15 @@ OS_EVENT  *OSMutexDel (OS_EVENT *pevent, INT8U opt, INT8U *perr)
     switch (opt) {
         case OS_DEL_NO_PEND:                               /* DELETE MUTEX ONLY IF NO TASK WAITING --- */
              if (tasks_waiting == OS_FALSE) {
+#if OS_MUTEX_CEIL_EN > 0
+                 ptcb = (OS_TCB *)pevent->OSEventPtr;      /* A ceiling owner runs at the ceiling      */
+                 if (ptcb != (OS_TCB *)0 && pevent->OSEventType == OS_EVENT_TYPE_MUTEX_CEIL) {
+                     OSMutex_CeilUnlink(ptcb, pevent);
+                     if (ptcb->OSTCBPrio == (INT8U)(pevent->OSEventCnt >> 8)) {
+                         OSMutex_RdyAtPrio(ptcb, (INT8U)(pevent->OSEventCnt & OS_MUTEX_KEEP_LOWER_8));
+                     }
+                 }
+#endif
 #if OS_EVENT_NAME_SIZE > 1
                  pevent->OSEventName[0] = '?';             /* Unknown name                             */
                  pevent->OSEventName[1] = OS_ASCII_NUL;
@@ -319,6 +421,11 @@ OS_EVENT  *OSMutexDel (OS_EVENT *pevent, INT8U opt, INT8U *perr)
              prio = (INT8U)(pevent->OSEventCnt & OS_MUTEX_KEEP_LOWER_8);  /* Get owner's original prio */
              ptcb = (OS_TCB *)pevent->OSEventPtr;
              if (ptcb != (OS_TCB *)0) {                    /* See if any task owns the mutex           */
+#if OS_MUTEX_CEIL_EN > 0
+                 if (pevent->OSEventType == OS_EVENT_TYPE_MUTEX_CEIL) {
+                     OSMutex_CeilUnlink(ptcb, pevent);     /* Drop it from the owner's ceiling stack   */
+                 }
+#endif
                  if (ptcb->OSTCBPrio == pip) {             /* See if original prio was changed         */
                      OSMutex_RdyAtPrio(ptcb, prio);        /* Yes, Restore the task's original prio    */
                  }
@@ -386,12 +493,20 @@ OS_EVENT  *OSMutexDel (OS_EVENT *pevent, INT8U opt, INT8U *perr)
 *                                                  detected when the Mutex is created because we don't know
 *                                                  what tasks will be using the Mutex.
 *                               OS_ERR_PEND_LOCKED If you called this function when the scheduler is locked
+*                               OS_ERR_MUTEX_BUSY  If a priority ceiling mutex is owned.  Its owner was
+*                                                  suspended inside the critical section or the caller's
+*                                                  priority is above the ceiling.
 *
 * Returns    : none
 *
 * Note(s)    : 1) The task that owns the Mutex MUST NOT pend on any other event while it owns the mutex.
 *
 *              2) You MUST NOT change the priority of the task that owns the mutex
+*
+*              3) A priority ceiling mutex (see OSMutexCreateExt()) is acquired at once, 'timeout' is not
+*                 used and the call is allowed with the scheduler locked.  The caller runs at the ceiling
+*                 until OSMutexPost().  A task that already runs at or above the ceiling because it owns
+*                 another ceiling mutex stays at its priority.
 *********************************************************************************************************
 */
 
@@ -402,7 +517,6 @@ void  OSMutexPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
     BOOLEAN    rdy;                                        /* Flag indicating task was ready           */
     OS_TCB    *ptcb;
     OS_EVENT  *pevent2;
-    INT8U      y;
 #if OS_CRITICAL_METHOD == 3                                /* Allocate storage for CPU status register */
     OS_CPU_SR  cpu_sr = 0;
 #endif
@@ -417,6 +531,12 @@ void  OSMutexPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
         *perr = OS_ERR_PEVENT_NULL;
         return;
     }
+#endif
+#if OS_MUTEX_CEIL_EN > 0
+    if (pevent->OSEventType == OS_EVENT_TYPE_MUTEX_CEIL) { /* Priority ceiling, never waits            */
+        *perr = OSMutex_CeilLock(pevent);
+        return;
+    }
 #endif
     if (pevent->OSEventType != OS_EVENT_TYPE_MUTEX) {      /* Validate event block type                */
         *perr = OS_ERR_EVENT_TYPE;
@@ -451,13 +571,9 @@ void  OSMutexPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
     ptcb  = (OS_TCB *)(pevent->OSEventPtr);                       /*     Point to TCB of mutex owner   */
     if (ptcb->OSTCBPrio > pip) {                                  /*     Need to promote prio of owner?*/
         if (mprio > OSTCBCur->OSTCBPrio) {
-            y = ptcb->OSTCBY;
-            if ((OSRdyTbl[y] & ptcb->OSTCBBitX) != 0) {           /*     See if mutex owner is ready   */
-                OSRdyTbl[y] &= ~ptcb->OSTCBBitX;                  /*     Yes, Remove owner from Rdy ...*/
-                if (OSRdyTbl[y] == 0) {                           /*          ... list at current prio */
-                    OSRdyGrp &= ~ptcb->OSTCBBitY;
-                }
-                rdy = OS_TRUE;
+            if (OS_RDY_IS_SET(ptcb)) {                            /*     See if mutex owner is ready   */
+                OS_RDY_CLR(ptcb);                                 /*     Yes, Remove owner from Rdy ...*/
+                rdy = OS_TRUE;                                    /*          ... list at current prio */
             } else {
                 pevent2 = ptcb->OSTCBEventPtr;
                 if (pevent2 != (OS_EVENT *)0) {                   /* Remove from event wait list       */
@@ -478,10 +594,12 @@ void  OSMutexPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
             ptcb->OSTCBX    = (INT8U)( ptcb->OSTCBPrio & 0x0F);
             ptcb->OSTCBBitY = (INT16U)(1 << ptcb->OSTCBY);
             ptcb->OSTCBBitX = (INT16U)(1 << ptcb->OSTCBX);
+#endif
+#if OS_RDY_MASK_EN > 0
+            ptcb->OSTCBBitPrio = (INT32U)1 << pip;
 #endif
             if (rdy == OS_TRUE) {                          /* If task was ready at owner's priority ...*/
-                OSRdyGrp               |= ptcb->OSTCBBitY; /* ... make it ready at new priority.       */
-                OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+                OS_RDY_SET(ptcb);                          /* ... make it ready at new priority.       */
             } else {
                 pevent2 = ptcb->OSTCBEventPtr;
                 if (pevent2 != (OS_EVENT *)0) {            /* Add to event wait list                   */
@@ -494,7 +612,7 @@ void  OSMutexPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
     }
     OSTCBCur->OSTCBStat     |= OS_STAT_MUTEX;         /* Mutex not available, pend current task        */
     OSTCBCur->OSTCBStatPend  = OS_STAT_PEND_OK;
-    OSTCBCur->OSTCBDly       = timeout;               /* Store timeout in current task's TCB           */
+    OS_DLY_SET(OSTCBCur, timeout);                    /* Store timeout in current task's TCB           */
     OS_EventTaskWait(pevent);                         /* Suspend task until event or timeout occurs    */
     OS_EXIT_CRITICAL();
     OS_Sched();                                       /* Find next highest priority task ready         */
@@ -537,6 +655,8 @@ void  OSMutexPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
 *              OS_ERR_PEVENT_NULL      'pevent' is a NULL pointer
 *              OS_ERR_POST_ISR         Attempted to post from an ISR (not valid for MUTEXes)
 *              OS_ERR_NOT_MUTEX_OWNER  The task that did the post is NOT the owner of the MUTEX.
+*              OS_ERR_MUTEX_ORDER      A priority ceiling mutex locked after this one is still owned,
+*                                      the mutex is NOT released.
 *              OS_ERR_PIP_LOWER        If the priority of the new task that owns the Mutex is
 *                                      HIGHER (i.e. a lower number) than the PIP.  This error
 *                                      indicates that you did not set the PIP higher (lower
@@ -564,6 +684,11 @@ INT8U  OSMutexPost (OS_EVENT *pevent)
     if (pevent == (OS_EVENT *)0) {                    /* Validate 'pevent'                             */
         return (OS_ERR_PEVENT_NULL);
     }
+#endif
+#if OS_MUTEX_CEIL_EN > 0
+    if (pevent->OSEventType == OS_EVENT_TYPE_MUTEX_CEIL) {
+        return (OSMutex_CeilUnlock(pevent));
+    }
 #endif
     if (pevent->OSEventType != OS_EVENT_TYPE_MUTEX) { /* Validate event block type                     */
         return (OS_ERR_EVENT_TYPE);
@@ -647,7 +772,7 @@ INT8U  OSMutexQuery (OS_EVENT *pevent, OS_MUTEX_DATA *p_mutex_data)
         return (OS_ERR_PDATA_NULL);
     }
 #endif
-    if (pevent->OSEventType != OS_EVENT_TYPE_MUTEX) {      /* Validate event block type                */
+    if (!OS_MUTEX_TYPE_OK(pevent)) {                       /* Validate event block type                */
         return (OS_ERR_EVENT_TYPE);
     }
     OS_ENTER_CRITICAL();
@@ -686,14 +811,7 @@ INT8U  OSMutexQuery (OS_EVENT *pevent, OS_MUTEX_DATA *p_mutex_data)
 
 static  void  OSMutex_RdyAtPrio (OS_TCB *ptcb, INT8U prio)
 {
-    INT8U   y;
-
-
-    y            =  ptcb->OSTCBY;                          /* Remove owner from ready list at 'pip'    */
-    OSRdyTbl[y] &= ~ptcb->OSTCBBitX;
-    if (OSRdyTbl[y] == 0) {
-        OSRdyGrp &= ~ptcb->OSTCBBitY;
-    }
+    OS_RDY_CLR(ptcb);                                      /* Remove owner from ready list at 'pip'    */
     ptcb->OSTCBPrio         = prio;
 #if OS_LOWEST_PRIO <= 63
     ptcb->OSTCBY            = (INT8U)((prio >> (INT8U)3) & (INT8U)0x07);
@@ -706,10 +824,154 @@ static  void  OSMutex_RdyAtPrio (OS_TCB *ptcb, INT8U prio)
     ptcb->OSTCBBitY         = (INT16U)(1 << ptcb->OSTCBY);
     ptcb->OSTCBBitX         = (INT16U)(1 << ptcb->OSTCBX);
 #endif
-    OSRdyGrp               |= ptcb->OSTCBBitY;             /* Make task ready at original priority     */
-    OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+#if OS_RDY_MASK_EN > 0
+    ptcb->OSTCBBitPrio      = (INT32U)1 << prio;
+#endif
+    OS_RDY_SET(ptcb);                                      /* Make task ready at original priority     */
     OSTCBPrioTbl[prio]      = ptcb;
 }
 
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                   LOCK A PRIORITY CEILING MUTEX
+*
+* Description: This function acquires a priority ceiling mutex for the current task and raises the task
+*              to the ceiling.  The mutex is free unless its owner was suspended while owning it, or the
+*              current task is above the ceiling, so there is nothing to wait for.
+*
+* Arguments  : pevent          is a pointer to the priority ceiling mutex
+*
+* Returns    : OS_ERR_NONE         the current task owns the mutex
+*              OS_ERR_PEND_ISR     if called from an ISR
+*              OS_ERR_MUTEX_BUSY   if another task owns the mutex
+*********************************************************************************************************
+*/
+
+#if OS_MUTEX_CEIL_EN > 0
+static  INT8U  OSMutex_CeilLock (OS_EVENT *pevent)
+{
+    INT8U      ceil;
+#if OS_CRITICAL_METHOD == 3                                /* Allocate storage for CPU status register */
+    OS_CPU_SR  cpu_sr = 0;
+#endif
+
+
+
+    if (OSIntNesting > 0) {                                /* See if called from ISR ...               */
+        return (OS_ERR_PEND_ISR);
+    }
+    OS_ENTER_CRITICAL();
+    if ((INT8U)(pevent->OSEventCnt & OS_MUTEX_KEEP_LOWER_8) != OS_MUTEX_AVAILABLE) {
+        OS_EXIT_CRITICAL();
+        return (OS_ERR_MUTEX_BUSY);
+    }
+    ceil                = (INT8U)(pevent->OSEventCnt >> 8);
+    pevent->OSEventCnt &= OS_MUTEX_KEEP_UPPER_8;           /* Acquire the resource                     */
+    pevent->OSEventCnt |= OSTCBCur->OSTCBPrio;             /* Save the priority to return to           */
+    pevent->OSEventPtr  = (void *)OSTCBCur;
+    pevent->OSEventCeilPrev = OSTCBCur->OSTCBCeilTop;      /* Push it on the task's ceiling stack      */
+    OSTCBCur->OSTCBCeilTop  = pevent;
+    if (OSTCBCur->OSTCBPrio > ceil) {                      /* Raise the task to the ceiling, it is     */
+        OSMutex_RdyAtPrio(OSTCBCur, ceil);                 /* ... still the highest ready task         */
+    }
+    OS_EXIT_CRITICAL();
+    return (OS_ERR_NONE);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                  UNLOCK A PRIORITY CEILING MUTEX
+*
+* Description: This function releases a priority ceiling mutex owned by the current task and returns the
+*              task to the priority it had when it locked the mutex.
+*
+* Arguments  : pevent          is a pointer to the priority ceiling mutex
+*
+* Returns    : OS_ERR_NONE             the mutex is released
+*              OS_ERR_NOT_MUTEX_OWNER  if the current task does not own the mutex
+*              OS_ERR_MUTEX_ORDER      if a ceiling mutex locked after this one is still owned
+*********************************************************************************************************
+*/
+
+static  INT8U  OSMutex_CeilUnlock (OS_EVENT *pevent)
+{
+    INT8U      ceil;
+    INT8U      prio;
+#if OS_CRITICAL_METHOD == 3                                /* Allocate storage for CPU status register */
+    OS_CPU_SR  cpu_sr = 0;
+#endif
+
+
+
+    OS_ENTER_CRITICAL();
+    ceil = (INT8U)(pevent->OSEventCnt >> 8);
+    prio = (INT8U)(pevent->OSEventCnt & OS_MUTEX_KEEP_LOWER_8);   /* Priority before the lock          */
+    if (OSTCBCur != (OS_TCB *)pevent->OSEventPtr) {
+        OS_EXIT_CRITICAL();
+        return (OS_ERR_NOT_MUTEX_OWNER);
+    }
+    if (OSTCBCur->OSTCBCeilTop != pevent) {                /* A ceiling mutex locked later is owned    */
+        OS_EXIT_CRITICAL();
+        return (OS_ERR_MUTEX_ORDER);
+    }
+    OSTCBCur->OSTCBCeilTop = pevent->OSEventCeilPrev;      /* Pop it off the task's ceiling stack      */
+    pevent->OSEventCeilPrev = (OS_EVENT *)0;
+    if (OSTCBCur->OSTCBPrio == ceil) {                     /* Raised by this mutex                     */
+        OSMutex_RdyAtPrio(OSTCBCur, prio);
+        OSTCBPrioTbl[ceil]  = OS_TCB_RESERVED;
+        pevent->OSEventCnt |= OS_MUTEX_AVAILABLE;
+        pevent->OSEventPtr  = (void *)0;
+        OS_EXIT_CRITICAL();
+        OS_Sched();                                        /* Run the tasks readied under the ceiling  */
+        return (OS_ERR_NONE);
+    }
+    pevent->OSEventCnt |= OS_MUTEX_AVAILABLE;              /* Locked under a higher ceiling, no change */
+    pevent->OSEventPtr  = (void *)0;
+    OS_EXIT_CRITICAL();
+    return (OS_ERR_NONE);
+}
+
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                              REMOVE A CEILING MUTEX FROM ITS OWNER'S STACK
+*
+* Description: This function takes a priority ceiling mutex that is being deleted off the stack of ceiling
+*              mutexes its owner holds, wherever it is on the stack.
+*
+* Arguments  : ptcb            is a pointer to the TCB of the owner
+*
+*              pevent          is a pointer to the priority ceiling mutex
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to this file and is called with interrupts disabled.
+*********************************************************************************************************
+*/
+
+#if OS_MUTEX_DEL_EN
+static  void  OSMutex_CeilUnlink (OS_TCB *ptcb, OS_EVENT *pevent)
+{
+    OS_EVENT  *pnext;
+
+
+    if (ptcb->OSTCBCeilTop == pevent) {
+        ptcb->OSTCBCeilTop = pevent->OSEventCeilPrev;
+    } else {
+        pnext = ptcb->OSTCBCeilTop;                        /* Find the mutex locked right after it     */
+        while (pnext != (OS_EVENT *)0 && pnext->OSEventCeilPrev != pevent) {
+            pnext = pnext->OSEventCeilPrev;
+        }
+        if (pnext != (OS_EVENT *)0) {
+            pnext->OSEventCeilPrev = pevent->OSEventCeilPrev;
+        }
+    }
+    pevent->OSEventCeilPrev = (OS_EVENT *)0;
+}
+#endif
+#endif
+
 
 #endif                                                     /* OS_MUTEX_EN                              */
@@ -188,6 +188,7 @@ OS_EVENT  *OSQCreate (void **start, INT16U size)
 *                            OS_ERR_TASK_WAITING     One or more tasks were waiting on the queue
 *                            OS_ERR_EVENT_TYPE       If you didn't pass a pointer to a queue
 *                            OS_ERR_PEVENT_NULL      If 'pevent' is a NULL pointer.
+*                            OS_ERR_EVSET_MEMBER     If the queue is still a member of an event set
 *
 * Returns    : pevent        upon error
 *              (OS_EVENT *)0 if the queue was successfully deleted.
@@ -205,6 +206,7 @@ OS_EVENT  *OSQCreate (void **start, INT16U size)
 *                 type call) then your application MUST release the memory storage by call the counterpart
 *                 call of the dynamic allocation scheme used.  If the queue storage was created statically
 *                 then, the storage can be reused.
+*              6) A member of an event set is not deleted, remove it with OSEvSetRemove() first.
 *********************************************************************************************************
 */
 
@@ -238,6 +240,13 @@ OS_EVENT  *OSQDel (OS_EVENT *pevent, INT8U opt, INT8U *perr)
         return (pevent);
     }
     OS_ENTER_CRITICAL();
+#if OS_EVSET_EN > 0
+    if (pevent->OSEventSetMember != (OS_EVSET_MEMBER *)0) {
+        OS_EXIT_CRITICAL();
+        *perr = OS_ERR_EVSET_MEMBER;                       /* The set would keep a dangling member     */
+        return (pevent);
+    }
+#endif
     if (pevent->OSEventGrp != 0) {                         /* See if any tasks waiting on queue        */
         tasks_waiting = OS_TRUE;                           /* Yes                                      */
     } else {
@@ -430,7 +439,7 @@ void  *OSQPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
     }
     OSTCBCur->OSTCBStat     |= OS_STAT_Q;        /* Task will have to pend for a message to be posted  */
     OSTCBCur->OSTCBStatPend  = OS_STAT_PEND_OK;
-    OSTCBCur->OSTCBDly       = timeout;          /* Load timeout into TCB                              */
+    OS_DLY_SET(OSTCBCur, timeout);               /* Load timeout into TCB                              */
     OS_EventTaskWait(pevent);                    /* Suspend task until event or timeout occurs         */
     OS_EXIT_CRITICAL();
     OS_Sched();                                  /* Find next highest priority task ready to run       */
@@ -603,6 +612,11 @@ INT8U  OSQPost (OS_EVENT *pevent, void *pmsg)
     if (pq->OSQIn == pq->OSQEnd) {                     /* Wrap IN ptr if we are at end of queue        */
         pq->OSQIn = pq->OSQStart;
     }
+    if (OS_EVSET_SIGNAL(pevent) == OS_TRUE) {         /* Wake the task waiting on the event set        */
+        OS_EXIT_CRITICAL();
+        OS_Sched();
+        return (OS_ERR_NONE);
+    }
     OS_EXIT_CRITICAL();
     return (OS_ERR_NONE);
 }
@@ -666,6 +680,11 @@ INT8U  OSQPostFront (OS_EVENT *pevent, void *pmsg)
     pq->OSQOut--;
     *pq->OSQOut = pmsg;                               /* Insert message into queue                     */
     pq->OSQEntries++;                                 /* Update the nbr of entries in the queue        */
+    if (OS_EVSET_SIGNAL(pevent) == OS_TRUE) {         /* Wake the task waiting on the event set        */
+        OS_EXIT_CRITICAL();
+        OS_Sched();
+        return (OS_ERR_NONE);
+    }
     OS_EXIT_CRITICAL();
     return (OS_ERR_NONE);
 }
@@ -751,6 +770,13 @@ INT8U  OSQPostOpt (OS_EVENT *pevent, void *pmsg, INT8U opt)
         }
     }
     pq->OSQEntries++;                                 /* Update the nbr of entries in the queue        */
+    if (OS_EVSET_SIGNAL(pevent) == OS_TRUE) {         /* Wake the task waiting on the event set        */
+        OS_EXIT_CRITICAL();
+        if ((opt & OS_POST_OPT_NO_SCHED) == 0) {
+            OS_Sched();
+        }
+        return (OS_ERR_NONE);
+    }
     OS_EXIT_CRITICAL();
     return (OS_ERR_NONE);
 }
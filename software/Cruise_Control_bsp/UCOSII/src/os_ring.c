@@ -0,0 +1,368 @@
+/*
+*********************************************************************************************************
+*                                                uC/OS-II
+*                                          The Real-Time Kernel
+*                               SINGLE-PRODUCER/SINGLE-CONSUMER RING MANAGEMENT
+*
+* File    : OS_RING.C
+* Version : V2.86
+*
+* A ring hands fixed-size entries from one producer (a task or an ISR) to one consumer task without
+* disabling interrupts and without copying: the producer writes into the slots returned by
+* OSRingPutPtr() and publishes them with OSRingPutCommit(), the consumer reads the slots returned by
+* OSRingGetPtr() or OSRingPend() and gives them back with OSRingGetRelease().  OSRingIn is only written
+* by the producer and OSRingOut only by the consumer; a 16-bit store is atomic on the Nios II, and
+* OS_CPU_BARRIER() keeps the compiler from moving the accesses to the entries across the stores of the
+* counters.
+*
+* With OS_RING_OPT_NOTIFY the consumer can wait in OSRingPend().  The producer only posts the ring's
+* semaphore when the consumer found the ring empty and is waiting, so a burst of entries costs one post
+* at most, and none while the consumer keeps up.
+*********************************************************************************************************
+*/
+
+#ifndef  OS_MASTER_FILE
+#include <ucos_ii.h>
+#endif
+
+#if OS_RING_EN > 0
+/*
+*********************************************************************************************************
+*                                             CREATE A RING
+*
+* Description: This function initializes a ring on the storage provided by the caller.
+*
+* Arguments  : pring         is a pointer to the ring control block
+*
+*              pbuf          is a pointer to the storage of the entries, 'entries' * 'entry_size' bytes
+*
+*              entries       is the number of entries, a power of 2 between 1 and 32768
+*
+*              entry_size    is the size of one entry in bytes, a power of 2.  Pad the entry type if
+*                            needed: the Nios II/e has no multiplier, so the slots are found by shifting.
+*
+*              opt           OS_RING_OPT_NONE    the consumer polls with OSRingGetPtr()
+*                            OS_RING_OPT_NOTIFY  the consumer can wait in OSRingPend(), a semaphore is
+*                                                taken from the event control block pool
+*
+*              perr          is a pointer to where an error message will be deposited.  Possible error
+*                            messages are:
+*
+*                            OS_ERR_NONE         The ring was created
+*                            OS_ERR_PDATA_NULL   'pring' or 'pbuf' is a NULL pointer
+*                            OS_ERR_RING_SIZE    'entries' or 'entry_size' is not a power of 2
+*                            OS_ERR_INVALID_OPT  'opt' is not valid
+*                            OS_ERR_CREATE_ISR   OS_RING_OPT_NOTIFY from an ISR
+*                            OS_ERR_PEVENT_NULL  No event control block left for the semaphore
+*
+* Returns    : none
+*********************************************************************************************************
+*/
+
+void  OSRingCreate (OS_RING *pring, void *pbuf, INT16U entries, INT16U entry_size, INT8U opt, INT8U *perr)
+{
+    INT8U  shift;
+
+
+#if OS_ARG_CHK_EN > 0
+    if (perr == (INT8U *)0) {                              /* Validate 'perr'                          */
+        return;
+    }
+    if (pring == (OS_RING *)0 || pbuf == (void *)0) {      /* Validate 'pring' and 'pbuf'              */
+        *perr = OS_ERR_PDATA_NULL;
+        return;
+    }
+#endif
+    if (entries == 0 || entries > 32768u || (entries & (entries - 1)) != 0 ||
+        entry_size == 0 || (entry_size & (entry_size - 1)) != 0) {
+        *perr = OS_ERR_RING_SIZE;
+        return;
+    }
+    for (shift = 0; (1u << shift) < entry_size; shift++) {
+        ;
+    }
+    pring->OSRingStart   = (INT8U *)pbuf;
+    pring->OSRingMask    = entries - 1;
+    pring->OSRingShift   = shift;
+    pring->OSRingWaiting = OS_FALSE;
+    pring->OSRingIn      = 0;
+    pring->OSRingOut     = 0;
+    pring->OSRingFull    = 0;
+#if OS_SEM_EN > 0
+    pring->OSRingSem     = (OS_EVENT *)0;
+#endif
+    switch (opt) {
+        case OS_RING_OPT_NONE:
+             break;
+
+#if OS_SEM_EN > 0
+        case OS_RING_OPT_NOTIFY:
+             if (OSIntNesting > 0) {                       /* OSSemCreate() is not allowed in an ISR   */
+                 *perr = OS_ERR_CREATE_ISR;
+                 return;
+             }
+             pring->OSRingSem = OSSemCreate(0);
+             if (pring->OSRingSem == (OS_EVENT *)0) {
+                 *perr = OS_ERR_PEVENT_NULL;
+                 return;
+             }
+             break;
+#endif
+
+        default:
+             *perr = OS_ERR_INVALID_OPT;
+             return;
+    }
+    *perr = OS_ERR_NONE;
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                             DELETE A RING
+*
+* Description: This function deletes the semaphore of a ring created with OS_RING_OPT_NOTIFY.  Neither
+*              side may use the ring afterwards.
+*
+* Arguments  : pring         is a pointer to the ring control block
+*
+*              perr          is a pointer to where an error message will be deposited.  Possible error
+*                            messages are the ones of OSSemDel(), with OS_DEL_ALWAYS.
+*
+* Returns    : none
+*********************************************************************************************************
+*/
+
+#if (OS_SEM_EN > 0) && (OS_SEM_DEL_EN > 0)
+void  OSRingDel (OS_RING *pring, INT8U *perr)
+{
+#if OS_ARG_CHK_EN > 0
+    if (perr == (INT8U *)0) {                              /* Validate 'perr'                          */
+        return;
+    }
+    if (pring == (OS_RING *)0) {                           /* Validate 'pring'                         */
+        *perr = OS_ERR_PDATA_NULL;
+        return;
+    }
+#endif
+    *perr = OS_ERR_NONE;
+    if (pring->OSRingSem != (OS_EVENT *)0) {
+        (void)OSSemDel(pring->OSRingSem, OS_DEL_ALWAYS, perr);
+        pring->OSRingSem = (OS_EVENT *)0;
+    }
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                          GET FREE SLOTS (PRODUCER)
+*
+* Description: This function returns the next free slot of the ring.  The producer writes the entry
+*              in place and publishes it with OSRingPutCommit().  Free slots behind the first one are
+*              contiguous up to the end of the storage, so a burst can be written with one call.
+*
+* Arguments  : pring         is a pointer to the ring control block
+*
+*              pn            is a pointer to where the number of contiguous free slots is deposited,
+*                            0 if the ring is full
+*
+* Returns    : != (void *)0  is a pointer to the first free slot
+*              == (void *)0  if the ring is full, OSRingFull is incremented
+*
+* Note(s)    : 1) May be called from an ISR.  Only the producer may call this function.
+*********************************************************************************************************
+*/
+
+void  *OSRingPutPtr (OS_RING *pring, INT16U *pn)
+{
+    INT16U  in;
+    INT16U  ix;
+    INT16U  nfree;
+    INT16U  ncont;
+
+
+    in    = pring->OSRingIn;
+    nfree = (INT16U)(pring->OSRingMask + 1 - (INT16U)(in - pring->OSRingOut));
+    if (nfree == 0) {
+        pring->OSRingFull++;
+        *pn = 0;
+        return ((void *)0);
+    }
+    ix    = in & pring->OSRingMask;
+    ncont = (INT16U)(pring->OSRingMask + 1 - ix);          /* Slots up to the end of the storage       */
+    *pn   = (nfree < ncont) ? nfree : ncont;
+    return ((void *)(pring->OSRingStart + ((INT32U)ix << pring->OSRingShift)));
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                          PUBLISH ENTRIES (PRODUCER)
+*
+* Description: This function hands the next 'n' slots, written after OSRingPutPtr(), to the consumer.
+*              If the consumer waits in OSRingPend(), it is made ready.
+*
+* Arguments  : pring         is a pointer to the ring control block
+*
+*              n             is the number of entries written, at most the count from OSRingPutPtr()
+*
+* Returns    : none
+*
+* Note(s)    : 1) May be called from an ISR.  Only the producer may call this function.
+*              2) A task producer is preempted here if the woken consumer has a higher priority.
+*********************************************************************************************************
+*/
+
+void  OSRingPutCommit (OS_RING *pring, INT16U n)
+{
+    OS_CPU_BARRIER();                                      /* The entries are written before ...       */
+    pring->OSRingIn += n;                                  /* ... they are published                   */
+    OS_CPU_BARRIER();
+#if OS_SEM_EN > 0
+    if (pring->OSRingWaiting == OS_TRUE) {                 /* Empty -> non-empty with a waiting reader */
+        pring->OSRingWaiting = OS_FALSE;
+        (void)OSSemPost(pring->OSRingSem);
+    }
+#endif
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                          GET ENTRIES (CONSUMER)
+*
+* Description: This function returns the oldest entry of the ring without removing it.  The entries
+*              behind it are contiguous up to the end of the storage, so a burst can be read with one
+*              call.  The consumer gives the slots back with OSRingGetRelease().
+*
+* Arguments  : pring         is a pointer to the ring control block
+*
+*              pn            is a pointer to where the number of contiguous entries is deposited,
+*                            0 if the ring is empty
+*
+* Returns    : != (void *)0  is a pointer to the oldest entry
+*              == (void *)0  if the ring is empty
+*
+* Note(s)    : 1) Only the consumer may call this function.
+*********************************************************************************************************
+*/
+
+void  *OSRingGetPtr (OS_RING *pring, INT16U *pn)
+{
+    INT16U  out;
+    INT16U  ix;
+    INT16U  nused;
+    INT16U  ncont;
+
+
+    out   = pring->OSRingOut;
+    nused = (INT16U)(pring->OSRingIn - out);
+    OS_CPU_BARRIER();                                      /* The entries are read after the count     */
+    if (nused == 0) {
+        *pn = 0;
+        return ((void *)0);
+    }
+    ix    = out & pring->OSRingMask;
+    ncont = (INT16U)(pring->OSRingMask + 1 - ix);
+    *pn   = (nused < ncont) ? nused : ncont;
+    return ((void *)(pring->OSRingStart + ((INT32U)ix << pring->OSRingShift)));
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                          RELEASE ENTRIES (CONSUMER)
+*
+* Description: This function gives the oldest 'n' entries, read after OSRingGetPtr() or OSRingPend(),
+*              back to the producer.
+*
+* Arguments  : pring         is a pointer to the ring control block
+*
+*              n             is the number of entries read, at most the count from OSRingGetPtr()
+*
+* Returns    : none
+*
+* Note(s)    : 1) Only the consumer may call this function.
+*********************************************************************************************************
+*/
+
+void  OSRingGetRelease (OS_RING *pring, INT16U n)
+{
+    OS_CPU_BARRIER();                                      /* The entries are read before ...          */
+    pring->OSRingOut += n;                                 /* ... the producer may overwrite them      */
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                       WAIT FOR ENTRIES (CONSUMER)
+*
+* Description: This function returns the oldest entry of the ring like OSRingGetPtr() and waits until
+*              the producer commits one if the ring is empty.
+*
+* Arguments  : pring         is a pointer to the ring control block, created with OS_RING_OPT_NOTIFY
+*
+*              pn            is a pointer to where the number of contiguous entries is deposited
+*
+*              timeout       is an optional timeout period (in clock ticks), 0 waits forever.  The
+*                            timeout restarts after a spurious wake-up (note 2).
+*
+*              perr          is a pointer to where an error message will be deposited.  Possible error
+*                            messages are:
+*
+*                            OS_ERR_NONE         There are entries in the ring
+*                            OS_ERR_EVENT_TYPE   The ring was created without OS_RING_OPT_NOTIFY
+*                            OS_ERR_TIMEOUT      The ring stayed empty for 'timeout' ticks
+*                            OS_ERR_PEND_ISR     Called from an ISR
+*                            OS_ERR_PEND_LOCKED  Called with the scheduler locked
+*                            OS_ERR_PEND_ABORT   The wait on the semaphore was aborted
+*
+* Returns    : != (void *)0  is a pointer to the oldest entry
+*              == (void *)0  if there is no entry
+*
+* Note(s)    : 1) Only the consumer may call this function.
+*              2) OSRingWaiting is set before the ring is checked again, so a commit between the check
+*                 and OSSemPend() leaves the semaphore signalled and the wait returns at once.  A commit
+*                 between the check and the reset of OSRingWaiting posts although the consumer does not
+*                 wait; the next wait then returns with an empty ring and is repeated.
+*********************************************************************************************************
+*/
+
+#if OS_SEM_EN > 0
+void  *OSRingPend (OS_RING *pring, INT16U *pn, INT16U timeout, INT8U *perr)
+{
+    void  *pentry;
+
+
+#if OS_ARG_CHK_EN > 0
+    if (perr == (INT8U *)0) {                              /* Validate 'perr'                          */
+        return ((void *)0);
+    }
+    if (pring == (OS_RING *)0 || pn == (INT16U *)0) {      /* Validate 'pring' and 'pn'                */
+        *perr = OS_ERR_PDATA_NULL;
+        return ((void *)0);
+    }
+#endif
+    if (pring->OSRingSem == (OS_EVENT *)0) {
+        *pn   = 0;
+        *perr = OS_ERR_EVENT_TYPE;
+        return ((void *)0);
+    }
+    for (;;) {
+        pentry = OSRingGetPtr(pring, pn);
+        if (pentry != (void *)0) {
+            *perr = OS_ERR_NONE;
+            return (pentry);
+        }
+        pring->OSRingWaiting = OS_TRUE;                    /* Ask the producer for a post ...          */
+        OS_CPU_BARRIER();
+        pentry = OSRingGetPtr(pring, pn);                  /* ... and check again, see note 2          */
+        if (pentry != (void *)0) {
+            pring->OSRingWaiting = OS_FALSE;
+            *perr = OS_ERR_NONE;
+            return (pentry);
+        }
+        OSSemPend(pring->OSRingSem, timeout, perr);
+        if (*perr != OS_ERR_NONE) {
+            pring->OSRingWaiting = OS_FALSE;
+            return (OSRingGetPtr(pring, pn));              /* An entry may have arrived meanwhile      */
+        }
+    }
+}
+#endif
+#endif                                                     /* OS_RING_EN                               */
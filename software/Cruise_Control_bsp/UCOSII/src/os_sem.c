@@ -144,6 +144,7 @@ OS_EVENT  *OSSemCreate (INT16U cnt)
 *                            OS_ERR_TASK_WAITING     One or more tasks were waiting on the semaphore
 *                            OS_ERR_EVENT_TYPE       If you didn't pass a pointer to a semaphore
 *                            OS_ERR_PEVENT_NULL      If 'pevent' is a NULL pointer.
+*                            OS_ERR_EVSET_MEMBER     If the semaphore is still a member of an event set
 *
 * Returns    : pevent        upon error
 *              (OS_EVENT *)0 if the semaphore was successfully deleted.
@@ -157,6 +158,7 @@ OS_EVENT  *OSSemCreate (INT16U cnt)
 *              4) Because ALL tasks pending on the semaphore will be readied, you MUST be careful in
 *                 applications where the semaphore is used for mutual exclusion because the resource(s)
 *                 will no longer be guarded by the semaphore.
+*              5) A member of an event set is not deleted, remove it with OSEvSetRemove() first.
 *********************************************************************************************************
 */
 
@@ -189,6 +191,13 @@ OS_EVENT  *OSSemDel (OS_EVENT *pevent, INT8U opt, INT8U *perr)
         return (pevent);
     }
     OS_ENTER_CRITICAL();
+#if OS_EVSET_EN > 0
+    if (pevent->OSEventSetMember != (OS_EVSET_MEMBER *)0) {
+        OS_EXIT_CRITICAL();
+        *perr = OS_ERR_EVSET_MEMBER;                       /* The set would keep a dangling member     */
+        return (pevent);
+    }
+#endif
     if (pevent->OSEventGrp != 0) {                         /* See if any tasks waiting on semaphore    */
         tasks_waiting = OS_TRUE;                           /* Yes                                      */
     } else {
@@ -307,6 +316,7 @@ void  OSSemPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
         *perr = OS_ERR_PEND_LOCKED;                   /* ... can't PEND when locked                    */
         return;
     }
+    OS_TRACE(OS_TRACE_SEM_PEND, OS_TRACE_EVENT_IX(pevent));
     OS_ENTER_CRITICAL();
     if (pevent->OSEventCnt > 0) {                     /* If sem. is positive, resource available ...   */
         pevent->OSEventCnt--;                         /* ... decrement semaphore only if positive.     */
@@ -317,7 +327,7 @@ void  OSSemPend (OS_EVENT *pevent, INT16U timeout, INT8U *perr)
                                                       /* Otherwise, must wait until event occurs       */
     OSTCBCur->OSTCBStat     |= OS_STAT_SEM;           /* Resource not available, pend on semaphore     */
     OSTCBCur->OSTCBStatPend  = OS_STAT_PEND_OK;
-    OSTCBCur->OSTCBDly       = timeout;               /* Store pend timeout in TCB                     */
+    OS_DLY_SET(OSTCBCur, timeout);                    /* Store pend timeout in TCB                     */
     OS_EventTaskWait(pevent);                         /* Suspend task until event or timeout occurs    */
     OS_EXIT_CRITICAL();
     OS_Sched();                                       /* Find next highest priority task ready         */
@@ -466,6 +476,7 @@ INT8U  OSSemPost (OS_EVENT *pevent)
     if (pevent->OSEventType != OS_EVENT_TYPE_SEM) {   /* Validate event block type                     */
         return (OS_ERR_EVENT_TYPE);
     }
+    OS_TRACE(OS_TRACE_SEM_POST, OS_TRACE_EVENT_IX(pevent));
     OS_ENTER_CRITICAL();
     if (pevent->OSEventGrp != 0) {                    /* See if any task waiting for semaphore         */
                                                       /* Ready HPT waiting on event                    */
@@ -476,6 +487,11 @@ INT8U  OSSemPost (OS_EVENT *pevent)
     }
     if (pevent->OSEventCnt < 65535u) {                /* Make sure semaphore will not overflow         */
         pevent->OSEventCnt++;                         /* Increment semaphore count to register event   */
+        if (OS_EVSET_SIGNAL(pevent) == OS_TRUE) {     /* Wake the task waiting on the event set        */
+            OS_EXIT_CRITICAL();
+            OS_Sched();
+            return (OS_ERR_NONE);
+        }
         OS_EXIT_CRITICAL();
         return (OS_ERR_NONE);
     }
@@ -602,6 +618,13 @@ void  OSSemSet (OS_EVENT *pevent, INT16U cnt, INT8U *perr)
             *perr              = OS_ERR_TASK_WAITING;
         }
     }
+    if (pevent->OSEventCnt > 0) {
+        if (OS_EVSET_SIGNAL(pevent) == OS_TRUE) {     /* Wake the task waiting on the event set        */
+            OS_EXIT_CRITICAL();
+            OS_Sched();
+            return;
+        }
+    }
     OS_EXIT_CRITICAL();
 }
 #endif
@@ -121,6 +121,12 @@ INT8U  OSTaskChangePrio (INT8U oldprio, INT8U newprio)
     y_old                 =  ptcb->OSTCBY;
     bity_old              =  ptcb->OSTCBBitY;
     bitx_old              =  ptcb->OSTCBBitX;
+#if OS_RDY_MASK_EN > 0
+    if (OS_RDY_IS_SET(ptcb)) {                              /* If task is ready make it not            */
+         OS_RDY_CLR(ptcb);
+         OSRdyMask       |= (INT32U)1 << newprio;           /* Make new priority ready to run          */
+    }
+#else
     if ((OSRdyTbl[y_old] &   bitx_old) != 0) {              /* If task is ready make it not            */
          OSRdyTbl[y_old] &= ~bitx_old;
          if (OSRdyTbl[y_old] == 0) {
@@ -129,6 +135,7 @@ INT8U  OSTaskChangePrio (INT8U oldprio, INT8U newprio)
          OSRdyGrp        |= bity_new;                       /* Make new priority ready to run          */
          OSRdyTbl[y_new] |= bitx_new;
     }
+#endif
 
 #if (OS_EVENT_EN)
     pevent = ptcb->OSTCBEventPtr;
@@ -163,6 +170,9 @@ INT8U  OSTaskChangePrio (INT8U oldprio, INT8U newprio)
     ptcb->OSTCBX    = x_new;
     ptcb->OSTCBBitY = bity_new;
     ptcb->OSTCBBitX = bitx_new;
+#if OS_RDY_MASK_EN > 0
+    ptcb->OSTCBBitPrio = (INT32U)1 << newprio;
+#endif
     OS_EXIT_CRITICAL();
     if (OSRunning == OS_TRUE) {
         OS_Sched();                                         /* Find new highest priority task          */
@@ -382,6 +392,80 @@ INT8U  OSTaskCreateExt (void   (*task)(void *p_arg),
 /*$PAGE*/
 /*
 *********************************************************************************************************
+*                                         CREATE A PERIODIC TASK
+*
+* Description: This function creates a task like OSTaskCreateExt() and makes it periodic.  The task calls
+*              OSTimeDlyPeriod() before each job; the first call returns 'offset' ticks after the
+*              creation and each further call 'period' ticks after the previous release.  The releases
+*              go through the delay list, so OSTimeTick() readies the task directly, without a timer,
+*              the timer task or a semaphore:
+*
+*                            void Task (void *p_arg)
+*                            {
+*                                for (;;) {
+*                                    OSTimeDlyPeriod();
+*                                    Job code;
+*                                }
+*                            }
+*
+* Arguments  : task ... opt  are the arguments of OSTaskCreateExt().
+*
+*              period    is the period in ticks (1 or more).
+*
+*              offset    is the number of ticks from the creation to the first release.
+*
+*              deadline  is the deadline in ticks relative to each release, 0 for the period.  A job that
+*                        completes later is counted in the OSTCBMisses field of the TCB.
+*
+* Returns    : OS_ERR_TASK_PERIOD     if 'period' is 0 or 'deadline' is longer than the period.
+*              the other errors of OSTaskCreateExt().
+*********************************************************************************************************
+*/
+#if (OS_TASK_CREATE_EXT_EN > 0) && (OS_TASK_PERIODIC_EN > 0)
+INT8U  OSTaskCreatePeriodic (void   (*task)(void *p_arg),
+                             void    *p_arg,
+                             OS_STK  *ptos,
+                             INT8U    prio,
+                             INT16U   id,
+                             OS_STK  *pbos,
+                             INT32U   stk_size,
+                             void    *pext,
+                             INT16U   opt,
+                             INT16U   period,
+                             INT16U   offset,
+                             INT16U   deadline)
+{
+    OS_TCB    *ptcb;
+    INT8U      err;
+#if OS_CRITICAL_METHOD == 3                  /* Allocate storage for CPU status register               */
+    OS_CPU_SR  cpu_sr = 0;
+#endif
+
+
+
+    if (deadline == 0) {
+        deadline = period;
+    }
+    if (period == 0 || deadline > period) {
+        return (OS_ERR_TASK_PERIOD);
+    }
+    OSSchedLock();                           /* The task must not run before it is periodic            */
+    err = OSTaskCreateExt(task, p_arg, ptos, prio, id, pbos, stk_size, pext, opt);
+    if (err == OS_ERR_NONE) {
+        OS_ENTER_CRITICAL();
+        ptcb                = OSTCBPrioTbl[prio];
+        ptcb->OSTCBPeriod   = period;
+        ptcb->OSTCBDeadline = deadline;
+        ptcb->OSTCBRelease  = OSTime + offset - period;  /* OSTimeDlyPeriod() adds the period first  */
+        OS_EXIT_CRITICAL();
+    }
+    OSSchedUnlock();
+    return (err);
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
 *                                            DELETE A TASK
 *
 * Description: This function allows you to delete a task.  The calling task can delete itself by
@@ -458,10 +542,7 @@ INT8U  OSTaskDel (INT8U prio)
         return (OS_ERR_TASK_DEL);
     }
 
-    OSRdyTbl[ptcb->OSTCBY] &= ~ptcb->OSTCBBitX;
-    if (OSRdyTbl[ptcb->OSTCBY] == 0) {                  /* Make task not ready                         */
-        OSRdyGrp           &= ~ptcb->OSTCBBitY;
-    }
+    OS_RDY_CLR(ptcb);                                   /* Make task not ready                         */
     
 #if (OS_EVENT_EN)
     if (ptcb->OSTCBEventPtr != (OS_EVENT *)0) {
@@ -481,7 +562,7 @@ INT8U  OSTaskDel (INT8U prio)
     }
 #endif
 
-    ptcb->OSTCBDly      = 0;                            /* Prevent OSTimeTick() from updating          */
+    OS_DLY_CLR(ptcb);                                   /* Prevent OSTimeTick() from updating          */
     ptcb->OSTCBStat     = OS_STAT_RDY;                  /* Prevent task from being resumed             */
     ptcb->OSTCBStatPend = OS_STAT_PEND_OK;
     if (OSLockNesting < 255u) {                         /* Make sure we don't context switch           */
@@ -815,8 +896,7 @@ INT8U  OSTaskResume (INT8U prio)
         ptcb->OSTCBStat &= ~(INT8U)OS_STAT_SUSPEND;           /* Remove suspension                     */
         if (ptcb->OSTCBStat == OS_STAT_RDY) {                 /* See if task is now ready              */
             if (ptcb->OSTCBDly == 0) {
-                OSRdyGrp               |= ptcb->OSTCBBitY;    /* Yes, Make task ready to run           */
-                OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+                OS_RDY_SET(ptcb);                             /* Yes, Make task ready to run           */
                 OS_EXIT_CRITICAL();
                 if (OSRunning == OS_TRUE) {
                     OS_Sched();                               /* Find new highest priority task        */
@@ -942,7 +1022,6 @@ INT8U  OSTaskSuspend (INT8U prio)
 {
     BOOLEAN    self;
     OS_TCB    *ptcb;
-    INT8U      y;
 #if OS_CRITICAL_METHOD == 3                      /* Allocate storage for CPU status register           */
     OS_CPU_SR  cpu_sr = 0;
 #endif
@@ -977,11 +1056,7 @@ INT8U  OSTaskSuspend (INT8U prio)
         OS_EXIT_CRITICAL();
         return (OS_ERR_TASK_NOT_EXIST);
     }
-    y            = ptcb->OSTCBY;
-    OSRdyTbl[y] &= ~ptcb->OSTCBBitX;                            /* Make task not ready                 */
-    if (OSRdyTbl[y] == 0) {
-        OSRdyGrp &= ~ptcb->OSTCBBitY;
-    }
+    OS_RDY_CLR(ptcb);                                           /* Make task not ready                 */
     ptcb->OSTCBStat |= OS_STAT_SUSPEND;                         /* Status of task is 'SUSPENDED'       */
     OS_EXIT_CRITICAL();
     if (self == OS_TRUE) {                                      /* Context switch only if SELF         */
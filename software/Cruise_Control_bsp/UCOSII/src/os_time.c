@@ -43,7 +43,6 @@
 
 void  OSTimeDly (INT16U ticks)
 {
-    INT8U      y;
 #if OS_CRITICAL_METHOD == 3                      /* Allocate storage for CPU status register           */
     OS_CPU_SR  cpu_sr = 0;
 #endif
@@ -55,12 +54,8 @@ void  OSTimeDly (INT16U ticks)
     }
     if (ticks > 0) {                             /* 0 means no delay!                                  */
         OS_ENTER_CRITICAL();
-        y            =  OSTCBCur->OSTCBY;        /* Delay current task                                 */
-        OSRdyTbl[y] &= ~OSTCBCur->OSTCBBitX;
-        if (OSRdyTbl[y] == 0) {
-            OSRdyGrp &= ~OSTCBCur->OSTCBBitY;
-        }
-        OSTCBCur->OSTCBDly = ticks;              /* Load ticks in TCB                                  */
+        OS_RDY_CLR(OSTCBCur);                    /* Delay current task                                 */
+        OS_DLY_SET(OSTCBCur, ticks);             /* Load ticks in TCB                                  */
         OS_EXIT_CRITICAL();
         OS_Sched();                              /* Find next task to run!                             */
     }
@@ -68,6 +63,76 @@ void  OSTimeDly (INT16U ticks)
 /*$PAGE*/
 /*
 *********************************************************************************************************
+*                                    DELAY TASK UNTIL ITS NEXT RELEASE
+*
+* Description: This function is called by a task created with OSTaskCreatePeriodic() before each job.  It
+*              delays the task until its next release, a whole number of periods after the first one, so
+*              the releases do not drift with the execution time of the jobs.  A task that is late is not
+*              delayed and catches up one release per call.
+*
+* Arguments  : none
+*
+* Returns    : OS_ERR_NONE              the task waited for its next release, or its first release has
+*                                       passed already, the task was not delayed.  The first job is
+*                                       checked against its deadline like any other when it ends.
+*              OS_ERR_TIME_DEADLINE     the job that just ended missed its deadline, whether the task was
+*                                       delayed or not
+*              OS_ERR_TIME_OVERRUN      the next release has already passed, the task was not delayed
+*              OS_ERR_TIME_DLY_ISR      if called from an ISR
+*              OS_ERR_PEND_LOCKED       if called with the scheduler locked
+*              OS_ERR_TASK_NOT_PERIODIC if the task was not created with OSTaskCreatePeriodic()
+*********************************************************************************************************
+*/
+
+#if OS_TASK_PERIODIC_EN > 0
+INT8U  OSTimeDlyPeriod (void)
+{
+    OS_TCB    *ptcb;
+    INT32S     ticks;
+    INT8U      err;
+#if OS_CRITICAL_METHOD == 3                      /* Allocate storage for CPU status register           */
+    OS_CPU_SR  cpu_sr = 0;
+#endif
+
+
+
+    if (OSIntNesting > 0) {                      /* See if trying to call from an ISR                  */
+        return (OS_ERR_TIME_DLY_ISR);
+    }
+    if (OSLockNesting > 0) {                     /* See if called with scheduler locked                */
+        return (OS_ERR_PEND_LOCKED);
+    }
+    ptcb = OSTCBCur;
+    if (ptcb->OSTCBPeriod == 0) {
+        return (OS_ERR_TASK_NOT_PERIODIC);
+    }
+    err = OS_ERR_NONE;
+    OS_ENTER_CRITICAL();
+    if (ptcb->OSTCBJobs > 0 &&                   /* Check the deadline of the job that just ended      */
+        OSTime - ptcb->OSTCBRelease > ptcb->OSTCBDeadline) {
+        ptcb->OSTCBMisses++;
+        err = OS_ERR_TIME_DEADLINE;
+    }
+    ptcb->OSTCBRelease += ptcb->OSTCBPeriod;
+    ptcb->OSTCBJobs++;
+    ticks = (INT32S)(ptcb->OSTCBRelease - OSTime);
+    if (ticks <= 0) {                            /* Released already, run the next job now             */
+        OS_EXIT_CRITICAL();
+        if (err == OS_ERR_NONE && ptcb->OSTCBJobs > 1) {
+            err = OS_ERR_TIME_OVERRUN;           /* A miss takes precedence, it is already counted     */
+        }
+        return (err);
+    }
+    OS_RDY_CLR(ptcb);                            /* Delay current task until the release               */
+    OS_DLY_SET(ptcb, (INT16U)ticks);
+    OS_EXIT_CRITICAL();
+    OS_Sched();                                  /* Find next task to run!                             */
+    return (err);
+}
+#endif
+/*$PAGE*/
+/*
+*********************************************************************************************************
 *                                     DELAY TASK FOR SPECIFIED TIME
 *
 * Description: This function is called to delay execution of the currently running task until some time
@@ -191,7 +256,7 @@ INT8U  OSTimeDlyResume (INT8U prio)
         return (OS_ERR_TIME_NOT_DLY);                          /* Indicate that task was not delayed   */
     }
 
-    ptcb->OSTCBDly = 0;                                        /* Clear the time delay                 */
+    OS_DLY_CLR(ptcb);                                          /* Clear the time delay                 */
     if ((ptcb->OSTCBStat & OS_STAT_PEND_ANY) != OS_STAT_RDY) {
         ptcb->OSTCBStat     &= ~OS_STAT_PEND_ANY;              /* Yes, Clear status flag               */
         ptcb->OSTCBStatPend  =  OS_STAT_PEND_TO;               /* Indicate PEND timeout                */
@@ -199,8 +264,7 @@ INT8U  OSTimeDlyResume (INT8U prio)
         ptcb->OSTCBStatPend  =  OS_STAT_PEND_OK;
     }
     if ((ptcb->OSTCBStat & OS_STAT_SUSPEND) == OS_STAT_RDY) {  /* Is task suspended?                   */
-        OSRdyGrp               |= ptcb->OSTCBBitY;             /* No,  Make ready                      */
-        OSRdyTbl[ptcb->OSTCBY] |= ptcb->OSTCBBitX;
+        OS_RDY_SET(ptcb);                                      /* No,  Make ready                      */
         OS_EXIT_CRITICAL();
         OS_Sched();                                            /* See if this is new highest priority  */
     } else {
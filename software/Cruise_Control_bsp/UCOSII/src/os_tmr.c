@@ -33,7 +33,15 @@
 *    OS_TASK_TMR_PRIO          The priority of the Timer management task
 *    OS_TASK_TMR_STK_SIZE      The size     of the Timer management task's stack
 *
-* 2) You must call OSTmrSignal() to notify the Timer management task that it's time to update the timers.
+* 2) You must call OSTmrSignal() to notify the Timer management task that it's time to update the timers.  On this
+*    port OSTimeTickHook() does so OS_TMR_CFG_TICKS_PER_SEC times per second, it should be the only caller.
+*
+* 3) With OS_TMR_HIER_EN the timers are kept in a hierarchical wheel of OS_TMR_CFG_WHEEL_LEVELS levels with
+*    2^OS_TMR_CFG_WHEEL_BITS spokes each.  A timer goes to the lowest level whose span covers its expiry, so the
+*    spoke of level 0 for the current time only holds expiring timers.  When the lower levels complete a round,
+*    the next spoke of the level above is moved down (cascaded).  Insertion and removal are O(1) and each timer is
+*    cascaded at most OS_TMR_CFG_WHEEL_LEVELS - 1 times, instead of scanning 1/OS_TMR_CFG_WHEEL_SIZE of all
+*    timers per tick.
 ************************************************************************************************************************
 */
 
@@ -57,6 +65,10 @@ static  OS_TMR  *OSTmr_Alloc         (void);
 static  void     OSTmr_Free          (OS_TMR *ptmr);
 static  void     OSTmr_InitTask      (void);
 static  void     OSTmr_Link          (OS_TMR *ptmr, INT8U type);
+#if OS_TMR_HIER_EN > 0
+static  void     OSTmr_Insert        (OS_TMR *ptmr);
+static  void     OSTmr_Cascade       (void);
+#endif
 static  void     OSTmr_Unlink        (OS_TMR *ptmr);
 static  void     OSTmr_Lock          (void);
 static  void     OSTmr_Unlock        (void);
@@ -949,9 +961,11 @@ static  void  OSTmr_InitTask (void)
 #if OS_TMR_EN > 0
 static  void  OSTmr_Link (OS_TMR *ptmr, INT8U type)
 {
+#if OS_TMR_HIER_EN == 0
     OS_TMR       *ptmr1;
     OS_TMR_WHEEL *pspoke;
     INT16U        spoke;
+#endif
 
 
     ptmr->OSTmrState = OS_TMR_STATE_RUNNING;
@@ -964,6 +978,9 @@ static  void  OSTmr_Link (OS_TMR *ptmr, INT8U type)
             ptmr->OSTmrMatch = ptmr->OSTmrDly    + OSTmrTime;
         }
     }
+#if OS_TMR_HIER_EN > 0
+    OSTmr_Insert(ptmr);
+#else
     spoke  = (INT16U)(ptmr->OSTmrMatch % OS_TMR_CFG_WHEEL_SIZE);
     pspoke = &OSTmrWheelTbl[spoke];
 
@@ -979,6 +996,95 @@ static  void  OSTmr_Link (OS_TMR *ptmr, INT8U type)
         pspoke->OSTmrEntries++;
     }
     ptmr->OSTmrPrev = (void *)0;                                   /* Timer always inserted as first node in list     */
+#endif
+}
+#endif
+
+/*$PAGE*/
+/*
+************************************************************************************************************************
+*                                  INSERT A TIMER INTO THE HIERARCHICAL TIMER WHEEL
+*
+* Description: This function puts a timer on the lowest level of the wheel on which its match time and the current
+*              time only differ in the digits of that level or below.  Timers too far ahead go to the top level and are
+*              put back there until they come within reach.
+*
+* Arguments  : ptmr          Is a pointer to the timer to insert, 'OSTmrMatch' must be set.
+*
+* Returns    : none
+************************************************************************************************************************
+*/
+
+#if OS_TMR_EN > 0 && OS_TMR_HIER_EN > 0
+static  void  OSTmr_Insert (OS_TMR *ptmr)
+{
+    OS_TMR       *ptmr1;
+    OS_TMR_WHEEL *pspoke;
+    INT32U        diff;
+    INT16U        level;
+
+
+    diff  = ptmr->OSTmrMatch ^ OSTmrTime;                          /* Digits that change until the timer expires      */
+    level = 0;
+    while (level < OS_TMR_CFG_WHEEL_LEVELS - 1 &&
+           (diff >> (OS_TMR_CFG_WHEEL_BITS * (level + 1))) != 0) {
+        level++;
+    }
+    ptmr->OSTmrSpoke = (INT16U)((level << OS_TMR_CFG_WHEEL_BITS) |
+                                ((ptmr->OSTmrMatch >> (OS_TMR_CFG_WHEEL_BITS * level)) & OS_TMR_WHEEL_MASK));
+    pspoke = &OSTmrWheelTbl[ptmr->OSTmrSpoke];
+
+    ptmr1              = pspoke->OSTmrFirst;                       /* Link at the beginning of the spoke              */
+    pspoke->OSTmrFirst = ptmr;
+    ptmr->OSTmrNext    = (void *)ptmr1;
+    ptmr->OSTmrPrev    = (void *)0;
+    if (ptmr1 != (OS_TMR *)0) {
+        ptmr1->OSTmrPrev = (void *)ptmr;
+    }
+    pspoke->OSTmrEntries++;
+}
+
+/*$PAGE*/
+/*
+************************************************************************************************************************
+*                                          CASCADE THE HIERARCHICAL TIMER WHEEL
+*
+* Description: This function is called by OSTmr_Task() after 'OSTmrTime' has been incremented.  For each level whose
+*              round below has completed, from the highest down, the timers of the spoke that starts now are moved to
+*              the lower levels.  A timer can move down more than one level in the same call.
+*
+* Arguments  : none
+*
+* Returns    : none
+************************************************************************************************************************
+*/
+
+static  void  OSTmr_Cascade (void)
+{
+    OS_TMR       *ptmr;
+    OS_TMR       *ptmr_next;
+    OS_TMR_WHEEL *pspoke;
+    INT16U        level;
+
+
+    level = 0;
+    while (level < OS_TMR_CFG_WHEEL_LEVELS - 1 &&
+           (OSTmrTime & ((1uL << (OS_TMR_CFG_WHEEL_BITS * (level + 1))) - 1uL)) == 0) {
+        level++;
+    }
+    while (level > 0) {
+        pspoke = &OSTmrWheelTbl[(level << OS_TMR_CFG_WHEEL_BITS) |
+                                ((OSTmrTime >> (OS_TMR_CFG_WHEEL_BITS * level)) & OS_TMR_WHEEL_MASK)];
+        ptmr                 = pspoke->OSTmrFirst;
+        pspoke->OSTmrFirst   = (OS_TMR *)0;
+        pspoke->OSTmrEntries = 0;
+        while (ptmr != (OS_TMR *)0) {
+            ptmr_next = (OS_TMR *)ptmr->OSTmrNext;
+            OSTmr_Insert(ptmr);
+            ptmr      = ptmr_next;
+        }
+        level--;
+    }
 }
 #endif
 
@@ -1004,7 +1110,11 @@ static  void  OSTmr_Unlink (OS_TMR *ptmr)
     INT16U         spoke;
 
 
+#if OS_TMR_HIER_EN > 0
+    spoke  = ptmr->OSTmrSpoke;
+#else
     spoke  = (INT16U)(ptmr->OSTmrMatch % OS_TMR_CFG_WHEEL_SIZE);
+#endif
     pspoke = &OSTmrWheelTbl[spoke];
 
     if (pspoke->OSTmrFirst == ptmr) {                       /* See if timer to remove is at the beginning of list     */
@@ -1090,13 +1200,19 @@ static  void  OSTmr_Task (void *p_arg)
         OSSemPend(OSTmrSemSignal, 0, &err);                      /* Wait for signal indicating time to update timers  */
         OSTmr_Lock();
         OSTmrTime++;                                             /* Increment the current time                        */
+#if OS_TMR_HIER_EN > 0
+        OSTmr_Cascade();
+        spoke  = (INT16U)(OSTmrTime & OS_TMR_WHEEL_MASK);        /* All timers on this level 0 spoke expire now       */
+#else
         spoke  = (INT16U)(OSTmrTime % OS_TMR_CFG_WHEEL_SIZE);    /* Position on current timer wheel entry             */
+#endif
         pspoke = &OSTmrWheelTbl[spoke];
         ptmr   = pspoke->OSTmrFirst;
         while (ptmr != (OS_TMR *)0) {
             ptmr_next = (OS_TMR *)ptmr->OSTmrNext;               /* Point to next timer to update because current ... */
                                                                  /* ... timer could get unlinked from the wheel.      */
             if (OSTmrTime == ptmr->OSTmrMatch) {                 /* Process each timer that expires                   */
+                OS_TRACE(OS_TRACE_TMR_EXPIRE, ptmr - OSTmrTbl);
                 pfnct = ptmr->OSTmrCallback;                     /* Execute callback function if available            */
                 if (pfnct != (OS_TMR_CALLBACK)0) {
                     (*pfnct)((void *)ptmr, ptmr->OSTmrCallbackArg);
@@ -0,0 +1,233 @@
+/*
+*********************************************************************************************************
+*                                                uC/OS-II
+*                                          The Real-Time Kernel
+*                                            CPU UTILIZATION
+*
+* File    : OS_UTIL.C
+* Version : V2.86
+*
+* OSCPUUsage used to compare the idle counter against OSIdleCtrMax, calibrated once by OSStatInit(): any
+* change of the speed of the idle loop, like the tickless idle, skewed it, and its resolution was 1%.
+* With OS_TASK_PROFILE_EN, OSTaskSwHook() timestamps every switch to and from the idle task and adds the
+* cycles in between, less the cycles of the interrupt handlers, to the OSTCBCyclesTot field of its TCB.
+* The statistics task calls OS_CPUUtilSample() every 1/10 second: the cycles since the last sample that
+* were not spent in the idle task are the CPU used.
+*
+* The last 100 samples are kept to average them over 1 second and 10 seconds, with a resolution of 0.01%.
+* The windows are counted in samples; when the CPU is saturated, the statistics task runs late and so
+* does the end of the window, but its length is measured and the averages stay right.
+*********************************************************************************************************
+*/
+
+#ifndef  OS_MASTER_FILE
+#include <ucos_ii.h>
+#endif
+
+#if OS_CPU_UTIL_EN > 0
+/*
+*********************************************************************************************************
+*                                            LOCAL CONSTANTS
+*********************************************************************************************************
+*/
+
+#define  OS_UTIL_SAMPLES          100u          /* Samples kept, 10 seconds                             */
+#define  OS_UTIL_SAMPLES_1S        10u
+#define  OS_UTIL_LEN_MAX       429496uL         /* 2^32 / 10000, see OS_CPUUtilRatio()                  */
+
+/*
+*********************************************************************************************************
+*                                            LOCAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  INT32U            OSUtilBusy[OS_UTIL_SAMPLES];   /* Cycles outside the idle task in each sample */
+static  INT32U            OSUtilLen[OS_UTIL_SAMPLES];    /* Length of each sample in cycles             */
+static  INT8U             OSUtilIx;                      /* Slot of the next sample                     */
+static  INT32U            OSUtilBusy1s;                  /* Sums over the last 10 and 100 samples       */
+static  INT32U            OSUtilLen1s;
+static  INT32U            OSUtilBusy10s;
+static  INT32U            OSUtilLen10s;
+static  BOOLEAN           OSUtilStarted;
+static  INT32U            OSUtilStamp;                   /* OS_TS_GET() at the last sample              */
+static  INT32U            OSUtilIdle;                    /* Cycles of the idle task at the last sample  */
+static  OS_CPU_UTIL_DATA  OSUtilData;
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                        SHARE OF A WINDOW IN 0.01%
+*
+* Description: This function returns 'busy' / 'len' in 0.01%.  Both are shifted until 'busy' * 10000
+*              fits in 32 bits, which still leaves more than 200000 steps in 'len'.
+*
+* Arguments  : busy          is the number of cycles used, at most 'len'
+*
+*              len           is the length of the window in cycles
+*
+* Returns    : the share, 0 to 10000
+*
+* Note(s)    : 1) This function is INTERNAL to this file.
+*********************************************************************************************************
+*/
+
+static  INT16U  OS_CPUUtilRatio (INT32U busy, INT32U len)
+{
+    while (len >= OS_UTIL_LEN_MAX) {
+        busy >>= 1;
+        len  >>= 1;
+    }
+    if (len == 0L) {
+        return (0);
+    }
+    return ((INT16U)(busy * 10000uL / len));
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                         TAKE A UTILIZATION SAMPLE
+*
+* Description: This function is called by OS_TaskStat() every 1/10 second.  It closes the window that
+*              started with the previous call and updates the averages, the peaks and OSCPUUsage.  The
+*              first call only starts the first window.
+*
+* Arguments  : none
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-II and your application should not call it.
+*              2) The idle task is switched out while the statistics task runs, so its OSTCBCyclesTot
+*                 holds all its cycles up to now.
+*              3) The 1 s and 10 s peaks are only taken once the windows hold 10 and 100 samples.
+*              4) A window of 0 cycles, when the timestamp counter does not run, is not a sample.
+*********************************************************************************************************
+*/
+
+void  OS_CPUUtilSample (void)
+{
+    INT32U     now;
+    INT32U     idle;
+    INT32U     busy;
+    INT32U     len;
+    INT8U      ix;
+    INT8U      ix1s;
+    INT16U     util100ms;
+    INT16U     util1s;
+    INT16U     util10s;
+#if OS_CRITICAL_METHOD == 3                      /* Allocate storage for CPU status register           */
+    OS_CPU_SR  cpu_sr = 0;
+#endif
+
+
+
+    OS_ENTER_CRITICAL();
+    now  = OS_TS_GET();
+    idle = OSTCBPrioTbl[OS_TASK_IDLE_PRIO]->OSTCBCyclesTot;
+    OS_EXIT_CRITICAL();
+    len         = now  - OSUtilStamp;
+    busy        = len  - (idle - OSUtilIdle);
+    if (len == 0L) {                             /* No timestamp, keep the last values                  */
+        return;
+    }
+    OSUtilStamp = now;
+    OSUtilIdle  = idle;
+    if (OSUtilStarted == OS_FALSE) {
+        OSUtilStarted = OS_TRUE;
+        return;
+    }
+
+    ix   = OSUtilIx;                             /* Slide the windows: the sample 10 back leaves the    */
+    if (ix >= OS_UTIL_SAMPLES_1S) {              /* ... 1 s window, the one in slot 'ix' the 10 s one   */
+        ix1s = ix - OS_UTIL_SAMPLES_1S;
+    } else {
+        ix1s = ix + OS_UTIL_SAMPLES - OS_UTIL_SAMPLES_1S;
+    }
+    OSUtilBusy1s   += busy - OSUtilBusy[ix1s];
+    OSUtilLen1s    += len  - OSUtilLen[ix1s];
+    OSUtilBusy10s  += busy - OSUtilBusy[ix];
+    OSUtilLen10s   += len  - OSUtilLen[ix];
+    OSUtilBusy[ix]  = busy;
+    OSUtilLen[ix]   = len;
+    OSUtilIx        = (ix + 1 < OS_UTIL_SAMPLES) ? (ix + 1) : 0;
+
+    util100ms = OS_CPUUtilRatio(busy, len);
+    util1s    = OS_CPUUtilRatio(OSUtilBusy1s, OSUtilLen1s);
+    util10s   = OS_CPUUtilRatio(OSUtilBusy10s, OSUtilLen10s);
+
+    OS_ENTER_CRITICAL();
+    OSUtilData.OSUtil100ms = util100ms;
+    OSUtilData.OSUtil1s    = util1s;
+    OSUtilData.OSUtil10s   = util10s;
+    OSUtilData.OSUtilSamples++;
+    if (util100ms > OSUtilData.OSUtilPeak100ms) {
+        OSUtilData.OSUtilPeak100ms = util100ms;
+    }
+    if (OSUtilData.OSUtilSamples >= OS_UTIL_SAMPLES_1S && util1s > OSUtilData.OSUtilPeak1s) {
+        OSUtilData.OSUtilPeak1s = util1s;
+    }
+    if (OSUtilData.OSUtilSamples >= OS_UTIL_SAMPLES && util10s > OSUtilData.OSUtilPeak10s) {
+        OSUtilData.OSUtilPeak10s = util10s;
+    }
+    OS_EXIT_CRITICAL();
+    OSCPUUsage = (INT8U)((util1s + 50) / 100);   /* Rounded percentage of the last second              */
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                       QUERY THE CPU UTILIZATION
+*
+* Description: This function returns the CPU utilization over the last 100 ms, 1 s and 10 s and the
+*              highest values seen.
+*
+* Arguments  : p_util_data   is a pointer to where the utilization is deposited, in 0.01%
+*
+* Returns    : OS_ERR_NONE         the utilization was returned
+*              OS_ERR_PDATA_NULL   'p_util_data' is a NULL pointer
+*********************************************************************************************************
+*/
+
+INT8U  OSCPUUtilQuery (OS_CPU_UTIL_DATA *p_util_data)
+{
+#if OS_CRITICAL_METHOD == 3                      /* Allocate storage for CPU status register           */
+    OS_CPU_SR  cpu_sr = 0;
+#endif
+
+
+
+#if OS_ARG_CHK_EN > 0
+    if (p_util_data == (OS_CPU_UTIL_DATA *)0) {  /* Validate 'p_util_data'                             */
+        return (OS_ERR_PDATA_NULL);
+    }
+#endif
+    OS_ENTER_CRITICAL();
+    *p_util_data = OSUtilData;
+    OS_EXIT_CRITICAL();
+    return (OS_ERR_NONE);
+}
+/*$PAGE*/
+/*
+*********************************************************************************************************
+*                                         RESET THE UTILIZATION PEAKS
+*
+* Description: This function restarts the peaks from the current values, e.g. after the start-up.
+*
+* Arguments  : none
+*
+* Returns    : none
+*********************************************************************************************************
+*/
+
+void  OSCPUUtilPeakReset (void)
+{
+#if OS_CRITICAL_METHOD == 3                      /* Allocate storage for CPU status register           */
+    OS_CPU_SR  cpu_sr = 0;
+#endif
+
+
+
+    OS_ENTER_CRITICAL();
+    OSUtilData.OSUtilPeak100ms = OSUtilData.OSUtil100ms;
+    OSUtilData.OSUtilPeak1s    = (OSUtilData.OSUtilSamples >= OS_UTIL_SAMPLES_1S) ? OSUtilData.OSUtil1s  : 0;
+    OSUtilData.OSUtilPeak10s   = (OSUtilData.OSUtilSamples >= OS_UTIL_SAMPLES)    ? OSUtilData.OSUtil10s : 0;
+    OS_EXIT_CRITICAL();
+}
+#endif                                           /* OS_CPU_UTIL_EN                                      */
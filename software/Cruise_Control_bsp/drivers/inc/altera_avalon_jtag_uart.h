@@ -70,6 +70,20 @@ extern "C"
 #define ALTERA_AVALON_JTAG_UART_BUF_LEN 2048
 #endif
 
+/*
+ * With the deferred work of uC/OS-II (OS_DEFER_EN in os_cfg.h) the
+ * interrupt handler masks the interrupt and leaves the copy between the
+ * FIFOs and the buffers to the deferred work task, see
+ * altera_avalon_jtag_uart_irq(). The TIOCSDEFER ioctl switches it off and
+ * on at run time.
+ */
+#if !defined ALTERA_AVALON_JTAG_UART_SMALL && defined __ucosii__ && OS_DEFER_EN > 0
+#define ALTERA_AVALON_JTAG_UART_DEFER
+#ifndef ALTERA_AVALON_JTAG_UART_DEFER_PRIO
+#define ALTERA_AVALON_JTAG_UART_DEFER_PRIO (OS_DEFER_PRIOS - 1)
+#endif
+#endif
+
 /*
  * ALT_JTAG_UART_READ_RDY and ALT_JTAG_UART_WRITE_RDY are the bitmasks 
  * that define uC/OS-II event flags that are releated to this device.
@@ -113,6 +127,13 @@ typedef struct altera_avalon_jtag_uart_state_s
   char          rx_buf[ALTERA_AVALON_JTAG_UART_BUF_LEN];
   char          tx_buf[ALTERA_AVALON_JTAG_UART_BUF_LEN];
 
+#ifdef ALTERA_AVALON_JTAG_UART_DEFER
+  OS_DEFER      defer;     /* Copy of the buffers by the deferred work task */
+  int           defer_en;  /* Non-zero to defer it, TIOCSDEFER */
+  int           irq_controller_id;
+  int           irq;
+#endif
+
 #endif /* !ALTERA_AVALON_JTAG_UART_SMALL */
 
 } altera_avalon_jtag_uart_state;
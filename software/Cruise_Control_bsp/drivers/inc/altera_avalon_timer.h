@@ -72,6 +72,23 @@ extern "C"
 extern void alt_avalon_timer_sc_init (void* base, alt_u32 irq_controller_id, 
                                       alt_u32 irq, alt_u32 freq);
 
+/*
+ * Tickless operation of the system clock, see altera_avalon_timer_sc.c.
+ * The OS stops the tick with alt_avalon_timer_sc_sleep() when it is idle
+ * and accounts for the slept ticks with alt_avalon_timer_sc_wake().
+ */
+
+extern int     alt_avalon_timer_sc_sleep (alt_u32 ticks);
+extern int     alt_avalon_timer_sc_sleeping (void);
+extern alt_u32 alt_avalon_timer_sc_wake (void);
+extern alt_u32 alt_avalon_timer_sc_irqs (void);
+
+/*
+ * Longest latency of the system clock interrupt in timer cycles.
+ */
+
+extern alt_u32 alt_avalon_timer_sc_latency (int reset);
+
 /*
  * Variables used to store the timestamp parameters, when the device is to be
  * accessed using the high resolution timestamp driver.
@@ -56,6 +56,10 @@ static void altera_avalon_jtag_uart_irq(void* context);
 static void altera_avalon_jtag_uart_irq(void* context, alt_u32 id);
 #endif 
 static alt_u32 altera_avalon_jtag_uart_timeout(void* context);
+static void altera_avalon_jtag_uart_service(altera_avalon_jtag_uart_state* sp);
+#ifdef ALTERA_AVALON_JTAG_UART_DEFER
+static void altera_avalon_jtag_uart_work(void* context, INT16U cnt);
+#endif
 
 /* 
  * Driver initialization code.  Register interrupts and start a timer
@@ -66,6 +70,10 @@ static alt_u32 altera_avalon_jtag_uart_timeout(void* context);
 void altera_avalon_jtag_uart_init(altera_avalon_jtag_uart_state* sp, 
                                   int irq_controller_id, int irq)
 {
+#ifdef ALTERA_AVALON_JTAG_UART_DEFER
+  INT8U err;
+#endif
+
   ALT_FLAG_CREATE(&sp->events, 0);
   ALT_SEM_CREATE(&sp->read_lock, 1);
   ALT_SEM_CREATE(&sp->write_lock, 1);
@@ -74,6 +82,15 @@ void altera_avalon_jtag_uart_init(altera_avalon_jtag_uart_state* sp,
   sp->irq_enable = ALTERA_AVALON_JTAG_UART_CONTROL_RE_MSK;
 
   IOWR_ALTERA_AVALON_JTAG_UART_CONTROL(sp->base, sp->irq_enable); 
+
+#ifdef ALTERA_AVALON_JTAG_UART_DEFER
+  /* the copy runs in the deferred work task unless it cannot be queued */
+  sp->irq_controller_id = irq_controller_id;
+  sp->irq = irq;
+  OSDeferInit(&sp->defer, altera_avalon_jtag_uart_work, sp,
+              ALTERA_AVALON_JTAG_UART_DEFER_PRIO, &err);
+  sp->defer_en = (err == OS_ERR_NONE);
+#endif
   
   /* register the interrupt handler */
 #ifdef ALT_ENHANCED_INTERRUPT_API_PRESENT
@@ -100,7 +117,10 @@ void altera_avalon_jtag_uart_init(altera_avalon_jtag_uart_state* sp,
 }
 
 /*
- * Interrupt routine
+ * Interrupt routine. With ALTERA_AVALON_JTAG_UART_DEFER it only masks the
+ * interrupt and queues the copy, which runs with interrupts enabled: the
+ * copy of a full FIFO with an event flag post per character would otherwise
+ * hold off every other interrupt for its whole length.
  */ 
 #ifdef ALT_ENHANCED_INTERRUPT_API_PRESENT
 static void altera_avalon_jtag_uart_irq(void* context)
@@ -109,10 +129,58 @@ static void altera_avalon_jtag_uart_irq(void* context, alt_u32 id)
 #endif
 {
   altera_avalon_jtag_uart_state* sp = (altera_avalon_jtag_uart_state*) context;
-  unsigned int base = sp->base;
 
   /* ALT_LOG - see altera_hal/HAL/inc/sys/alt_log_printf.h */ 
-  ALT_LOG_JTAG_UART_ISR_FUNCTION(base, sp);
+  ALT_LOG_JTAG_UART_ISR_FUNCTION(sp->base, sp);
+
+#ifdef ALTERA_AVALON_JTAG_UART_DEFER
+  if (sp->defer_en)
+  {
+    /* The device keeps the interrupt asserted until the copy has run */
+#ifdef ALT_ENHANCED_INTERRUPT_API_PRESENT
+    alt_ic_irq_disable(sp->irq_controller_id, sp->irq);
+#else
+    alt_irq_disable(sp->irq);
+#endif
+    OSDeferPost(&sp->defer);
+    return;
+  }
+#endif
+
+  altera_avalon_jtag_uart_service(sp);
+}
+
+#ifdef ALTERA_AVALON_JTAG_UART_DEFER
+/*
+ * Deferred part of the interrupt routine, called by the deferred work task.
+ * An interrupt raised since the copy is taken as soon as it is unmasked.
+ */
+
+static void altera_avalon_jtag_uart_work(void* context, INT16U cnt)
+{
+  altera_avalon_jtag_uart_state* sp = (altera_avalon_jtag_uart_state*) context;
+
+  altera_avalon_jtag_uart_service(sp);
+
+#ifdef ALT_ENHANCED_INTERRUPT_API_PRESENT
+  alt_ic_irq_enable(sp->irq_controller_id, sp->irq);
+#else
+  alt_irq_enable(sp->irq);
+#endif
+}
+#endif
+
+/*
+ * Copy between the FIFOs and the buffers until the device has no more
+ * interrupt conditions. It runs in the interrupt routine or in the deferred
+ * work task. In the task, read() and write() may run between the tests and
+ * the updates of irq_enable, so these are repeated with interrupts disabled.
+ */
+
+static void altera_avalon_jtag_uart_service(altera_avalon_jtag_uart_state* sp)
+{
+  unsigned int base = sp->base;
+  alt_irq_context context;
 
   for ( ; ; )
   {
@@ -158,11 +226,16 @@ static void altera_avalon_jtag_uart_irq(void* context, alt_u32 id)
         /* If there is still data available here then the buffer is full 
          * so turn off receive interrupts until some space becomes available.
          */
-        sp->irq_enable &= ~ALTERA_AVALON_JTAG_UART_CONTROL_RE_MSK;
-        IOWR_ALTERA_AVALON_JTAG_UART_CONTROL(base, sp->irq_enable);
+        context = alt_irq_disable_all();
+        if ((sp->rx_in + 1) % ALTERA_AVALON_JTAG_UART_BUF_LEN == sp->rx_out)
+        {
+          sp->irq_enable &= ~ALTERA_AVALON_JTAG_UART_CONTROL_RE_MSK;
+          IOWR_ALTERA_AVALON_JTAG_UART_CONTROL(base, sp->irq_enable);
         
-        /* Dummy read to ensure IRQ is cleared prior to ISR completion */
-        IORD_ALTERA_AVALON_JTAG_UART_CONTROL(base);
+          /* Dummy read to ensure IRQ is cleared prior to ISR completion */
+          IORD_ALTERA_AVALON_JTAG_UART_CONTROL(base);
+        }
+        alt_irq_enable_all(context);
       }
     }
 
@@ -186,11 +259,16 @@ static void altera_avalon_jtag_uart_irq(void* context, alt_u32 id)
       if (space > 0)
       {
         /* If we don't have any more data available then turn off the TX interrupt */
-        sp->irq_enable &= ~ALTERA_AVALON_JTAG_UART_CONTROL_WE_MSK;
-        IOWR_ALTERA_AVALON_JTAG_UART_CONTROL(sp->base, sp->irq_enable);
+        context = alt_irq_disable_all();
+        if (sp->tx_out == sp->tx_in)
+        {
+          sp->irq_enable &= ~ALTERA_AVALON_JTAG_UART_CONTROL_WE_MSK;
+          IOWR_ALTERA_AVALON_JTAG_UART_CONTROL(sp->base, sp->irq_enable);
         
-        /* Dummy read to ensure IRQ is cleared prior to ISR completion */
-        IORD_ALTERA_AVALON_JTAG_UART_CONTROL(base);
+          /* Dummy read to ensure IRQ is cleared prior to ISR completion */
+          IORD_ALTERA_AVALON_JTAG_UART_CONTROL(base);
+        }
+        alt_irq_enable_all(context);
       }
     }
   }
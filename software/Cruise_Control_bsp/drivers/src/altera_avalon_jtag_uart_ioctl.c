@@ -76,6 +76,14 @@ altera_avalon_jtag_uart_ioctl(altera_avalon_jtag_uart_state* sp, int req,
     }
     break;
 
+#ifdef ALTERA_AVALON_JTAG_UART_DEFER
+  case TIOCSDEFER:
+    /* Copy the buffers in the deferred work task (non-zero) or in the ISR */
+    sp->defer_en = *((int *)arg);
+    rc = 0;
+    break;
+#endif
+
   default:
     break;
   }
@@ -41,6 +41,54 @@
 #include "alt_types.h"
 #include "sys/alt_log_printf.h"
 
+/*
+ * State of the system clock for the tickless idle mode, see
+ * alt_avalon_timer_sc_sleep(). In SC_TICK the timer runs continuously with
+ * the period of one tick.
+ */
+
+#define SC_TICK     0   /* Periodic, one interrupt per tick                 */
+#define SC_SLEEP    1   /* One-shot over several ticks                      */
+#define SC_EXPIRED  2   /* The one-shot timed out, the ticks are not counted */
+#define SC_ALIGN    3   /* One-shot to the next tick after an early wake-up */
+
+static void*            sc_base;
+static alt_u32          sc_period;    /* Timer cycles per tick             */
+static alt_u32          sc_max;       /* Longest sleep in ticks            */
+static alt_u32          sc_ticks;     /* Ticks of the current sleep        */
+static volatile alt_u8  sc_state = SC_TICK;
+static volatile alt_u32 sc_irqs;      /* Interrupts taken since reset      */
+static volatile alt_u32 sc_latency;   /* Longest interrupt latency, cycles */
+
+/*
+ * sc_program() restarts the timer with a period of 'cycles'. The counter
+ * stops while the period registers are written, the cycles of the write
+ * and the interrupt latency before it are lost to the system clock.
+ */
+
+static void sc_program (alt_u32 cycles, alt_u32 control)
+{
+  IOWR_ALTERA_AVALON_TIMER_CONTROL (sc_base, ALTERA_AVALON_TIMER_CONTROL_STOP_MSK);
+  IOWR_ALTERA_AVALON_TIMER_PERIODL (sc_base, (cycles - 1) & 0xFFFF);
+  IOWR_ALTERA_AVALON_TIMER_PERIODH (sc_base, (cycles - 1) >> 16);
+  IOWR_ALTERA_AVALON_TIMER_CONTROL (sc_base, 
+            ALTERA_AVALON_TIMER_CONTROL_ITO_MSK   |
+            ALTERA_AVALON_TIMER_CONTROL_START_MSK |
+            control);
+}
+
+/*
+ * sc_remaining() returns the cycles until the counter of a stopped timer
+ * reaches zero.
+ */
+
+static alt_u32 sc_remaining (void)
+{
+  IOWR_ALTERA_AVALON_TIMER_SNAPL (sc_base, 0);
+  return ((IORD_ALTERA_AVALON_TIMER_SNAPH (sc_base) & ALTERA_AVALON_TIMER_SNAPH_MSK) << 16 |
+          (IORD_ALTERA_AVALON_TIMER_SNAPL (sc_base) & ALTERA_AVALON_TIMER_SNAPL_MSK)) + 1;
+}
+
 /* 
  * alt_avalon_timer_sc_irq() is the interrupt handler used for the system 
  * clock. This is called periodically when a timer interrupt occurs. The 
@@ -57,6 +105,21 @@ static void alt_avalon_timer_sc_irq (void* base, alt_u32 id)
 #endif
 {
   alt_irq_context cpu_sr;
+  alt_u32         latency;
+
+  /*
+   * In the periodic mode the counter has reloaded at the timeout, what it
+   * has counted since is the latency of this interrupt: the longest time
+   * interrupts were disabled or another handler ran when the tick fell due.
+   */
+  if (sc_state == SC_TICK)
+  {
+    latency = sc_period - sc_remaining ();
+    if (latency > sc_latency)
+    {
+      sc_latency = latency;
+    }
+  }
   
   /* clear the interrupt */
   IOWR_ALTERA_AVALON_TIMER_STATUS (base, 0);
@@ -68,9 +131,27 @@ static void alt_avalon_timer_sc_irq (void* base, alt_u32 id)
    */
   IORD_ALTERA_AVALON_TIMER_CONTROL (base);
 
+  sc_irqs++;
+
   /* ALT_LOG - see altera_hal/HAL/inc/sys/alt_log_printf.h */
   ALT_LOG_SYS_CLK_HEARTBEAT();
 
+  /*
+   * The end of a sleep only returns to the periodic mode. The OS counts
+   * the slept ticks in alt_avalon_timer_sc_wake().
+   */
+  if (sc_state == SC_SLEEP)
+  {
+    sc_program (sc_period, ALTERA_AVALON_TIMER_CONTROL_CONT_MSK);
+    sc_state = SC_EXPIRED;
+    return;
+  }
+  if (sc_state == SC_ALIGN)
+  {
+    sc_program (sc_period, ALTERA_AVALON_TIMER_CONTROL_CONT_MSK);
+    sc_state = SC_TICK;
+  }
+
   /* 
    * Notify the system of a clock tick. disable interrupts 
    * during this time to safely support ISR preemption
@@ -92,6 +173,13 @@ void alt_avalon_timer_sc_init (void* base, alt_u32 irq_controller_id,
   /* set the system clock frequency */
   
   alt_sysclk_init (freq);
+
+  /* the period register holds the tick length for the tickless mode */
+
+  sc_base   = base;
+  sc_period = ((IORD_ALTERA_AVALON_TIMER_PERIODH (base) & ALTERA_AVALON_TIMER_PERIODH_MSK) << 16 |
+               (IORD_ALTERA_AVALON_TIMER_PERIODL (base) & ALTERA_AVALON_TIMER_PERIODL_MSK)) + 1;
+  sc_max    = 0xFFFFFFFF / sc_period - 1;
   
   /* set to free running mode */
   
@@ -108,3 +196,123 @@ void alt_avalon_timer_sc_init (void* base, alt_u32 irq_controller_id,
   alt_irq_register (irq, base, alt_avalon_timer_sc_irq);
 #endif  
 }
+
+/*
+ * alt_avalon_timer_sc_sleep() replaces the next 'ticks' tick interrupts by
+ * a single one at the end of the last tick, for the tickless idle mode of
+ * the OS. The current tick keeps its phase. It must be called with
+ * interrupts disabled and returns -1 if the timer cannot sleep, because it
+ * is not in its periodic mode or a tick is pending.
+ */
+
+int alt_avalon_timer_sc_sleep (alt_u32 ticks)
+{
+  alt_u32 first;
+
+  if (sc_state != SC_TICK || ticks < 2)
+  {
+    return -1;
+  }
+  if (ticks > sc_max)
+  {
+    ticks = sc_max;
+  }
+
+  IOWR_ALTERA_AVALON_TIMER_CONTROL (sc_base, ALTERA_AVALON_TIMER_CONTROL_STOP_MSK);
+  if (IORD_ALTERA_AVALON_TIMER_STATUS (sc_base) & ALTERA_AVALON_TIMER_STATUS_TO_MSK)
+  {
+    /* resume, the pending interrupt handles the tick */
+    IOWR_ALTERA_AVALON_TIMER_CONTROL (sc_base, 
+              ALTERA_AVALON_TIMER_CONTROL_ITO_MSK  |
+              ALTERA_AVALON_TIMER_CONTROL_CONT_MSK |
+              ALTERA_AVALON_TIMER_CONTROL_START_MSK);
+    return -1;
+  }
+
+  first = sc_remaining ();
+  sc_program (first + (ticks - 1) * sc_period, 0);
+  sc_ticks = ticks;
+  sc_state = SC_SLEEP;
+  return 0;
+}
+
+/*
+ * alt_avalon_timer_sc_sleeping() tells whether a sleep is still running.
+ */
+
+int alt_avalon_timer_sc_sleeping (void)
+{
+  return sc_state == SC_SLEEP;
+}
+
+/*
+ * alt_avalon_timer_sc_wake() ends a sleep and returns the number of ticks
+ * that have passed since alt_avalon_timer_sc_sleep(). After an early
+ * wake-up the timer runs a one-shot to the next tick boundary before it
+ * returns to the periodic mode. It must be called with interrupts disabled.
+ */
+
+alt_u32 alt_avalon_timer_sc_wake (void)
+{
+  alt_u32 remaining;
+  alt_u32 ahead;
+
+  if (sc_state == SC_EXPIRED)
+  {
+    sc_state = SC_TICK;
+    return sc_ticks;
+  }
+  if (sc_state != SC_SLEEP)
+  {
+    return 0;
+  }
+
+  IOWR_ALTERA_AVALON_TIMER_CONTROL (sc_base, ALTERA_AVALON_TIMER_CONTROL_STOP_MSK);
+  if (IORD_ALTERA_AVALON_TIMER_STATUS (sc_base) & ALTERA_AVALON_TIMER_STATUS_TO_MSK)
+  {
+    /* the sleep has just timed out */
+    IOWR_ALTERA_AVALON_TIMER_STATUS (sc_base, 0);
+    sc_program (sc_period, ALTERA_AVALON_TIMER_CONTROL_CONT_MSK);
+    sc_state = SC_TICK;
+    return sc_ticks;
+  }
+
+  /* 
+   * The tick boundaries lie at whole periods before the end of the
+   * one-shot. 'ahead' ticks are still to come after the next boundary.
+   */
+  remaining = sc_remaining ();
+  ahead     = (remaining - 1) / sc_period;
+  sc_program (remaining - ahead * sc_period, 0);
+  sc_state  = SC_ALIGN;
+  return sc_ticks - 1 - ahead;
+}
+
+/*
+ * alt_avalon_timer_sc_irqs() returns the number of system clock interrupts
+ * taken since reset.
+ */
+
+alt_u32 alt_avalon_timer_sc_irqs (void)
+{
+  return sc_irqs;
+}
+
+/*
+ * alt_avalon_timer_sc_latency() returns the longest latency of the tick
+ * interrupt in timer cycles, from the timeout to the start of the handler,
+ * and restarts the measurement if 'reset' is non-zero. The ticks sample
+ * the system at random points, over a long run the result approaches the
+ * longest time the interrupts are disabled plus the entry of the handler.
+ */
+
+alt_u32 alt_avalon_timer_sc_latency (int reset)
+{
+  alt_u32 latency = sc_latency;
+
+  if (reset)
+  {
+    sc_latency = 0;
+  }
+  return latency;
+}
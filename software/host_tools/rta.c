@@ -0,0 +1,541 @@
+/*
+ * Host-side response-time analysis of the Cruise Control task set.
+ *
+ * Reads a task set with one entry per line:
+ *
+ *   define NAME value                   # constant for the expressions below
+ *   switch wcet                         # context switch, twice per job
+ *   isr    name wcet period [jitter]    # interrupt, interferes with all tasks
+ *   task   name prio period deadline wcet [jitter [blocking]]
+ *   kernel ...                          # as task, the priority is fixed
+ *   background ...                      # as task, the priority is fixed
+ *
+ * Times are in microseconds, the period of a sporadic task or interrupt is
+ * its minimum inter-arrival time. A value is an expression of integers and
+ * names with + - * / and no spaces, e.g. CONTROL_PERIOD*1000. Names come
+ * from 'define' lines, from -D and from the '#define NAME value' lines of
+ * the C files given with -s (main.c, system.h), so the priorities and
+ * periods can be taken from the sources. -D overrides the other two.
+ *
+ * For each task the worst-case response time is computed with the
+ * fixed-priority recurrence including release jitter, blocking, the
+ * interrupts and the context switches:
+ *
+ *   w = C + 2S + B + sum over hp(i) of ceil((w + J) / T) * (C + 2S)
+ *                  + sum over the interrupts of ceil((w + J) / T) * C
+ *   R = w + J
+ *
+ * and the utilization is compared with the Liu & Layland and hyperbolic
+ * bounds. Application tasks whose priority order contradicts their
+ * deadlines (deadline-monotonic, rate-monotonic for D = T) are flagged and
+ * the analysis is repeated with the deadline-monotonic order. 'kernel'
+ * entries (the timer task) and 'background' entries (tasks meant to use
+ * idle time only) keep their priority. A background task is analysed and
+ * shown as LATE if it can miss its deadline, but it does not count in the
+ * verdict. uC/OS-II priorities are unique and 0 is the highest.
+ *
+ * Build: gcc -O2 -o rta rta.c -lm
+ * Usage: rta [-s source.c]... [-D NAME=value]... [taskset]
+ *        rta -s ../Cruise_Control/main.c tasksets/cruise.ts
+ *        Exits with 1 if a deadline of a task or kernel entry can be
+ *        missed, 2 on input errors.
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_TASKS     64
+#define MAX_ISRS      16
+#define MAX_NAMES   1024
+#define NAME_SIZE     48
+
+typedef struct {
+  char name[NAME_SIZE];
+  double value;
+  int prec;           /* 0 source file, 1 task set, 2 command line */
+} symbol_t;
+
+typedef struct {
+  char name[NAME_SIZE];
+  int prio;
+  int fixed;          /* Kernel or background task, the priority is not checked */
+  int background;     /* Idle time only, a miss does not make the set unschedulable */
+  double period, deadline, wcet, jitter, blocking;
+  double response;    /* -1 if the deadline can be missed */
+} task_t;
+
+typedef struct {
+  char name[NAME_SIZE];
+  double wcet, period, jitter;
+} isr_t;
+
+static symbol_t symbols[MAX_NAMES];
+static int symbol_count;
+static int quiet;     /* Unknown names are not reported, see read_source() */
+
+static task_t tasks[MAX_TASKS];
+static int task_count;
+
+static isr_t isrs[MAX_ISRS];
+static int isr_count;
+
+static double switch_wcet;
+
+static void define(const char* name, double value, int prec)
+{
+  int i;
+
+  for (i = 0; i < symbol_count; i++)
+    if (strcmp(symbols[i].name, name) == 0)
+      break;
+  if (i == symbol_count) {
+    if (symbol_count == MAX_NAMES)
+      return;
+    symbol_count++;
+  } else if (symbols[i].prec > prec)
+    return;
+  snprintf(symbols[i].name, NAME_SIZE, "%s", name);
+  symbols[i].value = value;
+  symbols[i].prec = prec;
+}
+
+static int lookup(const char* name, double* value)
+{
+  int i;
+
+  for (i = 0; i < symbol_count; i++)
+    if (strcmp(symbols[i].name, name) == 0) {
+      *value = symbols[i].value;
+      return 0;
+    }
+  return -1;
+}
+
+/*
+ * Evaluates one operand: a number or a name
+ */
+static int operand(const char** s, double* value)
+{
+  char name[NAME_SIZE];
+  char* end;
+  int n = 0;
+
+  if (isalpha((unsigned char) **s) || **s == '_') {
+    while ((isalnum((unsigned char) **s) || **s == '_') && n < NAME_SIZE - 1)
+      name[n++] = *(*s)++;
+    name[n] = '\0';
+    if (lookup(name, value) != 0) {
+      if (!quiet)
+        fprintf(stderr, "unknown name '%s'\n", name);
+      return -1;
+    }
+    return 0;
+  }
+  *value = strtod(*s, &end);
+  if (end == *s)
+    return -1;
+  while (*end == 'u' || *end == 'U' || *end == 'l' || *end == 'L')
+    end++;
+  *s = end;
+  return 0;
+}
+
+/*
+ * Evaluates a sum of products from left to right
+ */
+static int eval(const char* s, double* value)
+{
+  double sum = 0, product, v;
+  int sign = 1;
+  char op;
+
+  for (;;) {
+    if (operand(&s, &product) != 0)
+      return -1;
+    while (*s == '*' || *s == '/') {
+      op = *s++;
+      if (operand(&s, &v) != 0)
+        return -1;
+      if (op == '*')
+        product *= v;
+      else if (v != 0)
+        product /= v;
+      else
+        return -1;
+    }
+    sum += sign * product;
+    if (*s == '\0')
+      break;
+    if (*s != '+' && *s != '-')
+      return -1;
+    sign = (*s++ == '+') ? 1 : -1;
+  }
+  *value = sum;
+  return 0;
+}
+
+/*
+ * Collects the '#define NAME value' lines of a C source, where the value
+ * is a number or a name defined before it. Other defines are ignored.
+ */
+static int read_source(const char* path)
+{
+  FILE* in = fopen(path, "r");
+  char line[512], name[NAME_SIZE], value[128];
+  double v;
+
+  if (in == NULL) {
+    perror(path);
+    return -1;
+  }
+  quiet = 1;
+  while (fgets(line, sizeof(line), in) != NULL) {
+    if (sscanf(line, " #define %47s %127s", name, value) != 2 || strchr(name, '(') != NULL)
+      continue;
+    /* Casts and parentheses of the generated headers */
+    while (value[0] == '(' || value[strlen(value) - 1] == ')') {
+      if (value[0] == '(')
+        memmove(value, value + 1, strlen(value));
+      else
+        value[strlen(value) - 1] = '\0';
+      if (value[0] == '\0')
+        break;
+    }
+    if (value[0] != '\0' && eval(value, &v) == 0)
+      define(name, v, 0);
+  }
+  quiet = 0;
+  fclose(in);
+  return 0;
+}
+
+static int fields(char* line, char** field, int max)
+{
+  int n = 0;
+  char* tok;
+
+  for (tok = strtok(line, " \t\r\n"); tok != NULL && n < max; tok = strtok(NULL, " \t\r\n"))
+    field[n++] = tok;
+  return n;
+}
+
+static int values(char** field, int n, double* out, int lineno)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    if (eval(field[i], &out[i]) != 0 || out[i] < 0) {
+      fprintf(stderr, "line %d: bad value '%s'\n", lineno, field[i]);
+      return -1;
+    }
+  return 0;
+}
+
+static int read_taskset(FILE* in)
+{
+  char line[512];
+  char* field[10];
+  char* hash;
+  double v[7];
+  task_t* t;
+  isr_t* isr;
+  int n, lineno = 0;
+
+  while (fgets(line, sizeof(line), in) != NULL) {
+    lineno++;
+    if ((hash = strchr(line, '#')) != NULL)
+      *hash = '\0';
+    if ((n = fields(line, field, 10)) == 0)
+      continue;
+
+    if (strcmp(field[0], "define") == 0 && n == 3) {
+      if (eval(field[2], &v[0]) != 0) {
+        fprintf(stderr, "line %d: bad value '%s'\n", lineno, field[2]);
+        return -1;
+      }
+      define(field[1], v[0], 1);
+    } else if (strcmp(field[0], "switch") == 0 && n == 2) {
+      if (values(field + 1, 1, &switch_wcet, lineno) != 0)
+        return -1;
+    } else if (strcmp(field[0], "isr") == 0 && (n == 4 || n == 5)) {
+      if (isr_count == MAX_ISRS) {
+        fprintf(stderr, "line %d: more than %d interrupts\n", lineno, MAX_ISRS);
+        return -1;
+      }
+      v[2] = 0;
+      if (values(field + 2, n - 2, v, lineno) != 0)
+        return -1;
+      if (v[1] == 0) {
+        fprintf(stderr, "line %d: period is 0\n", lineno);
+        return -1;
+      }
+      isr = &isrs[isr_count++];
+      snprintf(isr->name, NAME_SIZE, "%s", field[1]);
+      isr->wcet = v[0];
+      isr->period = v[1];
+      isr->jitter = v[2];
+    } else if ((strcmp(field[0], "task") == 0 || strcmp(field[0], "kernel") == 0
+                || strcmp(field[0], "background") == 0) && n >= 6 && n <= 8) {
+      if (task_count == MAX_TASKS) {
+        fprintf(stderr, "line %d: more than %d tasks\n", lineno, MAX_TASKS);
+        return -1;
+      }
+      v[4] = v[5] = 0;
+      if (values(field + 2, n - 2, v, lineno) != 0)
+        return -1;
+      if (v[1] == 0 || v[2] == 0 || v[2] > v[1]) {
+        fprintf(stderr, "line %d: need 0 < deadline <= period\n", lineno);
+        return -1;
+      }
+      t = &tasks[task_count++];
+      snprintf(t->name, NAME_SIZE, "%s", field[1]);
+      t->fixed = (field[0][0] != 't');
+      t->background = (field[0][0] == 'b');
+      t->prio = (int) v[0];
+      t->period = v[1];
+      t->deadline = v[2];
+      t->wcet = v[3];
+      t->jitter = v[4];
+      t->blocking = v[5];
+    } else {
+      fprintf(stderr, "line %d: expected 'define', 'switch', 'isr', 'task', 'kernel' "
+              "or 'background'\n", lineno);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int by_prio(const void* a, const void* b)
+{
+  return ((const task_t*) a)->prio - ((const task_t*) b)->prio;
+}
+
+/*
+ * Computes the response times of 'set', which is sorted by priority.
+ * Returns the number of tasks that can miss their deadline, background
+ * tasks not included.
+ */
+static int analyse(task_t* set, int n)
+{
+  double w, next, c;
+  int i, j, missed = 0;
+
+  for (i = 0; i < n; i++) {
+    c = set[i].wcet + 2 * switch_wcet;
+    w = c + set[i].blocking;
+    for (;;) {
+      next = c + set[i].blocking;
+      for (j = 0; j < i; j++)
+        next += ceil((w + set[j].jitter) / set[j].period) * (set[j].wcet + 2 * switch_wcet);
+      for (j = 0; j < isr_count; j++)
+        next += ceil((w + isrs[j].jitter) / isrs[j].period) * isrs[j].wcet;
+      if (next + set[i].jitter > set[i].deadline) {
+        set[i].response = -1;
+        if (!set[i].background)
+          missed++;
+        break;
+      }
+      if (next == w) {
+        set[i].response = w + set[i].jitter;
+        break;
+      }
+      w = next;
+    }
+  }
+  return missed;
+}
+
+static void print_tasks(const task_t* set, int n)
+{
+  double u;
+  int i;
+
+  printf("%4s %-12s %9s %9s %8s %7s %7s %7s %9s %9s\n", "Prio", "Task", "Period",
+         "Deadline", "WCET", "Jitter", "Block", "Util", "WCRT", "Slack");
+  for (i = 0; i < n; i++) {
+    u = (set[i].wcet + 2 * switch_wcet) / set[i].period * 100;
+    printf("%4d %-12s %9.0f %9.0f %8.1f %7.0f %7.0f %6.2f%%", set[i].prio, set[i].name,
+           set[i].period, set[i].deadline, set[i].wcet, set[i].jitter, set[i].blocking, u);
+    if (set[i].response < 0)
+      printf(" %9s %9s\n", "-", set[i].background ? "LATE" : "MISS");
+    else
+      printf(" %9.1f %9.1f\n", set[i].response, set[i].deadline - set[i].response);
+  }
+}
+
+static void print_utilization(void)
+{
+  double u_tasks = 0, u_isrs = 0, product = 1, u, bound;
+  int i, implicit = 1;
+
+  for (i = 0; i < task_count; i++) {
+    u = (tasks[i].wcet + 2 * switch_wcet) / tasks[i].period;
+    u_tasks += u;
+    product *= 1 + u;
+    if (tasks[i].deadline != tasks[i].period || tasks[i].jitter != 0 || tasks[i].blocking != 0)
+      implicit = 0;
+  }
+  for (i = 0; i < isr_count; i++) {
+    u = isrs[i].wcet / isrs[i].period;
+    u_isrs += u;
+    product *= 1 + u;
+  }
+  bound = (task_count + isr_count) * (pow(2.0, 1.0 / (task_count + isr_count)) - 1);
+
+  printf("\nUtilization: tasks %.2f%% (switches included), interrupts %.2f%%, total %.2f%%\n",
+         u_tasks * 100, u_isrs * 100, (u_tasks + u_isrs) * 100);
+  printf("  Liu & Layland bound for %d: %.2f%%, %s\n", task_count + isr_count, bound * 100,
+         u_tasks + u_isrs <= bound ? "below" : "above, only the response times decide");
+  printf("  Hyperbolic bound: product of (U + 1) = %.3f, %s 2\n", product,
+         product <= 2 ? "at most" : "above");
+  if (!implicit)
+    printf("  The bounds assume rate-monotonic priorities, D = T and no jitter or blocking;\n"
+           "  only the response times above apply to this set\n");
+  if (u_tasks + u_isrs > 1)
+    printf("  Overloaded: the utilization is above 100%%\n");
+}
+
+/*
+ * Flags pairs of application tasks where the higher priority has the
+ * later deadline (the longer period if the deadlines are equal). Returns
+ * the number of pairs.
+ */
+static int check_order(void)
+{
+  const task_t *hi, *lo;
+  int i, j, count = 0;
+
+  for (i = 0; i < task_count; i++)
+    for (j = i + 1; j < task_count; j++) {
+      hi = &tasks[i];
+      lo = &tasks[j];
+      if (hi->fixed || lo->fixed)
+        continue;
+      if (hi->deadline > lo->deadline
+          || (hi->deadline == lo->deadline && hi->period > lo->period)) {
+        if (count++ == 0)
+          printf("\nPriority order:\n");
+        printf("  %s (prio %d, D %.0f us) is above %s (prio %d, D %.0f us): not %s\n",
+               hi->name, hi->prio, hi->deadline, lo->name, lo->prio, lo->deadline,
+               hi->deadline == hi->period && lo->deadline == lo->period ?
+               "rate-monotonic" : "deadline-monotonic");
+      }
+    }
+  return count;
+}
+
+static int by_deadline(const void* a, const void* b)
+{
+  const task_t* x = a;
+  const task_t* y = b;
+
+  if (x->deadline != y->deadline)
+    return x->deadline < y->deadline ? -1 : 1;
+  if (x->period != y->period)
+    return x->period < y->period ? -1 : 1;
+  return x->prio - y->prio;
+}
+
+/*
+ * Redistributes the priorities of the application tasks in
+ * deadline-monotonic order, the fixed tasks keep theirs
+ */
+static void deadline_monotonic(task_t* set)
+{
+  task_t apps[MAX_TASKS];
+  int prios[MAX_TASKS];
+  int i, n = 0;
+
+  for (i = 0; i < task_count; i++)
+    if (!set[i].fixed) {
+      prios[n] = set[i].prio;
+      apps[n++] = set[i];
+    }
+  qsort(apps, n, sizeof(apps[0]), by_deadline);
+  for (i = 0; i < n; i++)
+    apps[i].prio = prios[i];
+  for (i = 0; i < task_count; i++)
+    if (set[i].fixed)
+      apps[n++] = set[i];
+  memcpy(set, apps, task_count * sizeof(set[0]));
+  qsort(set, task_count, sizeof(set[0]), by_prio);
+}
+
+int main(int argc, char** argv)
+{
+  static task_t dm_set[MAX_TASKS];
+  FILE* in = stdin;
+  const char* path = "stdin";
+  char* eq;
+  double v;
+  int i, missed, dm_missed, late = 0;
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      if (read_source(argv[++i]) != 0)
+        return 2;
+    } else if (strcmp(argv[i], "-D") == 0 && i + 1 < argc) {
+      if ((eq = strchr(argv[++i], '=')) == NULL || eval(eq + 1, &v) != 0) {
+        fprintf(stderr, "expected -D NAME=value\n");
+        return 2;
+      }
+      *eq = '\0';
+      define(argv[i], v, 2);
+    } else if (argv[i][0] == '-' || in != stdin) {
+      fprintf(stderr, "usage: %s [-s source.c]... [-D NAME=value]... [taskset]\n", argv[0]);
+      return 2;
+    } else if ((in = fopen(path = argv[i], "r")) == NULL) {
+      perror(argv[i]);
+      return 2;
+    }
+  }
+
+  if (read_taskset(in) != 0)
+    return 2;
+  if (task_count == 0) {
+    fprintf(stderr, "no tasks\n");
+    return 2;
+  }
+  qsort(tasks, task_count, sizeof(tasks[0]), by_prio);
+  for (i = 1; i < task_count; i++)
+    if (tasks[i].prio == tasks[i - 1].prio) {
+      fprintf(stderr, "%s and %s have priority %d\n", tasks[i - 1].name, tasks[i].name,
+              tasks[i].prio);
+      return 2;
+    }
+
+  printf("Task set %s: %d tasks, %d interrupts, context switch %.1f us (times in us)\n",
+         path, task_count, isr_count, switch_wcet);
+  for (i = 0; i < isr_count; i++)
+    printf("  %-12s WCET %.1f every %.0f, jitter %.0f\n", isrs[i].name, isrs[i].wcet,
+           isrs[i].period, isrs[i].jitter);
+  printf("\n");
+  missed = analyse(tasks, task_count);
+  print_tasks(tasks, task_count);
+  print_utilization();
+
+  if (check_order() > 0) {
+    memcpy(dm_set, tasks, sizeof(dm_set));
+    deadline_monotonic(dm_set);
+    dm_missed = analyse(dm_set, task_count);
+    printf("\nWith deadline-monotonic priorities:\n");
+    print_tasks(dm_set, task_count);
+    if (dm_missed < missed)
+      printf("  %d fewer task(s) can miss the deadline\n", missed - dm_missed);
+  }
+
+  for (i = 0; i < task_count; i++)
+    if (tasks[i].background && tasks[i].response < 0)
+      late++;
+  if (late > 0)
+    printf("\n%d background task(s) can miss the deadline, not counted\n", late);
+  if (missed > 0)
+    printf("\nNot schedulable: %d task(s) can miss the deadline\n", missed);
+  else
+    printf("\nSchedulable\n");
+  return missed > 0;
+}
@@ -0,0 +1,33 @@
+# Task set of the Cruise Control with PIPELINE_EN, for rta.c
+#
+#   rta -s ../Cruise_Control/main.c -s ../Cruise_Control_bsp/system.h tasksets/cruise.ts
+#   rta ... -D EXTRALOAD_PCT=40 tasksets/cruise.ts
+#
+# Priorities and periods come from main.c and system.h, times are in us.
+# The WCETs are estimates for the Nios II/e at 50 MHz: replace them with
+# the Worst column of dm_report() at zero extra load, the CPU time report
+# (cycles / count) and the OSTimeTick and OSTmr_Task benchmarks.
+
+define TICK          1000000/OS_TICKS_PER_SEC
+define TMR_PERIOD    1000000/OS_TMR_CFG_TICKS_PER_SEC
+define CRITICAL      20           # longest section with interrupts disabled
+define EXTRALOAD_PCT 0            # SW9-SW4, in % of CONTROL_PERIOD
+
+# Kernel overheads
+switch 15
+isr    Tick          40   TICK                          # OSTimeTick, pipeline alarm, OSTmrSignal
+isr    Keys          10   INPUT_DEBOUNCE_TICKS*TICK     # edge capture, masked while debouncing
+isr    Switches      10   INPUT_DEBOUNCE_TICKS*TICK
+
+#      name       prio                period                 deadline               wcet    jitter  blocking
+kernel OSTmr      OS_TASK_TMR_PRIO    TMR_PERIOD             TMR_PERIOD             60      0       CRITICAL
+task   WatchDog   WATCHDOGTASK_PRIO   CONTROL_PERIOD*1000    CONTROL_PERIOD*1000    30      0       CRITICAL
+task   Input      INPUTTASK_PRIO      INPUT_DEBOUNCE_TICKS*TICK  INPUT_DEBOUNCE_TICKS*TICK  50  0   CRITICAL
+# The pipeline: sample and control must be done at ACTUATE_PHASE. The WCET
+# of Vehicle covers both of its releases, the equal deadline keeps the
+# sample before the control step in the deadline-monotonic order.
+task   Vehicle    VEHICLETASK_PRIO    VEHICLE_PERIOD*1000    ACTUATE_PHASE*1000-SAMPLE_PHASE*1000   150  0  CRITICAL
+task   Control    CONTROLTASK_PRIO    VEHICLE_PERIOD*1000    ACTUATE_PHASE*1000-SAMPLE_PHASE*1000   200  0  CRITICAL
+task   ExtraLoad  EXTRALOADTASK_PRIO  CONTROL_PERIOD*1000    CONTROL_PERIOD*1000    30+CONTROL_PERIOD*10*EXTRALOAD_PCT  100     CRITICAL
+# Blocking JTAG UART output, only idle time: shown LATE, not counted
+background Telemetry TELEMETRYTASK_PRIO  TELEMETRY_PERIOD*1000  TELEMETRY_PERIOD*1000  5000    0       0
@@ -0,0 +1,216 @@
+/*
+ * Host-side decoder for the Cruise Control telemetry stream.
+ *
+ * Reads a capture of the JTAG UART output (e.g. 'nios2-terminal > log.bin')
+ * and prints the telemetry frames as text, or as CSV with -c. Bytes that
+ * are not part of a valid frame are passed through, so the normal printf
+ * output of the target stays readable. The escaping of the Ctrl-D bytes,
+ * which would end the capture, is undone before the frames are searched,
+ * so a frame that contained one decodes like any other. The frame layout
+ * is documented in software/Cruise_Control/telemetry.h.
+ *
+ * Build: gcc -O2 -o tlm_decode tlm_decode.c
+ * Usage: tlm_decode [-c] [capture-file]
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#define TLM_FRAME_SIZE     20
+#define TLM_SYNC0        0xA5
+#define TLM_SYNC1        0x5A
+
+#define TLM_ESC          0x1B   /* Escape of 0x04 (Ctrl-D) and of itself */
+#define TLM_ESC_XOR      0x20
+
+#define TLM_SRC_VEHICLE     1
+#define TLM_SRC_WATCHDOG    2
+#define TLM_SRC_TOPICS      3
+
+#define TLM_FLAG_ENGINE     0x0001
+#define TLM_FLAG_TOP_GEAR   0x0002
+#define TLM_FLAG_GAS        0x0004
+#define TLM_FLAG_BRAKE      0x0008
+#define TLM_FLAG_CRUISE     0x0010
+#define TLM_FLAG_CRUISING   0x0020
+#define TLM_FLAG_OVERLOAD   0x0040
+
+static const struct {
+  unsigned mask;
+  const char* name;
+} flag_names[] = {
+  { TLM_FLAG_ENGINE,   "ENGINE"   },
+  { TLM_FLAG_TOP_GEAR, "TOP_GEAR" },
+  { TLM_FLAG_GAS,      "GAS"      },
+  { TLM_FLAG_BRAKE,    "BRAKE"    },
+  { TLM_FLAG_CRUISE,   "CRUISE"   },
+  { TLM_FLAG_CRUISING, "CRUISING" },
+  { TLM_FLAG_OVERLOAD, "OVERLOAD" },
+};
+
+typedef struct {
+  unsigned seq;
+  unsigned long timestamp;
+  unsigned long position;
+  int velocity;
+  unsigned throttle;
+  unsigned source;
+  unsigned flags;
+  unsigned aux;
+} record_t;
+
+static unsigned get16(const unsigned char* p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+static unsigned long get32(const unsigned char* p)
+{
+  return get16(p) | ((unsigned long) get16(p + 2) << 16);
+}
+
+/*
+ * Next byte of the capture with the escaping removed. The printf output of
+ * the target contains no escape bytes.
+ */
+static int next_byte(FILE* in)
+{
+  int c = fgetc(in);
+
+  if (c == TLM_ESC && (c = fgetc(in)) != EOF)
+    c ^= TLM_ESC_XOR;
+  return c;
+}
+
+/*
+ * Returns 1 and fills 'rec' if 'f' holds a frame with a valid checksum
+ */
+static int decode_frame(const unsigned char* f, record_t* rec)
+{
+  unsigned char sum = 0;
+  int i;
+
+  if (f[0] != TLM_SYNC0 || f[1] != TLM_SYNC1)
+    return 0;
+  for (i = 2; i < TLM_FRAME_SIZE - 1; i++)
+    sum += f[i];
+  if (sum != f[TLM_FRAME_SIZE - 1])
+    return 0;
+
+  rec->seq = f[2];
+  rec->timestamp = get32(f + 3);
+  rec->position = get32(f + 7);
+  rec->velocity = (short) get16(f + 11);
+  rec->throttle = f[13];
+  rec->source = f[14];
+  rec->flags = get16(f + 15);
+  rec->aux = get16(f + 17);
+  return 1;
+}
+
+static void print_flags(unsigned flags, const char* sep)
+{
+  const char* s = "";
+  size_t i;
+
+  for (i = 0; i < sizeof(flag_names) / sizeof(flag_names[0]); i++)
+    if (flags & flag_names[i].mask) {
+      printf("%s%s", s, flag_names[i].name);
+      s = sep;
+    }
+}
+
+static void print_text(const record_t* r)
+{
+  printf("[%8lu ms] ", r->timestamp);
+  switch (r->source) {
+  case TLM_SRC_VEHICLE:
+    printf("vehicle  pos %6.1f m  vel %5.1f m/s  throttle %3.1f V  ",
+           r->position / 10.0, r->velocity / 10.0, r->throttle / 10.0);
+    print_flags(r->flags, "|");
+    break;
+  case TLM_SRC_WATCHDOG:
+    if (r->flags & TLM_FLAG_OVERLOAD)
+      printf("watchdog System is overloaded! Workload of the original system: %u%%",
+             r->aux);
+    else
+      printf("watchdog System is OK!");
+    break;
+  case TLM_SRC_TOPICS:
+    printf("topics   vel %5.1f m/s  throttle %3.1f V  skipped %u",
+           r->velocity / 10.0, r->throttle / 10.0, r->aux);
+    break;
+  default:
+    printf("source %u", r->source);
+    break;
+  }
+  printf("\n");
+}
+
+static void print_csv(const record_t* r)
+{
+  printf("%u,%lu,%u,%.1f,%.1f,%.1f,", r->seq, r->timestamp, r->source,
+         r->position / 10.0, r->velocity / 10.0, r->throttle / 10.0);
+  print_flags(r->flags, "|");
+  printf(",%u\n", r->aux);
+}
+
+int main(int argc, char** argv)
+{
+  unsigned char buf[TLM_FRAME_SIZE];
+  FILE* in = stdin;
+  int csv = 0;
+  int fill = 0;
+  int c, i;
+  int have_seq = 0;
+  unsigned next_seq = 0;
+  unsigned long frames = 0, lost = 0;
+  record_t rec;
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-c") == 0)
+      csv = 1;
+    else if ((in = fopen(argv[i], "rb")) == NULL) {
+      perror(argv[i]);
+      return 1;
+    }
+  }
+
+  if (csv)
+    printf("seq,time_ms,source,position_m,velocity_mps,throttle_v,flags,aux\n");
+
+  /*
+   * Sliding window over the stream: a frame is consumed as a whole, any
+   * other byte is passed through as text (suppressed in CSV mode).
+   */
+  while ((c = next_byte(in)) != EOF) {
+    buf[fill++] = (unsigned char) c;
+    while (fill > 0) {
+      if (buf[0] == TLM_SYNC0 && (fill == 1 || buf[1] == TLM_SYNC1)) {
+        if (fill < TLM_FRAME_SIZE)
+          break;
+        if (decode_frame(buf, &rec)) {
+          if (have_seq && rec.seq != next_seq)
+            lost += (rec.seq - next_seq) & 0xFF;
+          next_seq = (rec.seq + 1) & 0xFF;
+          have_seq = 1;
+          frames++;
+          if (csv)
+            print_csv(&rec);
+          else
+            print_text(&rec);
+          fill = 0;
+          break;
+        }
+      }
+      if (!csv)
+        fputc(buf[0], stdout);
+      memmove(buf, buf + 1, --fill);
+    }
+  }
+  if (!csv)
+    fwrite(buf, 1, fill, stdout);
+
+  fprintf(stderr, "%lu frames, %lu lost\n", frames, lost);
+  return 0;
+}
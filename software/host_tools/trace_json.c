@@ -0,0 +1,333 @@
+/*
+ * Host-side converter for the Cruise Control kernel trace.
+ *
+ * Reads a capture of the JTAG UART output (e.g. 'nios2-terminal > log.bin')
+ * that contains a trace block written by trc_dump(), undoes the escaping
+ * of the Ctrl-D bytes that would end the capture, and prints it as
+ * Chrome trace JSON, which chrome://tracing and ui.perfetto.dev open. Each
+ * task is a thread with its running slices, the interrupts are a thread of
+ * their own, and the semaphore, mailbox and timer events are instant
+ * events on the task that caused them. The block layout is documented in
+ * software/Cruise_Control/trace_dump.h.
+ *
+ * Build: gcc -O2 -o trace_json trace_json.c
+ * Usage: trace_json [-n block] [capture-file] > trace.json
+ *        The last block of the capture is converted unless -n selects one
+ *        (1 is the first).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRC_NAME_SIZE      16
+#define TRC_HEADER_SIZE    17
+#define TRC_RECORD_SIZE     8
+
+#define TRC_ESC          0x1B   /* Escape of 0x04 (Ctrl-D) and of itself */
+#define TRC_ESC_XOR      0x20
+
+/* Event types, OS_TRACE_* in ucos_ii.h */
+#define TRC_TASK_SW         1
+#define TRC_INT_ENTER       2
+#define TRC_INT_EXIT        3
+#define TRC_IRQ_ENTER       4
+#define TRC_IRQ_EXIT        5
+#define TRC_SEM_POST        6
+#define TRC_SEM_PEND        7
+#define TRC_MBOX_POST       8
+#define TRC_MBOX_PEND       9
+#define TRC_TMR_EXPIRE     10
+
+#define TID_INTERRUPTS   1000   /* Thread of the interrupt slices */
+#define MAX_PRIO          256
+#define MAX_IRQ            32
+
+typedef struct {
+  char task[MAX_PRIO][TRC_NAME_SIZE + 1];
+  char event[256][TRC_NAME_SIZE + 1];
+  char timer[256][TRC_NAME_SIZE + 1];
+} names_t;
+
+static unsigned get16(const unsigned char* p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+static unsigned long get32(const unsigned char* p)
+{
+  return get16(p) | ((unsigned long) get16(p + 2) << 16);
+}
+
+/*
+ * Reads the whole capture and removes the escaping of trc_dump(). The
+ * printf output of the target contains no escape bytes.
+ */
+static unsigned char* read_all(FILE* in, size_t* size)
+{
+  unsigned char* buf = NULL;
+  size_t len = 0, cap = 0, n, i;
+
+  do {
+    if (len == cap) {
+      cap = cap ? cap * 2 : 65536;
+      if ((buf = realloc(buf, cap)) == NULL)
+        return NULL;
+    }
+    n = fread(buf + len, 1, cap - len, in);
+    len += n;
+  } while (n > 0);
+  for (i = n = 0; i < len; i++, n++)
+    buf[n] = (buf[i] == TRC_ESC && i + 1 < len) ? buf[++i] ^ TRC_ESC_XOR : buf[i];
+  *size = n;
+  return buf;
+}
+
+/*
+ * Returns the length of the block at 'p' if it is complete, else 0
+ */
+static size_t block_size(const unsigned char* p, size_t avail)
+{
+  size_t size;
+
+  if (avail < TRC_HEADER_SIZE || memcmp(p, "TRC1", 4) != 0)
+    return 0;
+  size = TRC_HEADER_SIZE + p[16] * (2 + TRC_NAME_SIZE)
+    + get32(p + 8) * TRC_RECORD_SIZE + 4;
+  if (size > avail || memcmp(p + size - 4, "TRCE", 4) != 0)
+    return 0;
+  return size;
+}
+
+static void read_names(const unsigned char* p, int count, names_t* names)
+{
+  char* name;
+  int i;
+
+  memset(names, 0, sizeof(*names));
+  for (i = 0; i < count; i++, p += 2 + TRC_NAME_SIZE) {
+    switch (p[0]) {
+    case 'T': name = names->task[p[1]];  break;
+    case 'E': name = names->event[p[1]]; break;
+    case 'M': name = names->timer[p[1]]; break;
+    default:  continue;
+    }
+    memcpy(name, p + 2, TRC_NAME_SIZE);
+  }
+}
+
+/*
+ * JSON string without quotes or control characters
+ */
+static const char* clean(const char* s, char* out)
+{
+  char* o = out;
+
+  for (; *s; s++)
+    *o++ = (*s == '"' || *s == '\\' || (unsigned char) *s < ' ') ? '_' : *s;
+  *o = '\0';
+  return out;
+}
+
+static const char* task_name(const names_t* names, unsigned prio, char* out)
+{
+  char tmp[TRC_NAME_SIZE + 1];
+
+  if (names->task[prio][0] == '\0' || strcmp(names->task[prio], "?") == 0)
+    sprintf(out, "Prio %u", prio);
+  else
+    sprintf(out, "Prio %u %s", prio, clean(names->task[prio], tmp));
+  return out;
+}
+
+static const char* object_name(const char table[][TRC_NAME_SIZE + 1], unsigned ix,
+                               char* out)
+{
+  if (ix < 256 && table[ix][0] != '\0')
+    return clean(table[ix], out);
+  sprintf(out, "#%u", ix);
+  return out;
+}
+
+static int first_event = 1;
+
+static void event_begin(void)
+{
+  printf(first_event ? "\n  " : ",\n  ");
+  first_event = 0;
+}
+
+static void slice(const char* name, unsigned tid, double ts, double dur)
+{
+  event_begin();
+  printf("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+         name, tid, ts, dur);
+}
+
+static void edge(const char* name, char ph, double ts)
+{
+  event_begin();
+  printf("{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+         name, ph, TID_INTERRUPTS, ts);
+}
+
+static void instant(const char* name, unsigned tid, double ts)
+{
+  event_begin();
+  printf("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+         name, tid, ts);
+}
+
+static void thread_meta(unsigned tid, const char* name)
+{
+  event_begin();
+  printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+         "\"args\":{\"name\":\"%s\"}}", tid, name);
+  event_begin();
+  printf("{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+         "\"args\":{\"sort_index\":%u}}", tid, tid);
+}
+
+static void convert(const unsigned char* p, const names_t* names)
+{
+  unsigned long freq = get32(p + 4);
+  unsigned long count = get32(p + 8);
+  const unsigned char* rec = p + TRC_HEADER_SIZE + p[16] * (2 + TRC_NAME_SIZE);
+  static unsigned char seen[MAX_PRIO];
+  unsigned irq_depth[MAX_IRQ] = { 0 };
+  unsigned int_depth = 0;
+  unsigned long i, ts, last_ts = 0;
+  unsigned long long cycles = 0;
+  double now, start = 0;
+  unsigned event, prio, arg, cur = 0;
+  char name[64], obj[TRC_NAME_SIZE + 1];
+
+  printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  event_begin();
+  printf("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+         "\"args\":{\"name\":\"Cruise Control\"}}");
+  thread_meta(TID_INTERRUPTS, "Interrupts");
+
+  for (i = 0; i < count; i++, rec += TRC_RECORD_SIZE) {
+    ts = get32(rec);
+    event = rec[4];
+    prio = rec[5];
+    arg = get16(rec + 6);
+
+    /* Unwrap the 32-bit timestamps, microseconds from the first record */
+    if (i > 0)
+      cycles += (ts - last_ts) & 0xFFFFFFFFul;
+    last_ts = ts;
+    now = cycles * 1e6 / freq;
+
+    if (i == 0)
+      cur = prio;
+    if (!seen[prio]) {
+      seen[prio] = 1;
+      thread_meta(prio, task_name(names, prio, name));
+    }
+
+    switch (event) {
+    case TRC_TASK_SW:
+      slice(task_name(names, cur, name), cur, start, now - start);
+      start = now;
+      cur = arg & (MAX_PRIO - 1);
+      if (!seen[cur]) {
+        seen[cur] = 1;
+        thread_meta(cur, task_name(names, cur, name));
+      }
+      break;
+    case TRC_INT_ENTER:
+      int_depth++;
+      edge("ISR", 'B', now);
+      break;
+    case TRC_INT_EXIT:
+      if (int_depth > 0) {          /* The ring may start inside an ISR */
+        int_depth--;
+        edge("ISR", 'E', now);
+      }
+      break;
+    case TRC_IRQ_ENTER:
+    case TRC_IRQ_EXIT:
+      if (arg >= MAX_IRQ)
+        break;
+      sprintf(name, "IRQ %u", arg);
+      if (event == TRC_IRQ_ENTER) {
+        irq_depth[arg]++;
+        edge(name, 'B', now);
+      } else if (irq_depth[arg] > 0) {
+        irq_depth[arg]--;
+        edge(name, 'E', now);
+      }
+      break;
+    case TRC_SEM_POST:
+    case TRC_SEM_PEND:
+    case TRC_MBOX_POST:
+    case TRC_MBOX_PEND:
+      sprintf(name, "%s %s",
+              event == TRC_SEM_POST ? "SemPost" : event == TRC_SEM_PEND ? "SemPend" :
+              event == TRC_MBOX_POST ? "MboxPost" : "MboxPend",
+              object_name(names->event, arg, obj));
+      instant(name, prio, now);
+      break;
+    case TRC_TMR_EXPIRE:
+      sprintf(name, "TmrExpire %s", object_name(names->timer, arg, obj));
+      instant(name, prio, now);
+      break;
+    default:
+      sprintf(name, "Event %u (%u)", event, arg);
+      instant(name, prio, now);
+      break;
+    }
+  }
+  if (count > 0)
+    slice(task_name(names, cur, name), cur, start, now - start);
+  printf("\n]}\n");
+
+  fprintf(stderr, "%lu records, %lu lost before, %.3f ms\n", count, get32(p + 12),
+          count > 0 ? now / 1000 : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+  static names_t names;
+  FILE* in = stdin;
+  unsigned char* buf;
+  const unsigned char* block = NULL;
+  size_t size, pos, len;
+  int want = 0, found = 0;
+  int i;
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      want = atoi(argv[++i]);
+    else if ((in = fopen(argv[i], "rb")) == NULL) {
+      perror(argv[i]);
+      return 1;
+    }
+  }
+
+  if ((buf = read_all(in, &size)) == NULL) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  for (pos = 0; pos + 4 <= size; pos++) {
+    if ((len = block_size(buf + pos, size - pos)) == 0)
+      continue;
+    found++;
+    if (want == 0 || found == want)
+      block = buf + pos;
+    pos += len - 1;
+  }
+  if (block == NULL) {
+    fprintf(stderr, "%s\n", found ? "no such block" : "no complete trace block");
+    return 1;
+  }
+
+  fprintf(stderr, "%d block(s), converting block %d\n", found, want ? want : found);
+  read_names(block + TRC_HEADER_SIZE, block[16], &names);
+  convert(block, &names);
+  free(buf);
+  return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * Host-side generator of the track table of the Cruise Control.
+ *
+ * Reads a route profile with one segment per line:
+ *
+ *   length grade wind    # comment
+ *
+ * length in 0.1 m, grade retardation in 0.1 m/s^2 (positive uphill) and
+ * headwind in 0.1 m/s (negative for tailwind), and writes the C source of
+ * the segment table, the track length and the position LED zones. The
+ * target stores the position as Q24.8 and wraps it with signed arithmetic,
+ * so the track must be shorter than 2^23 units (838 km).
+ *
+ * Build: gcc -O2 -o track_gen track_gen.c
+ * Usage: track_gen tracks/lab.trk > ../Cruise_Control/track_data.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACK_ZONES         6
+#define TRACK_MAX_LENGTH    (1UL << 23)
+#define TRACK_MAX_SEGMENTS  4096
+
+typedef struct {
+  unsigned long end;
+  int grade;
+  int wind;
+} segment_t;
+
+static segment_t segments[TRACK_MAX_SEGMENTS];
+
+int main(int argc, char** argv)
+{
+  FILE* in = stdin;
+  char line[256];
+  char* hash;
+  unsigned long length, end = 0;
+  int grade, wind, fields;
+  int count = 0, lineno = 0, i;
+
+  if (argc > 2) {
+    fprintf(stderr, "usage: %s [profile]\n", argv[0]);
+    return 2;
+  }
+  if (argc == 2 && (in = fopen(argv[1], "r")) == NULL) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  while (fgets(line, sizeof(line), in) != NULL) {
+    lineno++;
+    if ((hash = strchr(line, '#')) != NULL)
+      *hash = '\0';
+    fields = sscanf(line, "%lu %d %d", &length, &grade, &wind);
+    if (fields <= 0)
+      continue;
+    if (fields != 3 || length == 0) {
+      fprintf(stderr, "line %d: expected 'length grade wind'\n", lineno);
+      return 1;
+    }
+    if (grade < -128 || grade > 127 || wind < -128 || wind > 127) {
+      fprintf(stderr, "line %d: grade and wind must fit in 8 bits\n", lineno);
+      return 1;
+    }
+    if (count == TRACK_MAX_SEGMENTS) {
+      fprintf(stderr, "line %d: more than %d segments\n", lineno, TRACK_MAX_SEGMENTS);
+      return 1;
+    }
+    end += length;
+    if (end >= TRACK_MAX_LENGTH) {
+      fprintf(stderr, "line %d: track longer than %lu\n", lineno, TRACK_MAX_LENGTH - 1);
+      return 1;
+    }
+    segments[count].end = end;
+    segments[count].grade = grade;
+    segments[count].wind = wind;
+    count++;
+  }
+  if (count == 0) {
+    fprintf(stderr, "no segments\n");
+    return 1;
+  }
+
+  printf("/*\n * Generated by software/host_tools/track_gen.c from %s,\n"
+         " * do not edit. See track.h.\n */\n\n", argc == 2 ? argv[1] : "stdin");
+  printf("#include \"track.h\"\n\n");
+  printf("const TRACK_SEGMENT track_segments[] = {\n");
+  for (i = 0; i < count; i++)
+    printf("  { %8lu, %4d, %4d },\n", segments[i].end, segments[i].grade,
+           segments[i].wind);
+  printf("};\n\n");
+  printf("const INT16U track_segment_count = %d;\n\n", count);
+  printf("const INT32U track_length = %lu;\n\n", end);
+  printf("const INT32U track_zone_end[TRACK_ZONES] = {\n ");
+  for (i = 1; i <= TRACK_ZONES; i++)
+    printf(" %lu%s", end * i / TRACK_ZONES, i < TRACK_ZONES ? "," : "\n");
+  printf("};\n");
+
+  return 0;
+}